@@ -0,0 +1,247 @@
+#include "Vbsg_axil_fifo_client.h"
+#include "verilated.h"
+#include <cstdio>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <deque>
+#include <functional>
+#include <verilated_fst_c.h>
+
+#include "bsg_sim_kernel.h"
+
+// Requests the model is built to keep in flight (outstanding_p), and the
+//   cycles the fifo side takes to answer each one
+#ifndef OUTSTANDING
+#define OUTSTANDING 4
+#endif
+#ifndef LATENCY
+#define LATENCY 8
+#endif
+
+#define TEST_SIZE 4096
+#define RESET_CYCLES 16
+#define TIMEOUT_CYCLES (TEST_SIZE * (LATENCY + 4) * 4)
+
+using namespace std;
+
+// Set your seed here:
+#define SEED 9877
+mt19937 random_generator(SEED);
+uniform_int_distribution<uint32_t> distribution;
+auto dice = bind(distribution, random_generator);
+
+// Read data is a function of the address, so that it can be checked
+//   whatever the order of reads and writes on the fifo side
+uint32_t read_data(uint32_t addr)
+{
+    return (addr * 0x9e3779b1U) ^ 0x5a5a5a5aU;
+}
+
+struct request {
+    bool is_write;
+    uint32_t addr;
+    uint32_t data;
+};
+
+class testbench {
+    private:
+        unique_ptr<VerilatedContext> contextp;
+        unique_ptr<Vbsg_axil_fifo_client> dut;
+        unique_ptr<VerilatedFstC> tfp;
+        unique_ptr<bsg_sim_kernel> kernel;
+        int clk;
+
+        // AXIL master side
+        deque<request> reads, writes;
+        deque<request> read_rsps, write_rsps;
+        // Fifo side: requests in flight, with the cycle they are answered at
+        struct pending {
+            request req;
+            uint64_t due;
+        };
+        deque<pending> in_flight;
+
+        void handshake()
+        {
+            if (dut->s_axil_arvalid_i && dut->s_axil_arready_o)
+                reads.pop_front();
+            if (dut->s_axil_awvalid_i && dut->s_axil_awready_o)
+                aw_done = true;
+            if (dut->s_axil_wvalid_i && dut->s_axil_wready_o)
+                w_done = true;
+            if (aw_done && w_done) {
+                writes.pop_front();
+                aw_done = w_done = false;
+            }
+
+            if (dut->s_axil_rvalid_o && dut->s_axil_rready_i) {
+                if (read_rsps.empty() || dut->s_axil_rdata_o != read_data(read_rsps.front().addr))
+                    errors++;
+                else
+                    read_rsps.pop_front();
+                responses++;
+            }
+            if (dut->s_axil_bvalid_o && dut->s_axil_bready_i) {
+                if (write_rsps.empty())
+                    errors++;
+                else
+                    write_rsps.pop_front();
+                responses++;
+            }
+
+            // Requests are accepted whenever they are offered
+            if (dut->v_o && dut->ready_and_i) {
+                request req;
+                req.is_write = dut->w_o;
+                req.addr = dut->addr_o;
+                req.data = dut->data_o;
+                if (req.is_write) {
+                    if (written.empty() || written.front().addr != req.addr
+                        || written.front().data != req.data || dut->wmask_o != 0xf)
+                        errors++;
+                    else
+                        written.pop_front();
+                }
+                in_flight.push_back({req, cycles + LATENCY});
+            }
+            if (dut->v_i && dut->ready_and_o)
+                in_flight.pop_front();
+            max_in_flight = max<size_t>(max_in_flight, in_flight.size());
+        }
+
+        bool aw_done = false;
+        bool w_done = false;
+        // Writes in the order they must reach the fifo side
+        deque<request> written;
+
+    public:
+        uint64_t cycles = 0;
+        uint64_t responses = 0;
+        uint64_t errors = 0;
+        size_t max_in_flight = 0;
+
+        testbench(int argc, char **argv):
+            contextp(new VerilatedContext), tfp(new VerilatedFstC)
+        {
+            contextp->commandArgs(argc, argv);
+            contextp->traceEverOn(VM_TRACE_FST);
+            dut.reset(new Vbsg_axil_fifo_client{contextp.get()});
+            dut->trace(tfp.get(), 10);
+            tfp->open("dump.fst");
+            kernel.reset(new bsg_sim_kernel(contextp.get(), dut.get()));
+            kernel->trace([this](uint64_t t) { tfp->dump(t); });
+            clk = kernel->add_clock(dut->clk_i, 2, 1);
+            kernel->pre_edge(clk, [this]() { handshake(); });
+            dut->reset_i = 1;
+            dut->ready_and_i = 1;
+            dut->data_i = 0;
+            dut->v_i = 0;
+            dut->s_axil_awaddr_i = 0;
+            dut->s_axil_awprot_i = 0;
+            dut->s_axil_awvalid_i = 0;
+            dut->s_axil_wdata_i = 0;
+            dut->s_axil_wstrb_i = 0;
+            dut->s_axil_wvalid_i = 0;
+            dut->s_axil_bready_i = 0;
+            dut->s_axil_araddr_i = 0;
+            dut->s_axil_arprot_i = 0;
+            dut->s_axil_arvalid_i = 0;
+            dut->s_axil_rready_i = 0;
+            kernel->settle();
+        }
+
+        ~testbench()
+        {
+            dut->final();
+            tfp->close();
+        }
+
+        bool idle() const
+        {
+            return reads.empty() && writes.empty() && read_rsps.empty() && write_rsps.empty();
+        }
+
+        void send(const request &req)
+        {
+            if (req.is_write) {
+                writes.push_back(req);
+                write_rsps.push_back(req);
+                written.push_back(req);
+            } else {
+                reads.push_back(req);
+                read_rsps.push_back(req);
+            }
+        }
+
+        // Drives both sides and runs one clock cycle; the handshakes are
+        //   sampled right before the rising edge
+        void cycle()
+        {
+            dut->s_axil_arvalid_i = !reads.empty();
+            if (!reads.empty())
+                dut->s_axil_araddr_i = reads.front().addr;
+            dut->s_axil_awvalid_i = !writes.empty() && !aw_done;
+            dut->s_axil_wvalid_i = !writes.empty() && !w_done;
+            if (!writes.empty()) {
+                dut->s_axil_awaddr_i = writes.front().addr;
+                dut->s_axil_wdata_i = writes.front().data;
+                dut->s_axil_wstrb_i = 0xf;
+            }
+            dut->s_axil_rready_i = (dice() % 4) != 0;
+            dut->s_axil_bready_i = (dice() % 4) != 0;
+
+            // Responses return in request order, each LATENCY cycles after its request
+            dut->v_i = !in_flight.empty() && in_flight.front().due <= cycles;
+            if (dut->v_i)
+                dut->data_i = in_flight.front().req.is_write ? 0 : read_data(in_flight.front().req.addr);
+
+            kernel->touch();
+            kernel->run(1, clk);
+            cycles++;
+        }
+
+        void reset()
+        {
+            dut->reset_i = 1;
+            for (int i = 0; i < RESET_CYCLES; i++)
+                cycle();
+            dut->reset_i = 0;
+            cycles = 0;
+        }
+};
+
+int main(int argc, char **argv, char **env)
+{
+    testbench tb(argc, argv);
+
+    tb.reset();
+    uint64_t reads = 0;
+    for (uint32_t i = 0; i < TEST_SIZE; i++) {
+        request req;
+        req.is_write = (dice() % 4) == 0;
+        req.addr = (dice() & ~3U);
+        req.data = dice();
+        reads += !req.is_write;
+        tb.send(req);
+    }
+    while (!tb.idle() && tb.cycles < TIMEOUT_CYCLES)
+        tb.cycle();
+    bool timeout = !tb.idle();
+
+    printf("%lu requests (%lu reads) in %lu cycles, %lu cycles each to return\n",
+        (unsigned long) TEST_SIZE, (unsigned long) reads, (unsigned long) tb.cycles,
+        (unsigned long) LATENCY);
+    printf("Requests in flight: at most %lu of %d\n", (unsigned long) tb.max_in_flight, OUTSTANDING);
+
+    // The client must overlap requests, but never exceed its window
+    bool ok = !timeout && !tb.errors && tb.responses == TEST_SIZE
+        && tb.max_in_flight <= OUTSTANDING && (tb.max_in_flight > 1 || OUTSTANDING == 1);
+    if (ok) {
+        printf("Check succeeded\n");
+        return 0;
+    }
+    printf("Check failed%s%s\n", timeout ? " TIMEOUT" : "", tb.errors ? " DATA ERROR" : "");
+    return 1;
+}
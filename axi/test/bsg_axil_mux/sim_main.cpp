@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <iostream>
 #include <verilated_fst_c.h>
+#include "bsg_sim_kernel.h"
 #include <random>
 #include <queue>
 #include <functional>
@@ -20,30 +21,6 @@ uniform_int_distribution<uint32_t> distribution;
 auto dice = bind(distribution, random_generator);
 
 
-// After calling timer_tick, the sim time will stop right before the next rising clk edge.
-// This way users can peek the final results of a cycle (like the SystemVerilog
-// Postponed Region).
-void timer_tick(Vbsg_axil_mux *dut, VerilatedContext *contextp, VerilatedFstC *tfp)
-{
-    dut->eval();
-    tfp->dump(contextp->time());
-    contextp->timeInc(1);
-    dut->clk_i = 0;
-    dut->eval();
-    tfp->dump(contextp->time());
-
-    contextp->timeInc(1);
-}
-// After users finish reading the final results of a cycle, they call timer_eval to move to
-// the next time slot.
-// After calling time_eval, the signals in DUT will be computed. Users can then specify the
-// new input signals to the DUT. This resembles the SystemVerilog Reactive Region.
-void timer_eval(Vbsg_axil_mux *dut)
-{
-    dut->clk_i = 1;
-    dut->eval();
-}
-
 class axil_master {
     private:
         int master_id;
@@ -628,33 +605,30 @@ int main(int argc, char **argv, char **env)
         0
         ));
 
-    contextp->time(0);
-    dut->clk_i = 1;
-    dut->eval();
+    bsg_sim_kernel kernel(contextp.get(), dut.get());
+    kernel.trace([&](uint64_t t) { tfp->dump(t); });
+    int clk = kernel.add_clock(dut->clk_i, 2, 2);
 
     dut->reset_i = 1;
-    timer_tick(dut.get(), contextp.get(), tfp.get());
-    timer_eval(dut.get());
-    // Specify the inputs to DUT during [timer_eval, timer_tick]
-
+    kernel.run(1, clk);
     dut->reset_i = 0;
-    while(!(m00->done && m01->done)) {
-        if(m00->sim(false))
-            break;
-        if(m01->sim(false))
-            break;
-        if(s00->sim(false))
-            break;
-        timer_tick(dut.get(), contextp.get(), tfp.get());
-        // Read end outputs from DUT during [timer_tick, timer_eval]
-        if(m00->sim(true))
-            break;
-        if(m01->sim(true))
-            break;
-        if(s00->sim(true))
-            break;
-        timer_eval(dut.get());
-    }
+    kernel.touch();
+
+    // Outputs are read back just before each rising edge, and the inputs
+    // for the next cycle are driven just after it
+    kernel.pre_edge(clk, [&]() {
+        if(m00->sim(true) ||
+            m01->sim(true) ||
+            s00->sim(true))
+            kernel.stop();
+    });
+    kernel.post_edge(clk, [&]() {
+        if(m00->sim(false) ||
+            m01->sim(false) ||
+            s00->sim(false))
+            kernel.stop();
+    });
+    kernel.run_until([&]() { return m00->done && m01->done; });
 
     printf("Total simulation time: %lu\n", contextp->time());
     tfp->close();
@@ -5,6 +5,8 @@ module bsg_axil_fifo_client
  import bsg_axi_pkg::*;
  #(parameter `BSG_INV_PARAM(axil_data_width_p)
    , parameter `BSG_INV_PARAM(axil_addr_width_p)
+   // Maximum requests issued on the fifo interface before their responses return
+   , parameter outstanding_p = 1
 
    , localparam axil_mask_width_lp = axil_data_width_p >> 3
    )
@@ -110,21 +112,42 @@ module bsg_axil_fifo_client
      ,.yumi_i(wdata_yumi_lo)
      );
 
+  // Tracks whether each request in flight is a read or a write
   logic return_v_li, return_ready_lo, return_w_lo, return_v_lo, return_yumi_li;
-  bsg_one_fifo
-   #(.width_p(1))
-   return_fifo
-    (.clk_i(clk_i)
-     ,.reset_i(reset_i)
-
-     ,.data_i(w_o)
-     ,.v_i(return_v_li)
-     ,.ready_and_o(return_ready_lo)
-
-     ,.data_o(return_w_lo)
-     ,.v_o(return_v_lo)
-     ,.yumi_i(return_yumi_li)
-     );
+  if (outstanding_p == 1)
+    begin : one
+      bsg_one_fifo
+       #(.width_p(1))
+       return_fifo
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
+
+         ,.data_i(w_o)
+         ,.v_i(return_v_li)
+         ,.ready_and_o(return_ready_lo)
+
+         ,.data_o(return_w_lo)
+         ,.v_o(return_v_lo)
+         ,.yumi_i(return_yumi_li)
+         );
+    end
+  else
+    begin : many
+      bsg_fifo_1r1w_small
+       #(.width_p(1), .els_p(outstanding_p))
+       return_fifo
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
+
+         ,.data_i(w_o)
+         ,.v_i(return_v_li)
+         ,.ready_param_o(return_ready_lo)
+
+         ,.data_o(return_w_lo)
+         ,.v_o(return_v_lo)
+         ,.yumi_i(return_yumi_li)
+         );
+    end
 
   // Align read addresses to bus width (per axil spec)
   // TODO: Replace with https://github.com/bespoke-silicon-group/basejump_stl/pull/565/files
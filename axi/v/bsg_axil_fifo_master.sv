@@ -5,6 +5,8 @@ module bsg_axil_fifo_master
  import bsg_axi_pkg::*;
  #(parameter `BSG_INV_PARAM(axil_data_width_p)
    , parameter `BSG_INV_PARAM(axil_addr_width_p)
+   // Maximum requests issued on the AXI-Lite interface before their responses return
+   , parameter outstanding_p = 1
 
    , localparam axi_mask_width_lp = axil_data_width_p >> 3
    )
@@ -56,54 +58,106 @@ module bsg_axil_fifo_master
   wire unused = &{m_axil_rresp_i, m_axil_bresp_i};
 
   logic wdata_ready_lo;
-  bsg_one_fifo
-   #(.width_p(axil_data_width_p+axi_mask_width_lp))
-   wdata_fifo
-    (.clk_i(clk_i)
-     ,.reset_i(reset_i)
-
-     ,.data_i({data_i, wmask_i})
-     ,.v_i(ready_and_o & v_i & w_i)
-     ,.ready_and_o(wdata_ready_lo)
-
-     ,.data_o({m_axil_wdata_o, m_axil_wstrb_o})
-     ,.v_o(m_axil_wvalid_o)
-     ,.yumi_i(m_axil_wready_i & m_axil_wvalid_o)
-     );
-
   logic addr_ready_lo;
   logic w_lo, addr_v_lo, addr_yumi_li;
   logic [axil_addr_width_p-1:0] addr_lo;
-  bsg_one_fifo
-   #(.width_p(1+axil_addr_width_p))
-   addr_fifo
-    (.clk_i(clk_i)
-     ,.reset_i(reset_i)
-
-     ,.data_i({w_i, addr_i})
-     ,.v_i(ready_and_o & v_i)
-     ,.ready_and_o(addr_ready_lo)
-
-     ,.data_o({w_lo, addr_lo})
-     ,.v_o(addr_v_lo)
-     ,.yumi_i(addr_yumi_li)
-     );
-
+  // Tracks whether each request in flight is a read or a write
   logic return_ready_lo, return_w_lo, return_v_lo, return_yumi_li;
-  bsg_one_fifo
-   #(.width_p(1))
-   return_fifo
-    (.clk_i(clk_i)
-     ,.reset_i(reset_i)
-
-     ,.data_i(w_i)
-     ,.v_i(ready_and_o & v_i)
-     ,.ready_and_o(return_ready_lo)
-
-     ,.data_o(return_w_lo)
-     ,.v_o(return_v_lo)
-     ,.yumi_i(return_yumi_li)
-     );
+  if (outstanding_p == 1)
+    begin : one
+      bsg_one_fifo
+       #(.width_p(axil_data_width_p+axi_mask_width_lp))
+       wdata_fifo
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
+
+         ,.data_i({data_i, wmask_i})
+         ,.v_i(ready_and_o & v_i & w_i)
+         ,.ready_and_o(wdata_ready_lo)
+
+         ,.data_o({m_axil_wdata_o, m_axil_wstrb_o})
+         ,.v_o(m_axil_wvalid_o)
+         ,.yumi_i(m_axil_wready_i & m_axil_wvalid_o)
+         );
+
+      bsg_one_fifo
+       #(.width_p(1+axil_addr_width_p))
+       addr_fifo
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
+
+         ,.data_i({w_i, addr_i})
+         ,.v_i(ready_and_o & v_i)
+         ,.ready_and_o(addr_ready_lo)
+
+         ,.data_o({w_lo, addr_lo})
+         ,.v_o(addr_v_lo)
+         ,.yumi_i(addr_yumi_li)
+         );
+
+      bsg_one_fifo
+       #(.width_p(1))
+       return_fifo
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
+
+         ,.data_i(w_i)
+         ,.v_i(ready_and_o & v_i)
+         ,.ready_and_o(return_ready_lo)
+
+         ,.data_o(return_w_lo)
+         ,.v_o(return_v_lo)
+         ,.yumi_i(return_yumi_li)
+         );
+    end
+  else
+    begin : many
+      // Two-element fifos accept a request every cycle
+      bsg_two_fifo
+       #(.width_p(axil_data_width_p+axi_mask_width_lp))
+       wdata_fifo
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
+
+         ,.data_i({data_i, wmask_i})
+         ,.v_i(ready_and_o & v_i & w_i)
+         ,.ready_param_o(wdata_ready_lo)
+
+         ,.data_o({m_axil_wdata_o, m_axil_wstrb_o})
+         ,.v_o(m_axil_wvalid_o)
+         ,.yumi_i(m_axil_wready_i & m_axil_wvalid_o)
+         );
+
+      bsg_two_fifo
+       #(.width_p(1+axil_addr_width_p))
+       addr_fifo
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
+
+         ,.data_i({w_i, addr_i})
+         ,.v_i(ready_and_o & v_i)
+         ,.ready_param_o(addr_ready_lo)
+
+         ,.data_o({w_lo, addr_lo})
+         ,.v_o(addr_v_lo)
+         ,.yumi_i(addr_yumi_li)
+         );
+
+      bsg_fifo_1r1w_small
+       #(.width_p(1), .els_p(outstanding_p))
+       return_fifo
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
+
+         ,.data_i(w_i)
+         ,.v_i(ready_and_o & v_i)
+         ,.ready_param_o(return_ready_lo)
+
+         ,.data_o(return_w_lo)
+         ,.v_o(return_v_lo)
+         ,.yumi_i(return_yumi_li)
+         );
+    end
   assign ready_and_o = addr_ready_lo & wdata_ready_lo & return_ready_lo;
 
   assign m_axil_arvalid_o = addr_v_lo & ~w_lo;
@@ -0,0 +1,264 @@
+
+#ifndef BP_BEDROCK_RING_H
+#define BP_BEDROCK_RING_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+
+#include "bp_bedrock_packet.h"
+
+  // Shared-memory packet ring for bp_endpoint_to_fifos traffic
+  //
+  // This is a protocol model only. There is no RTL ring engine yet:
+  //   bp_bedrock_ring_device below is the C++ reference for one, and the
+  //   bp_bedrock_ring test runs it against a stand-in for the endpoint fifos.
+  //
+  // A ring is a single-producer/single-consumer queue of bp_bedrock_packet
+  //   living in memory visible to both sides (e.g. a udmabuf region on the
+  //   PS, or a mmap'd region in simulation). Indices are free-running 32b
+  //   counters; the slot of an index is (idx & (els-1)).
+  //
+  // Layout (offsets from the ring base):
+  //   0x00: producer index (written only by the producer)
+  //   0x40: consumer index (written only by the consumer)
+  //   0x80: els x bp_bedrock_packet
+  //
+  // The indices sit on separate cache lines so that the two sides never
+  //   write the same line. Packets are made visible with a release store of
+  //   the producer index and reclaimed with a release store of the consumer
+  //   index, so many packets can be handed over per doorbell.
+  #define BEDROCK_RING_PROD_OFFSET 0x00
+  #define BEDROCK_RING_CONS_OFFSET 0x40
+  #define BEDROCK_RING_DATA_OFFSET 0x80
+
+  // Words per packet on the 32b fifo interface of bp_endpoint_to_fifos
+  #define BEDROCK_FIFO_WORDS (sizeof(bp_bedrock_packet) / sizeof(uint32_t))
+
+  static_assert(sizeof(bp_bedrock_packet) == 28, "bp_bedrock_packet must be 224b");
+
+  class bp_bedrock_ring {
+    public:
+      bp_bedrock_ring(void *base, uint32_t els)
+        : base(static_cast<uint8_t *>(base)), els(els), mask(els-1) {
+        prod = reinterpret_cast<uint32_t *>(this->base + BEDROCK_RING_PROD_OFFSET);
+        cons = reinterpret_cast<uint32_t *>(this->base + BEDROCK_RING_CONS_OFFSET);
+        slots = reinterpret_cast<bp_bedrock_packet *>(this->base + BEDROCK_RING_DATA_OFFSET);
+      }
+
+      // Bytes of shared memory needed for a ring of els packets
+      static size_t footprint(uint32_t els) {
+        return BEDROCK_RING_DATA_OFFSET + els * sizeof(bp_bedrock_packet);
+      }
+
+      static bool valid_els(uint32_t els) {
+        return (els != 0) && ((els & (els-1)) == 0);
+      }
+
+      // Only one side should call this, before the other side starts
+      void reset() {
+        __atomic_store_n(prod, 0, __ATOMIC_RELEASE);
+        __atomic_store_n(cons, 0, __ATOMIC_RELEASE);
+      }
+
+      uint32_t size() const { return els; }
+      uint32_t head() const { return __atomic_load_n(prod, __ATOMIC_ACQUIRE); }
+      uint32_t tail() const { return __atomic_load_n(cons, __ATOMIC_ACQUIRE); }
+
+      //
+      // Producer side
+      //
+      uint32_t space() const {
+        return els - (*prod - tail());
+      }
+
+      // Zero-copy reservation: returns up to n contiguous slots (may be fewer
+      //   at the wrap point) which must be filled and then commit()-ed
+      bp_bedrock_packet *reserve(uint32_t &n) {
+        uint32_t p = *prod;
+        uint32_t contig = els - (p & mask);
+        uint32_t room = space();
+        if (n > room) n = room;
+        if (n > contig) n = contig;
+        return &slots[p & mask];
+      }
+
+      void commit(uint32_t n) {
+        __atomic_store_n(prod, *prod + n, __ATOMIC_RELEASE);
+      }
+
+      // Copying enqueue; returns the number of packets accepted
+      uint32_t produce(const bp_bedrock_packet *pkts, uint32_t n) {
+        uint32_t done = 0;
+        while (done < n) {
+          uint32_t chunk = n - done;
+          bp_bedrock_packet *dst = reserve(chunk);
+          if (chunk == 0) break;
+          std::memcpy(dst, &pkts[done], chunk * sizeof(bp_bedrock_packet));
+          commit(chunk);
+          done += chunk;
+        }
+        return done;
+      }
+
+      //
+      // Consumer side
+      //
+      uint32_t avail() const {
+        return head() - *cons;
+      }
+
+      // Zero-copy view of up to n contiguous valid slots, freed with release()
+      const bp_bedrock_packet *peek(uint32_t &n) const {
+        uint32_t c = *cons;
+        uint32_t contig = els - (c & mask);
+        uint32_t ready = avail();
+        if (n > ready) n = ready;
+        if (n > contig) n = contig;
+        return &slots[c & mask];
+      }
+
+      void release(uint32_t n) {
+        __atomic_store_n(cons, *cons + n, __ATOMIC_RELEASE);
+      }
+
+      // Copying dequeue; returns the number of packets removed
+      uint32_t consume(bp_bedrock_packet *pkts, uint32_t n) {
+        uint32_t done = 0;
+        while (done < n) {
+          uint32_t chunk = n - done;
+          const bp_bedrock_packet *src = peek(chunk);
+          if (chunk == 0) break;
+          std::memcpy(&pkts[done], src, chunk * sizeof(bp_bedrock_packet));
+          release(chunk);
+          done += chunk;
+        }
+        return done;
+      }
+
+    private:
+      uint8_t *base;
+      uint32_t els;
+      uint32_t mask;
+      uint32_t *prod;
+      uint32_t *cons;
+      bp_bedrock_packet *slots;
+  };
+
+  // Host end of a request/response ring pair
+  //
+  // Requests flow host -> device through req, responses device -> host
+  //   through rsp. Writes are auto-acked by bp_endpoint_to_fifos, so only
+  //   reads and AMOs produce an entry in rsp. The doorbell is a single MMIO
+  //   write of the new request producer index, issued once per batch.
+  class bp_bedrock_ring_host {
+    public:
+      typedef std::function<void(uint32_t)> doorbell_fn;
+
+      bp_bedrock_ring_host(bp_bedrock_ring *req, bp_bedrock_ring *rsp, doorbell_fn doorbell)
+        : req(req), rsp(rsp), doorbell(doorbell) { }
+
+      // Enqueues as many packets as fit and rings the doorbell once
+      uint32_t send(const bp_bedrock_packet *pkts, uint32_t n) {
+        uint32_t sent = req->produce(pkts, n);
+        if (sent != 0) {
+          doorbell(req->head());
+          doorbells++;
+        }
+        return sent;
+      }
+
+      // Free request slots, so software can size its next batch
+      uint32_t space() const {
+        return req->space();
+      }
+
+      // Drains up to n responses without touching MMIO
+      uint32_t poll(bp_bedrock_packet *pkts, uint32_t n) {
+        return rsp->consume(pkts, n);
+      }
+
+      static bool expects_response(const bp_bedrock_packet &pkt) {
+        return (pkt.msg_type == BEDROCK_MEM_RD) || (pkt.msg_type == BEDROCK_MEM_AMO);
+      }
+
+      uint64_t doorbells = 0;
+
+    private:
+      bp_bedrock_ring *req;
+      bp_bedrock_ring *rsp;
+      doorbell_fn doorbell;
+  };
+
+  // Device end of a request/response ring pair
+  //
+  // Reference model for a ring engine, which has no RTL yet, sitting in
+  //   front of the fifo ports of bp_endpoint_to_fifos: it serializes queued
+  //   requests into 32b words, respects the credit limit of the endpoint and
+  //   reassembles response words back into packets. Called once per cycle by
+  //   the owner.
+  class bp_bedrock_ring_device {
+    public:
+      bp_bedrock_ring_device(bp_bedrock_ring *req, bp_bedrock_ring *rsp, uint32_t num_credits)
+        : req(req), rsp(rsp), num_credits(num_credits) { }
+
+      // Host doorbell: records the newest request index
+      void ring(uint32_t prod) { doorbell_idx = prod; }
+
+      // Next word towards the endpoint; false when nothing can be sent
+      bool fwd_word(uint32_t &word) {
+        if (fwd_idx == 0) {
+          if (req->tail() == doorbell_idx) return false;
+          if (credits_used == num_credits) return false;
+          uint32_t n = 1;
+          std::memcpy(&fwd_pkt, req->peek(n), sizeof(fwd_pkt));
+        }
+        std::memcpy(&word, reinterpret_cast<uint8_t *>(&fwd_pkt) + fwd_idx*4, 4);
+        return true;
+      }
+
+      // The word returned by fwd_word was accepted
+      void fwd_yumi() {
+        if (++fwd_idx == BEDROCK_FIFO_WORDS) {
+          fwd_idx = 0;
+          req->release(1);
+          if (bp_bedrock_ring_host::expects_response(fwd_pkt))
+            credits_used++;
+        }
+      }
+
+      // Whether a response word can be accepted this cycle
+      bool rev_ready() const {
+        return (rev_idx != 0) || (rsp->space() != 0);
+      }
+
+      void rev_word(uint32_t word) {
+        std::memcpy(reinterpret_cast<uint8_t *>(&rev_pkt) + rev_idx*4, &word, 4);
+        if (++rev_idx == BEDROCK_FIFO_WORDS) {
+          rev_idx = 0;
+          rsp->produce(&rev_pkt, 1);
+          credits_used--;
+        }
+      }
+
+      bool idle() const {
+        return (fwd_idx == 0) && (rev_idx == 0) && (credits_used == 0)
+          && (req->tail() == doorbell_idx);
+      }
+
+    private:
+      bp_bedrock_ring *req;
+      bp_bedrock_ring *rsp;
+      uint32_t num_credits;
+      uint32_t credits_used = 0;
+      uint32_t doorbell_idx = 0;
+
+      bp_bedrock_packet fwd_pkt;
+      uint32_t fwd_idx = 0;
+      bp_bedrock_packet rev_pkt;
+      uint32_t rev_idx = 0;
+  };
+
+#endif
+
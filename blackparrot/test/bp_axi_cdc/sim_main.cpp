@@ -0,0 +1,192 @@
+#include "Vbp_axi_cdc_standin.h"
+#include "verilated.h"
+#include <cstdio>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <type_traits>
+
+#include "bsg_sim_kernel.h"
+
+// Depth the model is built with (lg_async_fifo_size_p)
+#ifndef LG_ASYNC_FIFO_SIZE
+#define LG_ASYNC_FIFO_SIZE 3
+#endif
+
+// Beats streamed through each crossing per clock ratio
+#define BEATS 4096
+#define AXI_HALF_PS 4000 // 125 MHz
+#define RESET_CYCLES 16
+// In cycles of the slower clock
+#define TIMEOUT_CYCLES (BEATS * 16)
+
+using namespace std;
+
+// Core clock frequency over AXI clock frequency
+const double ratios[] = {0.25, 0.5, 0.75, 1.0, 1.25, 1.5, 2.0, 3.0, 4.0};
+
+// Beats carry their index in the low 32 bits, whatever the crossing width
+//   the model was built with
+template <typename T>
+typename enable_if<is_integral<T>::value>::type put(T &sig, uint32_t x) { sig = x; }
+template <typename T>
+typename enable_if<!is_integral<T>::value>::type put(T &sig, uint32_t x) { sig[0] = x; }
+template <typename T>
+typename enable_if<is_integral<T>::value, uint32_t>::type get(const T &sig) { return sig; }
+template <typename T>
+typename enable_if<!is_integral<T>::value, uint32_t>::type get(const T &sig) { return sig[0]; }
+
+// One direction of one crossing, streamed at full rate: the writer enqueues
+//   whenever the fifo is not full and the reader dequeues whenever it is
+//   valid. Beats carry their index so ordering can be checked.
+struct channel {
+    const char *name;
+    bool write_core; // written in the core domain, read in the AXI domain
+    function<bool()> full;
+    function<void(bool, uint32_t)> enq;
+    function<bool()> valid;
+    function<uint32_t()> data;
+    function<void(bool)> deq;
+
+    uint64_t sent = 0, received = 0, errors = 0, done_ps = 0;
+
+    // Called right before a rising edge of the writer's clock
+    void write_edge()
+    {
+        bool v = !full() && sent < BEATS;
+        enq(v, sent);
+        sent += v;
+    }
+    // Called right before a rising edge of the reader's clock
+    void read_edge(uint64_t t)
+    {
+        bool v = valid();
+        if (v) {
+            if (data() != received)
+                errors++;
+            if (++received == BEATS)
+                done_ps = t;
+        }
+        deq(v);
+    }
+};
+
+#define CHANNELS 7
+
+struct result {
+    double core_mhz;
+    // Beats per cycle of the slower clock
+    double rate[CHANNELS];
+    uint64_t errors;
+    bool timeout;
+};
+
+// The crossings of bp_axi_top, by instance name
+#define CHANNEL(inst, port, w_core) \
+    {inst, w_core, \
+     [d]() { return d->port##_full_o; }, \
+     [d](bool v, uint32_t x) { d->port##_enq_i = v; put(d->port##_data_i, x); }, \
+     [d]() { return d->port##_v_o; }, \
+     [d]() { return get(d->port##_data_o); }, \
+     [d](bool v) { d->port##_deq_i = v; }}
+
+result run_ratio(double ratio, int argc, char **argv)
+{
+    const unique_ptr<VerilatedContext> contextp{new VerilatedContext};
+    contextp->commandArgs(argc, argv);
+    const unique_ptr<Vbp_axi_cdc_standin> dut{new Vbp_axi_cdc_standin{contextp.get()}};
+
+    const uint64_t core_half_ps = (uint64_t) (AXI_HALF_PS / ratio);
+    const uint64_t slow_half_ps = max(core_half_ps, (uint64_t) AXI_HALF_PS);
+
+    Vbp_axi_cdc_standin *d = dut.get();
+    vector<channel> ch = {
+        CHANNEL("mem_fwd_iaf", mem_fwd_in, false),
+        CHANNEL("mem_rev_oaf", mem_rev_out, true),
+        CHANNEL("mem_fwd_oaf", mem_fwd_out, true),
+        CHANNEL("mem_rev_iaf", mem_rev_in, false),
+        CHANNEL("dma_pkt_af", dma_pkt, true),
+        CHANNEL("dma_out_data_af", dma_out, true),
+        CHANNEL("dma_in_data_af", dma_in, false),
+    };
+
+    for (auto &c : ch) {
+        c.enq(false, 0);
+        c.deq(false);
+    }
+    d->core_reset_i = 1;
+    d->axi_reset_i = 1;
+    bsg_sim_kernel kernel(contextp.get(), d);
+    int core_clk = kernel.add_clock(d->core_clk_i, 2 * core_half_ps, core_half_ps);
+    int axi_clk = kernel.add_clock(d->axi_clk_i, 2 * AXI_HALF_PS, AXI_HALF_PS);
+    kernel.settle();
+
+    const uint64_t reset_ps = RESET_CYCLES * 2 * slow_half_ps;
+    const uint64_t timeout_ps = reset_ps + TIMEOUT_CYCLES * 2 * slow_half_ps;
+    auto done = [&ch]() {
+        for (auto &c : ch)
+            if (c.received < BEATS)
+                return false;
+        return true;
+    };
+
+    // Both sides stream right before the rising edges of their own clock
+    kernel.pre_edge(core_clk, [&]() {
+        bool streaming = kernel.time() > reset_ps;
+        d->core_reset_i = !streaming;
+        if (streaming)
+            for (auto &c : ch)
+                c.write_core ? c.write_edge() : c.read_edge(kernel.time() - reset_ps);
+    });
+    kernel.pre_edge(axi_clk, [&]() {
+        bool streaming = kernel.time() > reset_ps;
+        d->axi_reset_i = !streaming;
+        if (streaming)
+            for (auto &c : ch)
+                c.write_core ? c.read_edge(kernel.time() - reset_ps) : c.write_edge();
+    });
+    kernel.run_until(done, timeout_ps);
+    dut->final();
+
+    result r;
+    r.core_mhz = 1e6 / (2.0 * core_half_ps);
+    r.errors = 0;
+    r.timeout = !done();
+    for (size_t i = 0; i < ch.size(); i++) {
+        r.errors += ch[i].errors;
+        r.rate[i] = ch[i].done_ps ? (double) BEATS * 2 * slow_half_ps / ch[i].done_ps : 0;
+    }
+    return r;
+}
+
+int main(int argc, char **argv, char **env)
+{
+    const double axi_mhz = 1e6 / (2.0 * AXI_HALF_PS);
+    const char *names[CHANNELS] = {"fwd_iaf", "rev_oaf", "fwd_oaf", "rev_iaf", "pkt_af", "dma_out", "dma_in"};
+    bool ok = true;
+
+    printf("Clock crossing depth: %d entries, AXI clock %.0f MHz, %d beats per crossing\n",
+        1 << LG_ASYNC_FIFO_SIZE, axi_mhz, BEATS);
+    printf("Beats per cycle of the slower clock, in %%\n");
+    printf("%8s %9s |", "core:axi", "core MHz");
+    for (int i = 0; i < CHANNELS; i++)
+        printf(" %7s", names[i]);
+    printf("\n");
+    for (double ratio : ratios) {
+        result r = run_ratio(ratio, argc, argv);
+        printf("%8.2f %9.1f |", ratio, r.core_mhz);
+        for (int i = 0; i < CHANNELS; i++)
+            printf(" %7.1f", 100.0 * r.rate[i]);
+        printf("%s\n", r.timeout ? " TIMEOUT" : r.errors ? " ORDER ERROR" : "");
+        ok &= !r.timeout && !r.errors;
+    }
+
+    if (ok) {
+        printf("Check succeeded\n");
+        return 0;
+    }
+    printf("Check failed\n");
+    return 1;
+}
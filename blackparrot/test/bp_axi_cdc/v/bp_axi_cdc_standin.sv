@@ -0,0 +1,209 @@
+`include "bsg_defines.sv"
+
+// Stand-in for the clock crossings of bp_axi_top (axi_core_clk_async_p == 1).
+//   It has the same seven bsg_async_fifos, with the same instance names and
+//   clock directions, and brings their ports out so the testbench can stream
+//   through them at any pair of clock frequencies. The build checks the
+//   instance list against bp_axi_top, so keep the two in step. BP itself is not part of
+//   this repo, so the widths are parameters: set them to the $bits() of the
+//   bp_axi_top crossings for the configuration under test.
+//   - mem_fwd_width_p:  bp_bedrock_mem_fwd_header_s + bedrock_fill_width_p
+//   - mem_rev_width_p:  bp_bedrock_mem_rev_header_s + bedrock_fill_width_p
+//   - dma_pkt_width_p:  bsg_cache_dma_pkt_s
+//   - dma_data_width_p: l2_fill_width_p
+module bp_axi_cdc_standin
+ #(parameter lg_async_fifo_size_p = 3
+   , parameter `BSG_INV_PARAM(mem_fwd_width_p)
+   , parameter `BSG_INV_PARAM(mem_rev_width_p)
+   , parameter `BSG_INV_PARAM(dma_pkt_width_p)
+   , parameter `BSG_INV_PARAM(dma_data_width_p)
+   )
+  (input                                 core_clk_i
+   , input                               core_reset_i
+   , input                               axi_clk_i
+   , input                               axi_reset_i
+
+   // I/O requests from AXIL (axi -> core)
+   , input [mem_fwd_width_p-1:0]         mem_fwd_in_data_i
+   , input                               mem_fwd_in_enq_i
+   , output logic                        mem_fwd_in_full_o
+   , output logic [mem_fwd_width_p-1:0]  mem_fwd_in_data_o
+   , output logic                        mem_fwd_in_v_o
+   , input                               mem_fwd_in_deq_i
+
+   // I/O responses to AXIL (core -> axi)
+   , input [mem_rev_width_p-1:0]         mem_rev_out_data_i
+   , input                               mem_rev_out_enq_i
+   , output logic                        mem_rev_out_full_o
+   , output logic [mem_rev_width_p-1:0]  mem_rev_out_data_o
+   , output logic                        mem_rev_out_v_o
+   , input                               mem_rev_out_deq_i
+
+   // I/O requests to AXIL (core -> axi)
+   , input [mem_fwd_width_p-1:0]         mem_fwd_out_data_i
+   , input                               mem_fwd_out_enq_i
+   , output logic                        mem_fwd_out_full_o
+   , output logic [mem_fwd_width_p-1:0]  mem_fwd_out_data_o
+   , output logic                        mem_fwd_out_v_o
+   , input                               mem_fwd_out_deq_i
+
+   // I/O responses from AXIL (axi -> core)
+   , input [mem_rev_width_p-1:0]         mem_rev_in_data_i
+   , input                               mem_rev_in_enq_i
+   , output logic                        mem_rev_in_full_o
+   , output logic [mem_rev_width_p-1:0]  mem_rev_in_data_o
+   , output logic                        mem_rev_in_v_o
+   , input                               mem_rev_in_deq_i
+
+   // DMA packets to cache2axi (core -> axi)
+   , input [dma_pkt_width_p-1:0]         dma_pkt_data_i
+   , input                               dma_pkt_enq_i
+   , output logic                        dma_pkt_full_o
+   , output logic [dma_pkt_width_p-1:0]  dma_pkt_data_o
+   , output logic                        dma_pkt_v_o
+   , input                               dma_pkt_deq_i
+
+   // DMA write data to cache2axi (core -> axi)
+   , input [dma_data_width_p-1:0]        dma_out_data_i
+   , input                               dma_out_enq_i
+   , output logic                        dma_out_full_o
+   , output logic [dma_data_width_p-1:0] dma_out_data_o
+   , output logic                        dma_out_v_o
+   , input                               dma_out_deq_i
+
+   // DMA read data from cache2axi (axi -> core)
+   , input [dma_data_width_p-1:0]        dma_in_data_i
+   , input                               dma_in_enq_i
+   , output logic                        dma_in_full_o
+   , output logic [dma_data_width_p-1:0] dma_in_data_o
+   , output logic                        dma_in_v_o
+   , input                               dma_in_deq_i
+   );
+
+  bsg_async_fifo
+   #(.width_p(mem_fwd_width_p), .lg_size_p(lg_async_fifo_size_p))
+   mem_fwd_iaf
+    (.w_clk_i(axi_clk_i)
+     ,.w_reset_i(axi_reset_i)
+
+     ,.w_enq_i(mem_fwd_in_enq_i)
+     ,.w_data_i(mem_fwd_in_data_i)
+     ,.w_full_o(mem_fwd_in_full_o)
+
+     ,.r_clk_i(core_clk_i)
+     ,.r_reset_i(core_reset_i)
+
+     ,.r_deq_i(mem_fwd_in_deq_i)
+     ,.r_data_o(mem_fwd_in_data_o)
+     ,.r_valid_o(mem_fwd_in_v_o)
+     );
+
+  bsg_async_fifo
+   #(.width_p(mem_rev_width_p), .lg_size_p(lg_async_fifo_size_p))
+   mem_rev_oaf
+    (.w_clk_i(core_clk_i)
+     ,.w_reset_i(core_reset_i)
+
+     ,.w_enq_i(mem_rev_out_enq_i)
+     ,.w_data_i(mem_rev_out_data_i)
+     ,.w_full_o(mem_rev_out_full_o)
+
+     ,.r_clk_i(axi_clk_i)
+     ,.r_reset_i(axi_reset_i)
+
+     ,.r_deq_i(mem_rev_out_deq_i)
+     ,.r_data_o(mem_rev_out_data_o)
+     ,.r_valid_o(mem_rev_out_v_o)
+     );
+
+  bsg_async_fifo
+   #(.width_p(mem_fwd_width_p), .lg_size_p(lg_async_fifo_size_p))
+   mem_fwd_oaf
+    (.w_clk_i(core_clk_i)
+     ,.w_reset_i(core_reset_i)
+
+     ,.w_enq_i(mem_fwd_out_enq_i)
+     ,.w_data_i(mem_fwd_out_data_i)
+     ,.w_full_o(mem_fwd_out_full_o)
+
+     ,.r_clk_i(axi_clk_i)
+     ,.r_reset_i(axi_reset_i)
+
+     ,.r_deq_i(mem_fwd_out_deq_i)
+     ,.r_data_o(mem_fwd_out_data_o)
+     ,.r_valid_o(mem_fwd_out_v_o)
+     );
+
+  bsg_async_fifo
+   #(.width_p(mem_rev_width_p), .lg_size_p(lg_async_fifo_size_p))
+   mem_rev_iaf
+    (.w_clk_i(axi_clk_i)
+     ,.w_reset_i(axi_reset_i)
+
+     ,.w_enq_i(mem_rev_in_enq_i)
+     ,.w_data_i(mem_rev_in_data_i)
+     ,.w_full_o(mem_rev_in_full_o)
+
+     ,.r_clk_i(core_clk_i)
+     ,.r_reset_i(core_reset_i)
+
+     ,.r_deq_i(mem_rev_in_deq_i)
+     ,.r_data_o(mem_rev_in_data_o)
+     ,.r_valid_o(mem_rev_in_v_o)
+     );
+
+  bsg_async_fifo
+   #(.width_p(dma_pkt_width_p), .lg_size_p(lg_async_fifo_size_p))
+   dma_pkt_af
+    (.w_clk_i(core_clk_i)
+     ,.w_reset_i(core_reset_i)
+
+     ,.w_enq_i(dma_pkt_enq_i)
+     ,.w_data_i(dma_pkt_data_i)
+     ,.w_full_o(dma_pkt_full_o)
+
+     ,.r_clk_i(axi_clk_i)
+     ,.r_reset_i(axi_reset_i)
+
+     ,.r_deq_i(dma_pkt_deq_i)
+     ,.r_data_o(dma_pkt_data_o)
+     ,.r_valid_o(dma_pkt_v_o)
+     );
+
+  bsg_async_fifo
+   #(.width_p(dma_data_width_p), .lg_size_p(lg_async_fifo_size_p))
+   dma_out_data_af
+    (.w_clk_i(core_clk_i)
+     ,.w_reset_i(core_reset_i)
+
+     ,.w_enq_i(dma_out_enq_i)
+     ,.w_data_i(dma_out_data_i)
+     ,.w_full_o(dma_out_full_o)
+
+     ,.r_clk_i(axi_clk_i)
+     ,.r_reset_i(axi_reset_i)
+
+     ,.r_deq_i(dma_out_deq_i)
+     ,.r_data_o(dma_out_data_o)
+     ,.r_valid_o(dma_out_v_o)
+     );
+
+  bsg_async_fifo
+   #(.width_p(dma_data_width_p), .lg_size_p(lg_async_fifo_size_p))
+   dma_in_data_af
+    (.w_clk_i(axi_clk_i)
+     ,.w_reset_i(axi_reset_i)
+
+     ,.w_enq_i(dma_in_enq_i)
+     ,.w_data_i(dma_in_data_i)
+     ,.w_full_o(dma_in_full_o)
+
+     ,.r_clk_i(core_clk_i)
+     ,.r_reset_i(core_reset_i)
+
+     ,.r_deq_i(dma_in_deq_i)
+     ,.r_data_o(dma_in_data_o)
+     ,.r_valid_o(dma_in_v_o)
+     );
+
+endmodule
@@ -0,0 +1,221 @@
+#include "Vbp_bedrock_ring_standin.h"
+#include "verilated.h"
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <verilated_fst_c.h>
+#include <random>
+#include <queue>
+#include <vector>
+#include <functional>
+#include <cassert>
+#include <sys/mman.h>
+
+#include "bp_bedrock_ring.h"
+#include "bsg_sim_kernel.h"
+
+#define TEST_SIZE 16384
+#define RING_ELS 64
+#define BATCH_SIZE 16
+#define NUM_CREDITS 16
+#define MEM_ELS 256
+#define TIMEOUT (TEST_SIZE * 1000)
+
+using namespace std;
+
+// Set your seed here:
+#define SEED 9877
+mt19937 random_generator(SEED);
+uniform_int_distribution<uint32_t> distribution;
+auto dice = bind(distribution, random_generator);
+
+
+// Host software: issues batches of requests through the ring and checks the
+//   responses against a shadow copy of the stand-in memory
+class ring_host {
+    private:
+        bp_bedrock_ring_host *host;
+        vector<uint64_t> shadow;
+        queue<bp_bedrock_packet> expected;
+        vector<bp_bedrock_packet> pending;
+        size_t issued = 0;
+
+        bp_bedrock_packet make_packet()
+        {
+            bp_bedrock_packet pkt;
+            memset(&pkt, 0, sizeof(pkt));
+            uint32_t op = dice() % 4;
+            uint64_t idx = dice() % MEM_ELS;
+            uint64_t data = ((uint64_t) dice() << 32) | dice();
+            pkt.msg_type = (op == 0) ? BEDROCK_MEM_AMO : (op == 1) ? BEDROCK_MEM_RD : BEDROCK_MEM_WR;
+            pkt.subop = (op == 0) ? BEDROCK_AMOSWAP : BEDROCK_STORE;
+            pkt.addr0 = idx << 3;
+            pkt.addr1 = 0;
+            pkt.size = BEDROCK_MSG_SIZE_8;
+            pkt.data0 = data & 0xffffffff;
+            pkt.data1 = data >> 32;
+
+            if (bp_bedrock_ring_host::expects_response(pkt)) {
+                bp_bedrock_packet rsp = pkt;
+                rsp.data0 = shadow[idx] & 0xffffffff;
+                rsp.data1 = shadow[idx] >> 32;
+                expected.push(rsp);
+            }
+            if (pkt.msg_type != BEDROCK_MEM_RD)
+                shadow[idx] = data;
+
+            return pkt;
+        }
+
+    public:
+        size_t responses = 0;
+        size_t errors = 0;
+
+        ring_host(bp_bedrock_ring_host *host) : host(host), shadow(MEM_ELS, 0) { }
+
+        bool done() const { return (issued == TEST_SIZE) && expected.empty(); }
+
+        void sim()
+        {
+            // Software batches a group of requests, then rings once
+            size_t n = min((size_t) BATCH_SIZE, TEST_SIZE - issued);
+            if (n != 0 && host->space() >= n) {
+                bp_bedrock_packet batch[BATCH_SIZE];
+                while (pending.size() < n)
+                    pending.push_back(make_packet());
+                copy(pending.begin(), pending.begin() + n, batch);
+                uint32_t sent = host->send(batch, n);
+                pending.erase(pending.begin(), pending.begin() + sent);
+                issued += sent;
+            }
+
+            // Responses are polled from memory, no MMIO
+            bp_bedrock_packet rsp[BATCH_SIZE];
+            uint32_t got = host->poll(rsp, BATCH_SIZE);
+            for (uint32_t i = 0; i < got; i++) {
+                if (expected.empty() || memcmp(&rsp[i], &expected.front(), sizeof(rsp[i])) != 0) {
+                    if (errors++ < 8)
+                        printf("response %lu mismatch: addr %x data %08x%08x\n",
+                            responses, rsp[i].addr0, rsp[i].data1, rsp[i].data0);
+                }
+                if (!expected.empty())
+                    expected.pop();
+                responses++;
+            }
+        }
+};
+
+// Device end: moves ring packets to/from the fifo ports of the stand-in
+class ring_pump {
+    private:
+        bp_bedrock_ring_device *device;
+
+        VL_IN  (&fwd_fifo,31,0);
+        VL_IN8 (&fwd_fifo_v,0,0);
+        VL_OUT8(&fwd_fifo_ready_and,0,0);
+        VL_OUT (&rev_fifo,31,0);
+        VL_OUT8(&rev_fifo_v,0,0);
+        VL_IN8 (&rev_fifo_ready_and,0,0);
+
+    public:
+        ring_pump(bp_bedrock_ring_device *device,
+            VL_IN  (&fwd_fifo,31,0), VL_IN8 (&fwd_fifo_v,0,0),
+            VL_OUT8(&fwd_fifo_ready_and,0,0), VL_OUT (&rev_fifo,31,0),
+            VL_OUT8(&rev_fifo_v,0,0), VL_IN8 (&rev_fifo_ready_and,0,0)):
+        device(device), fwd_fifo(fwd_fifo), fwd_fifo_v(fwd_fifo_v),
+        fwd_fifo_ready_and(fwd_fifo_ready_and), rev_fifo(rev_fifo),
+        rev_fifo_v(rev_fifo_v), rev_fifo_ready_and(rev_fifo_ready_and) {
+            this->fwd_fifo = 0;
+            this->fwd_fifo_v = 0;
+            this->rev_fifo_ready_and = 0;
+        }
+
+        void sim(bool post_read)
+        {
+            if (post_read == false) {
+                uint32_t word;
+                fwd_fifo_v = device->fwd_word(word);
+                fwd_fifo = fwd_fifo_v ? word : 0;
+                rev_fifo_ready_and = device->rev_ready();
+            }
+            else {
+                if (fwd_fifo_v == 1 && fwd_fifo_ready_and == 1)
+                    device->fwd_yumi();
+                if (rev_fifo_v == 1 && rev_fifo_ready_and == 1)
+                    device->rev_word(rev_fifo);
+            }
+        }
+};
+
+int main(int argc, char **argv, char **env)
+{
+    unique_ptr<VerilatedContext> contextp(new VerilatedContext);
+    contextp->commandArgs(argc, argv);
+    unique_ptr<VerilatedFstC> tfp(new VerilatedFstC);
+    contextp->traceEverOn(VM_TRACE_FST);
+    unique_ptr<Vbp_bedrock_ring_standin> dut(new Vbp_bedrock_ring_standin(contextp.get()));
+
+    dut->trace(tfp.get(), 10);
+    tfp->open("dump.fst");
+
+    // Shared mapping stands in for the host/device buffer (e.g. udmabuf)
+    size_t ring_bytes = bp_bedrock_ring::footprint(RING_ELS);
+    void *shm = mmap(NULL, 2 * ring_bytes, PROT_READ | PROT_WRITE,
+        MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    assert(shm != MAP_FAILED);
+    bp_bedrock_ring req_ring(shm, RING_ELS);
+    bp_bedrock_ring rsp_ring((uint8_t *) shm + ring_bytes, RING_ELS);
+    req_ring.reset();
+    rsp_ring.reset();
+
+    bp_bedrock_ring_device device(&req_ring, &rsp_ring, NUM_CREDITS);
+    bp_bedrock_ring_host host(&req_ring, &rsp_ring,
+        [&device](uint32_t prod) { device.ring(prod); });
+
+    ring_host sw(&host);
+    ring_pump pump(&device,
+        dut->fwd_fifo_i,
+        dut->fwd_fifo_v_i,
+        dut->fwd_fifo_ready_and_o,
+        dut->rev_fifo_o,
+        dut->rev_fifo_v_o,
+        dut->rev_fifo_ready_and_i
+    );
+
+    bsg_sim_kernel kernel(contextp.get(), dut.get());
+    kernel.trace([&](uint64_t t) { tfp->dump(t); });
+    int clk = kernel.add_clock(dut->clk_i, 2);
+
+    dut->reset_i = 1;
+    kernel.run(1, clk);
+    dut->reset_i = 0;
+    kernel.touch();
+
+    kernel.pre_edge(clk, [&]() { pump.sim(true); });
+    kernel.post_edge(clk, [&]() {
+        sw.sim();
+        pump.sim(false);
+    });
+    uint64_t start = kernel.cycles(clk);
+    kernel.run_until([&]() { return sw.done() && device.idle(); }, kernel.time() + 2 * (uint64_t) TIMEOUT);
+    uint64_t cycles = kernel.cycles(clk) - start;
+
+    printf("Total simulation time: %lu\n", contextp->time());
+    tfp->close();
+
+    printf("Packets: %d, responses: %lu, cycles: %lu\n", TEST_SIZE, sw.responses, cycles);
+    printf("Doorbells: %lu (%.2f packets/doorbell)\n", host.doorbells,
+        (double) TEST_SIZE / host.doorbells);
+
+    bool pass = sw.done() && device.idle() && (sw.errors == 0);
+    munmap(shm, 2 * ring_bytes);
+    if (pass) {
+        printf("Check succeeded\n");
+        return 0;
+    }
+    else {
+        printf("Check failed\n");
+        return 1;
+    }
+}
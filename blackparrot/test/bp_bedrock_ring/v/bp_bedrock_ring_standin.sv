@@ -0,0 +1,123 @@
+
+`include "bsg_defines.sv"
+
+// Co-simulation stand-in for the host-facing fifo ports of bp_endpoint_to_fifos
+//   (fwd_fifo_i / rev_fifo_o). Incoming 224b BedRock packets are applied to a
+//   small 64b memory; reads and AMOs (treated as swap) are answered on the
+//   reverse fifo while stores are silently acked, matching the endpoint.
+//   Only 8B aligned accesses are modeled.
+module bp_bedrock_ring_standin
+ #(parameter fifo_width_p = 32
+   , parameter mem_els_p = 256
+   , parameter resp_latency_p = 8
+
+   , localparam mem_addr_width_lp = `BSG_SAFE_CLOG2(mem_els_p)
+   )
+  (input                                 clk_i
+   , input                               reset_i
+
+   , input [fifo_width_p-1:0]            fwd_fifo_i
+   , input                               fwd_fifo_v_i
+   , output logic                        fwd_fifo_ready_and_o
+
+   , output logic [fifo_width_p-1:0]     rev_fifo_o
+   , output logic                        rev_fifo_v_o
+   , input                               rev_fifo_ready_and_i
+   );
+
+  // MUST match bp_endpoint_to_fifos and bp_bedrock_packet.h
+  typedef struct packed
+  {
+    logic [7:0]  padding;
+    logic [63:0] data;
+    logic [63:0] payload;
+    logic [7:0]  size;
+    logic [63:0] addr;
+    logic [7:0]  subop;
+    logic [7:0]  msg_type;
+  }  bp_bedrock_msg_aligned_s;
+
+  localparam msg_rd_lp  = 8'h0;
+  localparam msg_wr_lp  = 8'h1;
+  localparam msg_amo_lp = 8'h2;
+
+  bp_bedrock_msg_aligned_s fwd_lo;
+  logic fwd_v_lo, fwd_yumi_li;
+  bsg_serial_in_parallel_out_full
+   #(.width_p(fifo_width_p), .els_p($bits(bp_bedrock_msg_aligned_s)/fifo_width_p))
+   fwd_sipo
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.data_i(fwd_fifo_i)
+     ,.v_i(fwd_fifo_v_i)
+     ,.ready_and_o(fwd_fifo_ready_and_o)
+
+     ,.data_o(fwd_lo)
+     ,.v_o(fwd_v_lo)
+     ,.yumi_i(fwd_yumi_li)
+     );
+
+  bp_bedrock_msg_aligned_s rev_li;
+  logic rev_v_li, rev_ready_and_lo;
+  bsg_parallel_in_serial_out
+   #(.width_p(fifo_width_p), .els_p($bits(bp_bedrock_msg_aligned_s)/fifo_width_p))
+   rev_piso
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.data_i(rev_li)
+     ,.valid_i(rev_v_li)
+     ,.ready_and_o(rev_ready_and_lo)
+
+     ,.data_o(rev_fifo_o)
+     ,.valid_o(rev_fifo_v_o)
+     ,.yumi_i(rev_fifo_ready_and_i & rev_fifo_v_o)
+     );
+
+  // Emulate memory latency so that several requests are in flight
+  logic [`BSG_WIDTH(resp_latency_p)-1:0] wait_cnt_lo;
+  wire wait_done = (wait_cnt_lo == resp_latency_p);
+  bsg_counter_clear_up
+   #(.max_val_p(resp_latency_p), .init_val_p(0))
+   wait_counter
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.clear_i(fwd_yumi_li)
+     ,.up_i(fwd_v_lo & ~wait_done)
+     ,.count_o(wait_cnt_lo)
+     );
+
+  wire [mem_addr_width_lp-1:0] mem_addr_li = fwd_lo.addr[3+:mem_addr_width_lp];
+  wire is_rd  = (fwd_lo.msg_type == msg_rd_lp);
+  wire is_wr  = (fwd_lo.msg_type == msg_wr_lp);
+  wire is_amo = (fwd_lo.msg_type == msg_amo_lp);
+  wire needs_resp = is_rd | is_amo;
+
+  logic [63:0] mem_r_data_lo;
+  bsg_mem_1r1w
+   #(.width_p(64), .els_p(mem_els_p), .read_write_same_addr_p(1))
+   mem
+    (.w_clk_i(clk_i)
+     ,.w_reset_i(reset_i)
+     ,.w_v_i(fwd_yumi_li & (is_wr | is_amo))
+     ,.w_addr_i(mem_addr_li)
+     ,.w_data_i(fwd_lo.data)
+
+     ,.r_v_i(fwd_v_lo)
+     ,.r_addr_i(mem_addr_li)
+     ,.r_data_o(mem_r_data_lo)
+     );
+
+  always_comb
+    begin
+      rev_li = fwd_lo;
+      rev_li.data = mem_r_data_lo;
+      rev_v_li = fwd_v_lo & wait_done & needs_resp;
+
+      fwd_yumi_li = fwd_v_lo & wait_done & (~needs_resp | rev_ready_and_lo);
+    end
+
+endmodule
+
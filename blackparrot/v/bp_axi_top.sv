@@ -14,7 +14,11 @@ module bp_axi_top
  #(parameter bp_params_e bp_params_p = e_bp_default_cfg
    `declare_bp_proc_params(bp_params_p)
    , parameter axi_core_clk_async_p = 0
-   , localparam lg_async_fifo_size_lp = 3
+   // Depth of the clock crossing fifos. The writer sees a freed entry about
+   //   3 read clocks + 3 write clocks after it is read, so to stream at the
+   //   slower clock the depth should cover that round trip; see
+   //   test/bp_axi_cdc for a sweep over clock ratios
+   , parameter lg_async_fifo_size_p = 3
 
    // AXI4-LITE PARAMS
    , parameter `BSG_INV_PARAM(m_axil_addr_width_p)
@@ -366,13 +370,16 @@ module bp_axi_top
   assign m_axi_araddr_o = m_axi_araddr_addr;
   assign m_axi_awaddr_o = m_axi_awaddr_addr;
 
+  // test/bp_axi_cdc/v/bp_axi_cdc_standin.sv copies these crossings by
+  //   instance name; make -C test/bp_axi_cdc/verilator check fails if the
+  //   two drift apart
   if (axi_core_clk_async_p)
     begin : async
       // Input I/O interface
       logic axi_mem_fwd_out_full_lo;
       assign axi_mem_fwd_ready_and_li = ~axi_mem_fwd_out_full_lo;
       bsg_async_fifo
-       #(.width_p($bits(bp_bedrock_mem_fwd_header_s)+bedrock_fill_width_p), .lg_size_p(lg_async_fifo_size_lp))
+       #(.width_p($bits(bp_bedrock_mem_fwd_header_s)+bedrock_fill_width_p), .lg_size_p(lg_async_fifo_size_p))
        mem_fwd_iaf
         (.w_clk_i(axi_clk_i)
          ,.w_reset_i(axi_reset_li)
@@ -392,7 +399,7 @@ module bp_axi_top
       logic mem_rev_out_full_lo;
       assign mem_rev_ready_and_li = ~mem_rev_out_full_lo;
       bsg_async_fifo
-       #(.width_p($bits(bp_bedrock_mem_rev_header_s)+bedrock_fill_width_p), .lg_size_p(lg_async_fifo_size_lp))
+       #(.width_p($bits(bp_bedrock_mem_rev_header_s)+bedrock_fill_width_p), .lg_size_p(lg_async_fifo_size_p))
        mem_rev_oaf
         (.w_clk_i(core_clk_i)
          ,.w_reset_i(core_reset_li)
@@ -414,7 +421,7 @@ module bp_axi_top
       logic mem_fwd_out_full_lo;
       assign mem_fwd_ready_and_li = ~mem_fwd_out_full_lo;
       bsg_async_fifo
-       #(.width_p($bits(bp_bedrock_mem_fwd_header_s)+bedrock_fill_width_p), .lg_size_p(lg_async_fifo_size_lp))
+       #(.width_p($bits(bp_bedrock_mem_fwd_header_s)+bedrock_fill_width_p), .lg_size_p(lg_async_fifo_size_p))
        mem_fwd_oaf
         (.w_clk_i(core_clk_i)
          ,.w_reset_i(core_reset_li)
@@ -434,7 +441,7 @@ module bp_axi_top
       logic axi_mem_rev_out_full_lo;
       assign axi_mem_rev_ready_and_li = ~axi_mem_rev_out_full_lo;
       bsg_async_fifo
-       #(.width_p($bits(bp_bedrock_mem_rev_header_s)+bedrock_fill_width_p), .lg_size_p(lg_async_fifo_size_lp))
+       #(.width_p($bits(bp_bedrock_mem_rev_header_s)+bedrock_fill_width_p), .lg_size_p(lg_async_fifo_size_p))
        mem_rev_iaf
         (.w_clk_i(axi_clk_i)
          ,.w_reset_i(axi_reset_li)
@@ -455,7 +462,7 @@ module bp_axi_top
       logic dma_pkt_full_lo;
       assign dma_pkt_ready_and_li = ~dma_pkt_full_lo;
       bsg_async_fifo
-       #(.width_p($bits(bsg_cache_dma_pkt_s)), .lg_size_p(lg_async_fifo_size_lp))
+       #(.width_p($bits(bsg_cache_dma_pkt_s)), .lg_size_p(lg_async_fifo_size_p))
        dma_pkt_af
         (.w_clk_i(core_clk_i)
          ,.w_reset_i(core_reset_li)
@@ -475,7 +482,7 @@ module bp_axi_top
       logic dma_data_out_full_lo;
       assign dma_data_ready_and_li = ~dma_data_out_full_lo;
       bsg_async_fifo
-       #(.width_p(l2_fill_width_p), .lg_size_p(lg_async_fifo_size_lp))
+       #(.width_p(l2_fill_width_p), .lg_size_p(lg_async_fifo_size_p))
        dma_out_data_af
         (.w_clk_i(core_clk_i)
          ,.w_reset_i(core_reset_li)
@@ -495,7 +502,7 @@ module bp_axi_top
       logic axi_dma_in_full_lo;
       assign axi_dma_data_ready_and_li = ~axi_dma_in_full_lo;
       bsg_async_fifo
-       #(.width_p(l2_fill_width_p), .lg_size_p(lg_async_fifo_size_lp))
+       #(.width_p(l2_fill_width_p), .lg_size_p(lg_async_fifo_size_p))
        dma_in_data_af
         (.w_clk_i(axi_clk_i)
          ,.w_reset_i(axi_reset_li)
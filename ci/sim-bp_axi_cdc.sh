@@ -0,0 +1,16 @@
+#!/bin/bash
+source $(dirname $0)/functions.sh
+
+tool=$1
+
+group=blackparrot
+module=bp_axi_cdc
+testdir=$group/test/$module/$tool
+
+# do the actual job
+bsg_run_task build "building C++ test" make -C $testdir build
+bsg_run_task run "running C++ test" make -C $testdir run
+
+# pass if no error
+bsg_pass $(basename $0)
+
@@ -0,0 +1,17 @@
+#!/bin/bash
+source $(dirname $0)/functions.sh
+
+tool=$1
+
+group=zynq
+module=bsg_axis_fifo
+testdir=$group/test/$module/$tool
+
+# do the actual job
+bsg_run_task build "building C++ test" make -C $testdir build
+bsg_run_task run "running C++ test" make -C $testdir run
+bsg_run_task run-cut "running C++ cut-through test" make -C $testdir run-cut
+
+# pass if no error
+bsg_pass $(basename $0)
+
@@ -0,0 +1,276 @@
+#include "Vbench.h"
+#include "verilated.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <memory>
+#include <random>
+#include <deque>
+#include <vector>
+#include <functional>
+
+#include "bsg_sim_kernel.h"
+
+// Mesh size and thread count the model is built with, and whether its top
+//   has a live host endpoint (bsg_hammerblade_bench) or not
+#ifndef TILES_X
+#define TILES_X 16
+#endif
+#ifndef TILES_Y
+#define TILES_Y 8
+#endif
+#ifndef THREADS
+#define THREADS 1
+#endif
+#ifndef HOST_TRAFFIC
+#define HOST_TRAFFIC 1
+#endif
+
+#define DEFAULT_CYCLES 100000
+#define RESET_CYCLES 16
+// Bound on the tag master bringing the pod out of reset
+#define TAG_TIMEOUT_CYCLES 100000
+// Bound on draining the requests in flight after the timed run
+#define DRAIN_CYCLES 10000
+
+// Host requests in flight, tagged with the 5-bit manycore reg_id
+#define HOST_TAGS 32
+// Tile DMEM, as a word address and size in words
+#define DMEM_EPA 0x400
+#define DMEM_WORDS 1024
+
+// Host fifo format, see bsg_manycore_endpoint_to_fifos.svh
+#define HOST_BEATS 4
+#define OP_REMOTE_LOAD 0
+#define OP_REMOTE_SW   2
+
+using namespace std;
+
+// Set your seed here:
+#define SEED 9877
+mt19937 random_generator(SEED);
+uniform_int_distribution<uint32_t> distribution;
+auto dice = bind(distribution, random_generator);
+
+int clog2(int n)
+{
+    int lg = 0;
+    while ((1 << lg) < n)
+        lg++;
+    return lg;
+}
+
+// Pod tiles sit in the second pod row and column; the host is on the first
+//   IO router, in the row above the pod
+const int x_subcord_width = clog2(TILES_X);
+const int y_subcord_width = clog2(TILES_Y);
+const uint32_t host_x = TILES_X;
+const uint32_t host_y = 0;
+
+uint32_t tile_x(int t) { return (1U << x_subcord_width) | (t % TILES_X); }
+uint32_t tile_y(int t) { return (1U << y_subcord_width) | (t / TILES_X); }
+
+// Each tile runs a chain of word stores, each read back before the next
+struct tile_state {
+    uint32_t word = 0;
+    uint32_t data = 0;
+    bool load_next = false;
+    bool busy = false;
+};
+
+class testbench {
+    private:
+        unique_ptr<VerilatedContext> contextp;
+        unique_ptr<Vbench> dut;
+        unique_ptr<bsg_sim_kernel> kernel;
+        int clk;
+
+        vector<tile_state> tiles;
+        int next_tile = 0;
+        // Tile waiting on each reg_id, or -1
+        vector<int> tag_tile;
+        vector<int> free_tags;
+
+        deque<uint32_t> tx_beats;
+        uint32_t rx_beats[HOST_BEATS];
+        int rx_count = 0;
+
+        void issue()
+        {
+            if (!tx_beats.empty() || free_tags.empty())
+                return;
+            for (int i = 0; i < TILES_X * TILES_Y; i++) {
+                int t = (next_tile + i) % (TILES_X * TILES_Y);
+                tile_state &ts = tiles[t];
+                if (ts.busy)
+                    continue;
+
+                int tag = free_tags.back();
+                free_tags.pop_back();
+                tag_tile[tag] = t;
+                ts.busy = true;
+                if (!ts.load_next)
+                    ts.data = dice();
+
+                // x_cord, y_cord, src_x_cord, src_y_cord, payload, reg_id, op_v2, addr
+                uint32_t addr = DMEM_EPA + ts.word;
+                uint32_t op = ts.load_next ? OP_REMOTE_LOAD : OP_REMOTE_SW;
+                tx_beats.push_back(tile_x(t) | (tile_y(t) << 8) | (host_x << 16) | (host_y << 24));
+                tx_beats.push_back(ts.load_next ? 0 : ts.data);
+                tx_beats.push_back(tag | (op << 8) | ((addr & 0xffff) << 16));
+                tx_beats.push_back(addr >> 16);
+
+                next_tile = (t + 1) % (TILES_X * TILES_Y);
+                return;
+            }
+        }
+
+        // x_cord, y_cord, reg_id, data, pkt_type
+        void receive()
+        {
+            uint32_t tag = (rx_beats[0] >> 16) & 0xff;
+            uint32_t data = (rx_beats[0] >> 24) | (rx_beats[1] << 8);
+            if (tag >= HOST_TAGS || tag_tile[tag] < 0) {
+                errors++;
+                return;
+            }
+            tile_state &ts = tiles[tag_tile[tag]];
+            if (ts.load_next) {
+                if (data != ts.data)
+                    errors++;
+                ts.word = (ts.word + 1) % DMEM_WORDS;
+                loads++;
+            } else {
+                stores++;
+            }
+            ts.load_next = !ts.load_next;
+            ts.busy = false;
+            tag_tile[tag] = -1;
+            free_tags.push_back(tag);
+        }
+
+        void handshake()
+        {
+            if (dut->endpoint_req_v_i && dut->endpoint_req_ready_o)
+                tx_beats.pop_front();
+            if (dut->mc_rsp_v_o && dut->mc_rsp_ready_i) {
+                rx_beats[rx_count++] = dut->mc_rsp_o;
+                if (rx_count == HOST_BEATS) {
+                    receive();
+                    rx_count = 0;
+                }
+            }
+        }
+
+    public:
+        bool traffic = false;
+        uint64_t cycles = 0;
+        uint64_t stores = 0;
+        uint64_t loads = 0;
+        uint64_t errors = 0;
+
+        testbench(int argc, char **argv):
+            contextp(new VerilatedContext),
+            tiles(TILES_X * TILES_Y),
+            tag_tile(HOST_TAGS, -1)
+        {
+            contextp->commandArgs(argc, argv);
+            dut.reset(new Vbench{contextp.get()});
+            kernel.reset(new bsg_sim_kernel(contextp.get(), dut.get()));
+            clk = kernel->add_clock(dut->clk_i, 2, 1);
+            kernel->pre_edge(clk, [this]() { handshake(); });
+            for (int i = HOST_TAGS - 1; i >= 0; i--)
+                free_tags.push_back(i);
+            dut->reset_i = 1;
+            dut->endpoint_req_i = 0;
+            dut->endpoint_req_v_i = 0;
+            dut->mc_rsp_ready_i = 0;
+            kernel->settle();
+        }
+
+        ~testbench() { dut->final(); }
+
+        bool tag_done() const { return dut->tag_done_o; }
+        bool idle() const { return tx_beats.empty() && (int) free_tags.size() == HOST_TAGS; }
+        string arg(const char *name) const { return contextp->commandArgsPlusMatch(name); }
+
+        void cycle()
+        {
+            if (traffic)
+                issue();
+            dut->endpoint_req_v_i = !tx_beats.empty();
+            dut->endpoint_req_i = tx_beats.empty() ? 0 : tx_beats.front();
+            dut->mc_rsp_ready_i = 1;
+            kernel->touch();
+
+            kernel->run(1, clk);
+            cycles++;
+        }
+
+        void reset()
+        {
+            dut->reset_i = 1;
+            for (int i = 0; i < RESET_CYCLES; i++)
+                cycle();
+            dut->reset_i = 0;
+        }
+};
+
+int main(int argc, char **argv, char **env)
+{
+    testbench tb(argc, argv);
+    bool ok = true;
+
+    string cycles_arg = tb.arg("cycles=");
+    uint64_t timed_cycles = cycles_arg.empty() ? DEFAULT_CYCLES
+        : strtoull(cycles_arg.c_str() + strlen("+cycles="), nullptr, 10);
+    bool header = tb.arg("noheader").empty();
+    // A sweep prints one table, and its own result once every run passed
+    bool sweep = !tb.arg("sweep").empty();
+
+    tb.reset();
+    while (!tb.tag_done() && tb.cycles < TAG_TIMEOUT_CYCLES)
+        tb.cycle();
+    ok &= tb.tag_done();
+    // Let the pod reset propagate out from the tag clients
+    for (int i = 0; i < RESET_CYCLES; i++)
+        tb.cycle();
+
+    tb.traffic = HOST_TRAFFIC;
+    tb.cycles = 0;
+    auto start = chrono::steady_clock::now();
+    while (tb.cycles < timed_cycles)
+        tb.cycle();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    tb.traffic = false;
+    for (int i = 0; i < DRAIN_CYCLES && !tb.idle(); i++)
+        tb.cycle();
+    ok &= tb.idle() && !tb.errors;
+    if (HOST_TRAFFIC)
+        ok &= (tb.loads != 0);
+
+    // bsg_manycore_tile_blackparrot_mesh is a row of 4 BP tiles; TILES_X and
+    //   TILES_Y only set its coordinate widths
+    char mesh[16];
+    snprintf(mesh, sizeof(mesh), "%dx%d", HOST_TRAFFIC ? TILES_X : 4, HOST_TRAFFIC ? TILES_Y : 1);
+    if (header)
+        printf("%-36s %6s %7s | %9s %9s %12s | %9s %9s\n", "top", "mesh", "threads",
+            "cycles", "seconds", "cycles/sec", "stores", "loads");
+    printf("%-36s %6s %7d | %9lu %9.3f %12.0f | %9lu %9lu%s\n",
+        HOST_TRAFFIC ? "bsg_hammerblade" : "bsg_manycore_tile_blackparrot_mesh",
+        mesh, THREADS, (unsigned long) timed_cycles, seconds, timed_cycles / seconds,
+        (unsigned long) tb.stores, (unsigned long) tb.loads,
+        tb.errors ? " DATA ERROR" : (tb.idle() ? "" : " TIMEOUT"));
+
+    if (ok) {
+        if (!sweep)
+            printf("Check succeeded\n");
+        return 0;
+    }
+    printf("Check failed\n");
+    return 1;
+}
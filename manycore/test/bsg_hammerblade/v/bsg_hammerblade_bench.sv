@@ -0,0 +1,169 @@
+
+`include "bsg_manycore_defines.svh"
+`include "bsg_manycore_endpoint_to_fifos.svh"
+`include "bsg_tag.svh"
+
+// Benchmark top for bsg_hammerblade: a single pod with the BlackParrot mesh,
+//   brought out of reset by the manycore tag master. A host endpoint sits on
+//   the IO router, so the harness can run traffic through the mesh. The
+//   wormhole (DRAM) links are idle, so only tile DMEM should be targeted.
+module bsg_hammerblade_bench
+ import bsg_manycore_pkg::*;
+ import bsg_tag_pkg::*;
+ import bsg_manycore_network_cfg_pkg::*;
+ #(parameter num_tiles_x_p = 16
+   , parameter num_tiles_y_p = 8
+   , parameter host_width_p = 32
+
+   // HammerBlade pod defaults
+   , localparam pod_x_cord_width_lp = 3
+   , localparam pod_y_cord_width_lp = 4
+   , localparam x_cord_width_lp = pod_x_cord_width_lp + `BSG_SAFE_CLOG2(num_tiles_x_p)
+   , localparam y_cord_width_lp = pod_y_cord_width_lp + `BSG_SAFE_CLOG2(num_tiles_y_p)
+   , localparam addr_width_lp = 28
+   , localparam data_width_lp = 32
+   , localparam icache_block_size_in_words_lp = 4
+   , localparam vcache_block_size_in_words_lp = 8
+   , localparam vcache_dma_data_width_lp = 32
+   , localparam wh_ruche_factor_lp = 2
+
+   , localparam manycore_link_sif_width_lp =
+       `bsg_manycore_link_sif_width(addr_width_lp, data_width_lp, x_cord_width_lp, y_cord_width_lp)
+   , localparam wh_link_sif_width_lp = `bsg_ready_and_link_sif_width(vcache_dma_data_width_lp)
+   )
+  (input                                 clk_i
+   , input                               reset_i
+   , output logic                        tag_done_o
+
+   , input [host_width_p-1:0]            endpoint_req_i
+   , input                               endpoint_req_v_i
+   , output logic                        endpoint_req_ready_o
+
+   , output logic [host_width_p-1:0]     mc_rsp_o
+   , output logic                        mc_rsp_v_o
+   , input                               mc_rsp_ready_i
+   );
+
+  bsg_tag_s pod_tags_lo;
+  bsg_nonsynth_manycore_tag_master
+   #(.num_pods_x_p(1)
+     ,.num_pods_y_p(1)
+     ,.wh_cord_width_p(x_cord_width_lp)
+     )
+   tag_master
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+     ,.tag_done_o(tag_done_o)
+     ,.pod_tags_o(pod_tags_lo)
+     );
+
+  logic [manycore_link_sif_width_lp-1:0] io_link_sif_li, io_link_sif_lo;
+  logic [S:N][E:W][wh_ruche_factor_lp-1:0][wh_link_sif_width_lp-1:0] wh_link_sif_lo;
+  bsg_hammerblade
+   #(.scratchpad_els_p(1024)
+
+     ,.num_tiles_x_p(num_tiles_x_p)
+     ,.num_tiles_y_p(num_tiles_y_p)
+     ,.pod_x_cord_width_p(pod_x_cord_width_lp)
+     ,.pod_y_cord_width_p(pod_y_cord_width_lp)
+     ,.x_cord_width_p(x_cord_width_lp)
+     ,.y_cord_width_p(y_cord_width_lp)
+     ,.addr_width_p(addr_width_lp)
+     ,.data_width_p(data_width_lp)
+     ,.ruche_factor_X_p(3)
+
+     ,.num_subarray_x_p(1)
+     ,.num_subarray_y_p(1)
+
+     ,.dmem_size_p(1024)
+     ,.mc_icache_entries_p(1024)
+     ,.mc_icache_tag_width_p(12)
+     ,.mc_icache_block_size_in_words_p(icache_block_size_in_words_lp)
+
+     ,.vcache_addr_width_p(addr_width_lp+1)
+     ,.vcache_data_width_p(data_width_lp)
+     ,.vcache_ways_p(8)
+     ,.vcache_sets_p(64)
+     ,.vcache_block_size_in_words_p(vcache_block_size_in_words_lp)
+     ,.vcache_size_p(2048)
+     ,.vcache_dma_data_width_p(vcache_dma_data_width_lp)
+     ,.vcache_word_tracking_p(1)
+     ,.ipoly_hashing_p(0)
+
+     ,.barrier_ruche_factor_X_p(3)
+
+     ,.wh_ruche_factor_p(wh_ruche_factor_lp)
+     ,.wh_cid_width_p(`BSG_SAFE_CLOG2(2*wh_ruche_factor_lp))
+     ,.wh_flit_width_p(vcache_dma_data_width_lp)
+     ,.wh_cord_width_p(x_cord_width_lp)
+     ,.wh_len_width_p(4)
+
+     ,.num_pods_y_p(1)
+     ,.num_pods_x_p(1)
+
+     ,.reset_depth_p(3)
+
+     ,.rev_use_credits_p(5'b00001)
+
+     ,.bsg_manycore_network_cfg_p(e_network_half_ruche_x)
+     )
+   hammerblade
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+     // The cores stay frozen, so the CLINT never needs to tick
+     ,.rt_clk_i(1'b0)
+
+     ,.io_link_sif_i(io_link_sif_li)
+     ,.io_link_sif_o(io_link_sif_lo)
+
+     ,.wh_link_sif_i('0)
+     ,.wh_link_sif_o(wh_link_sif_lo)
+
+     ,.pod_tags_i(pod_tags_lo)
+     );
+
+  // The host sits on the first IO router
+  bsg_manycore_endpoint_to_fifos
+   #(.fifo_width_p(bsg_manycore_packet_aligned_width_gp)
+     ,.host_width_p(host_width_p)
+     ,.x_cord_width_p(x_cord_width_lp)
+     ,.y_cord_width_p(y_cord_width_lp)
+     ,.addr_width_p(addr_width_lp)
+     ,.data_width_p(data_width_lp)
+     ,.ep_fifo_els_p(4)
+     ,.rev_fifo_els_p(3)
+     ,.icache_block_size_in_words_p(icache_block_size_in_words_lp)
+     )
+   host
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.mc_req_o()
+     ,.mc_req_v_o()
+     ,.mc_req_ready_i(1'b1)
+
+     ,.endpoint_req_i(endpoint_req_i)
+     ,.endpoint_req_v_i(endpoint_req_v_i)
+     ,.endpoint_req_ready_o(endpoint_req_ready_o)
+
+     ,.mc_rsp_o(mc_rsp_o)
+     ,.mc_rsp_v_o(mc_rsp_v_o)
+     ,.mc_rsp_ready_i(mc_rsp_ready_i)
+
+     ,.endpoint_rsp_i('0)
+     ,.endpoint_rsp_v_i(1'b0)
+     ,.endpoint_rsp_ready_o()
+
+     ,.link_sif_i(io_link_sif_lo)
+     ,.link_sif_o(io_link_sif_li)
+
+     ,.global_x_i(x_cord_width_lp'(num_tiles_x_p))
+     ,.global_y_i(y_cord_width_lp'(0))
+
+     ,.out_credits_used_o()
+     );
+
+  wire unused = &{wh_link_sif_lo};
+
+endmodule
+
@@ -0,0 +1,98 @@
+
+`include "bp_common_defines.svh"
+`include "bsg_manycore_defines.svh"
+
+// Benchmark top for bsg_manycore_tile_blackparrot_mesh on its own, with the
+//   coordinates it has in bsg_hammerblade and every link tied off. The host
+//   ports match bsg_hammerblade_bench so that both build with one harness,
+//   but nothing answers there: the harness only clocks this top, and the
+//   cores stay frozen without a host to configure them.
+module bsg_manycore_tile_blackparrot_mesh_bench
+ import bsg_manycore_pkg::*;
+ import bp_common_pkg::*;
+ import bsg_noc_pkg::*;
+ #(parameter num_tiles_x_p = 16
+   , parameter num_tiles_y_p = 8
+   , parameter host_width_p = 32
+
+   // HammerBlade pod defaults, as in bsg_hammerblade_bench
+   , localparam x_subcord_width_lp = `BSG_SAFE_CLOG2(num_tiles_x_p)
+   , localparam y_subcord_width_lp = `BSG_SAFE_CLOG2(num_tiles_y_p)
+   , localparam pod_x_cord_width_lp = 3
+   , localparam pod_y_cord_width_lp = 4
+   , localparam x_cord_width_lp = pod_x_cord_width_lp + x_subcord_width_lp
+   , localparam y_cord_width_lp = pod_y_cord_width_lp + y_subcord_width_lp
+   , localparam addr_width_lp = 28
+   , localparam data_width_lp = 32
+
+   , localparam link_sif_width_lp =
+       `bsg_manycore_link_sif_width(addr_width_lp, data_width_lp, x_cord_width_lp, y_cord_width_lp)
+   )
+  (input                                 clk_i
+   , input                               reset_i
+   , output logic                        tag_done_o
+
+   , input [host_width_p-1:0]            endpoint_req_i
+   , input                               endpoint_req_v_i
+   , output logic                        endpoint_req_ready_o
+
+   , output logic [host_width_p-1:0]     mc_rsp_o
+   , output logic                        mc_rsp_v_o
+   , input                               mc_rsp_ready_i
+   );
+
+  logic [3:0][x_cord_width_lp-1:0] global_x_li;
+  logic [0:0][y_cord_width_lp-1:0] global_y_li;
+  for (genvar i = 0; i < 4; i++)
+    begin : x
+      assign global_x_li[i] = x_cord_width_lp'((1 << x_subcord_width_lp) | i);
+    end
+  assign global_y_li[0] = y_cord_width_lp'((3 << y_subcord_width_lp) | 0);
+
+  logic [E:W][0:0][link_sif_width_lp-1:0] hor_link_sif_lo;
+  logic [S:N][3:0][link_sif_width_lp-1:0] ver_link_sif_lo;
+  bsg_manycore_tile_blackparrot_mesh
+   #(.bp_params_p(e_bp_unicore_hammerblade_cfg)
+     ,.x_cord_width_p(x_cord_width_lp)
+     ,.y_cord_width_p(y_cord_width_lp)
+     ,.pod_x_cord_width_p(pod_x_cord_width_lp)
+     ,.pod_y_cord_width_p(pod_y_cord_width_lp)
+     ,.data_width_p(data_width_lp)
+     ,.addr_width_p(addr_width_lp)
+     ,.icache_block_size_in_words_p(4)
+     ,.vcache_block_size_in_words_p(8)
+     ,.vcache_size_p(2048)
+     ,.vcache_sets_p(64)
+     ,.num_tiles_x_p(num_tiles_x_p)
+     ,.num_tiles_y_p(num_tiles_y_p)
+     ,.ipoly_hashing_p(0)
+     ,.scratchpad_els_p(1024)
+     ,.rev_use_credits_p(5'b00001)
+     ,.rev_fifo_els_p('{2,2,2,2,3})
+     )
+   blackparrot_mesh
+    (.clk_i(clk_i)
+     // The cores stay frozen, so the CLINT never needs to tick
+     ,.rt_clk_i(1'b0)
+     ,.reset_i(reset_i)
+
+     ,.global_x_i(global_x_li)
+     ,.global_y_i(global_y_li)
+
+     ,.hor_link_sif_i('0)
+     ,.hor_link_sif_o(hor_link_sif_lo)
+
+     ,.ver_link_sif_i('0)
+     ,.ver_link_sif_o(ver_link_sif_lo)
+     );
+
+  // No host on this top
+  assign tag_done_o = 1'b1;
+  assign endpoint_req_ready_o = 1'b0;
+  assign mc_rsp_o = '0;
+  assign mc_rsp_v_o = 1'b0;
+
+  wire unused = &{endpoint_req_i, endpoint_req_v_i, mc_rsp_ready_i, hor_link_sif_lo, ver_link_sif_lo};
+
+endmodule
+
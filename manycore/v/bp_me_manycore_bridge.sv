@@ -45,12 +45,17 @@ module bp_me_manycore_bridge
   localparam mc_bridge_reg_host_cord_gp   = (dev_addr_width_gp)'('h0_0018);
   localparam mc_bridge_scratchpad_gp      = (dev_addr_width_gp)'('h0_1000);
 
+  // Byte offset within a dword, and log2 of the access size in bytes
+  localparam sel_width_lp = `BSG_SAFE_CLOG2(dword_width_gp>>3);
+  localparam size_width_lp = `BSG_SAFE_CLOG2(sel_width_lp);
+
   logic scratchpad_r_v_li, scratchpad_w_v_li;
   logic host_cord_r_v_li, host_cord_w_v_li;
   logic my_cord_r_v_li, my_cord_w_v_li;
   logic dram_pod_r_v_li, dram_pod_w_v_li;
   logic dram_offset_r_v_li, dram_offset_w_v_li;
   logic [dev_addr_width_gp-1:0] addr_lo;
+  logic [size_width_lp-1:0] size_lo;
   logic [dword_width_gp-1:0] data_lo;
   logic [4:0][dword_width_gp-1:0] data_li;
   bp_me_bedrock_register
@@ -65,7 +70,7 @@ module bp_me_manycore_bridge
      ,.r_v_o({scratchpad_r_v_li, host_cord_r_v_li, my_cord_r_v_li, dram_pod_r_v_li, dram_offset_r_v_li})
      ,.w_v_o({scratchpad_w_v_li, host_cord_w_v_li, my_cord_w_v_li, dram_pod_w_v_li, dram_offset_w_v_li})
      ,.addr_o(addr_lo)
-     ,.size_o()
+     ,.size_o(size_lo)
      ,.data_o(data_lo)
      ,.data_i(data_li)
      );
@@ -90,12 +95,39 @@ module bp_me_manycore_bridge
         host_cord_r <= host_cord_w_v_li ? data_lo : host_cord_r;
       end
 
-  // We only support 32b loads/stores currently
-  logic [data_width_p-1:0] scratchpad_data_lo;
-  wire [data_width_p-1:0] scratchpad_data_li = data_lo;
-  wire [`BSG_SAFE_CLOG2(scratchpad_els_p)-1:0] scratchpad_addr_li = (addr_lo >> `BSG_SAFE_CLOG2(data_width_p>>3));
-  bsg_mem_1rw_sync
-   #(.width_p(data_width_p), .els_p(scratchpad_els_p))
+  // The scratchpad is dword wide so that 64b accesses complete in a single
+  //   beat. Narrower stores are byte masked, and narrower loads are returned
+  //   replicated across the dword, as BedRock expects. Capacity is unchanged:
+  //   scratchpad_els_p is still counted in data_width_p words.
+  localparam scratchpad_dword_els_lp = (scratchpad_els_p*data_width_p) / dword_width_gp;
+
+  wire [sel_width_lp-1:0] scratchpad_sel_li = addr_lo[0+:sel_width_lp];
+  wire [size_width_lp-1:0] scratchpad_size_li = size_lo;
+
+  logic [dword_width_gp-1:0] scratchpad_data_li;
+  bsg_bus_pack
+   #(.in_width_p(dword_width_gp), .out_width_p(dword_width_gp))
+   scratchpad_w_pack
+    (.data_i(data_lo)
+     ,.sel_i('0)
+     ,.size_i(scratchpad_size_li)
+     ,.data_o(scratchpad_data_li)
+     );
+
+  logic [(dword_width_gp>>3)-1:0] scratchpad_mask_li;
+  always_comb
+    case (scratchpad_size_li)
+      e_bedrock_msg_size_1: scratchpad_mask_li = 8'h01 << scratchpad_sel_li;
+      e_bedrock_msg_size_2: scratchpad_mask_li = 8'h03 << scratchpad_sel_li;
+      e_bedrock_msg_size_4: scratchpad_mask_li = 8'h0f << scratchpad_sel_li;
+      // e_bedrock_msg_size_8:
+      default:              scratchpad_mask_li = 8'hff;
+    endcase
+
+  logic [dword_width_gp-1:0] scratchpad_data_lo;
+  wire [`BSG_SAFE_CLOG2(scratchpad_dword_els_lp)-1:0] scratchpad_addr_li = (addr_lo >> sel_width_lp);
+  bsg_mem_1rw_sync_mask_write_byte
+   #(.data_width_p(dword_width_gp), .els_p(scratchpad_dword_els_lp))
    scratchpad
     (.clk_i(clk_i)
      ,.reset_i(reset_i)
@@ -104,15 +136,37 @@ module bp_me_manycore_bridge
      ,.w_i(scratchpad_w_v_li)
      ,.data_i(scratchpad_data_li)
      ,.addr_i(scratchpad_addr_li)
+     ,.write_mask_i(scratchpad_mask_li)
 
      ,.data_o(scratchpad_data_lo)
      );
 
+  logic [sel_width_lp-1:0] scratchpad_sel_r;
+  logic [size_width_lp-1:0] scratchpad_size_r;
+  bsg_dff_en
+   #(.width_p(sel_width_lp+size_width_lp))
+   scratchpad_read_reg
+    (.clk_i(clk_i)
+     ,.en_i(scratchpad_r_v_li)
+     ,.data_i({scratchpad_sel_li, scratchpad_size_li})
+     ,.data_o({scratchpad_sel_r, scratchpad_size_r})
+     );
+
+  logic [dword_width_gp-1:0] scratchpad_rdata_lo;
+  bsg_bus_pack
+   #(.in_width_p(dword_width_gp), .out_width_p(dword_width_gp))
+   scratchpad_r_pack
+    (.data_i(scratchpad_data_lo)
+     ,.sel_i(scratchpad_sel_r)
+     ,.size_i(scratchpad_size_r)
+     ,.data_o(scratchpad_rdata_lo)
+     );
+
   assign data_li[0] = dram_offset_r;
   assign data_li[1] = dram_pod_r;
   assign data_li[2] = my_cord_r;
   assign data_li[3] = host_cord_r;
-  assign data_li[4] = scratchpad_data_lo;
+  assign data_li[4] = scratchpad_rdata_lo;
 
   assign dram_offset_o = dram_offset_r;
   assign dram_pod_o = dram_pod_r;
@@ -26,6 +26,8 @@ module bp_me_manycore_dram
    , parameter `BSG_INV_PARAM(ipoly_hashing_p)
 
    , parameter `BSG_INV_PARAM(outstanding_words_p)
+   // Lines fetched ahead of the last BP read, 0 to disable prefetching
+   , parameter prefetch_lines_p = 0
 
    , localparam pod_cord_width_lp = pod_x_cord_width_p+pod_y_cord_width_p
    , localparam mc_link_sif_width_lp =
@@ -51,6 +53,8 @@ module bp_me_manycore_dram
    , input [y_cord_width_p-1:0]                 global_y_i
    , input [pod_cord_width_lp-1:0]              dram_pod_i
    , input [addr_width_p-1:0]                   dram_offset_i
+   // Drops every buffered line, whenever the manycore may have written DRAM
+   , input                                      lb_inval_i
    );
 
   `declare_bp_bedrock_if(paddr_width_p, lce_id_width_p, cce_id_width_p, did_width_p, lce_assoc_p);
@@ -193,12 +197,90 @@ module bp_me_manycore_dram
   assign return_packet_v_li = '0;
   assign return_packet_li = '0;
 
+  // Line buffer
+  //
+  // BP DRAM traffic is mostly sequential (fills, boot, page zeroing), so after
+  //   each read of a line, the prefetcher requests the next prefetch_lines_p
+  //   lines into a small line buffer, one more entry than that so that the line
+  //   being read is not the one replaced. Reads that find their line in the
+  //   buffer are answered from it, once any demand responses ahead of them have
+  //   been returned; reads to a line still being fetched wait for it. A line
+  //   is dropped once a read has been answered from it, on BP writes to it and
+  //   on lb_inval_i. Manycore writes to DRAM go straight to the vcaches and are
+  //   never seen here, so the tile raises lb_inval_i on every exchange with the
+  //   manycore that could order them before a later BP read. Lines already in
+  //   flight then still fill, but can no longer hit.
+  //
+  // The stream stops at the end of the vcache row block holding the read, as
+  //   the next block belongs to the other DRAM link, or lies past the end of
+  //   BP's DRAM region.
+  localparam line_words_lp = l2_block_width_p / word_width_gp;
+  localparam lg_line_words_lp = `BSG_SAFE_CLOG2(line_words_lp);
+  localparam line_offset_width_lp = `BSG_SAFE_CLOG2(l2_block_width_p>>3);
+  localparam line_addr_width_lp = paddr_width_p - line_offset_width_lp;
+  localparam lb_els_lp = prefetch_lines_p + 1;
+  localparam lg_lb_els_lp = `BSG_SAFE_CLOG2(lb_els_lp);
+  localparam lb_addr_width_lp = `BSG_SAFE_CLOG2(lb_els_lp*line_words_lp);
+  localparam row_offset_width_lp = 2+`BSG_SAFE_CLOG2(vcache_block_size_in_words_p*num_tiles_x_p);
+  localparam row_lines_width_lp =
+    (row_offset_width_lp > line_offset_width_lp) ? row_offset_width_lp - line_offset_width_lp : 0;
+
+  wire fwd_is_wr = (fsm_fwd_header_li.msg_type == e_bedrock_mem_wr);
+  wire fwd_is_rd = (fsm_fwd_header_li.msg_type == e_bedrock_mem_rd);
+  wire [line_addr_width_lp-1:0] fwd_line_li = fsm_fwd_addr_li[line_offset_width_lp+:line_addr_width_lp];
+  wire [lg_line_words_lp-1:0] fwd_word_li = fsm_fwd_addr_li[2+:lg_line_words_lp];
+
+  logic [lb_els_lp-1:0][line_addr_width_lp-1:0] lb_tag_r;
+  logic [lb_els_lp-1:0] lb_tag_v_r, lb_busy_r;
+
+  logic [lb_els_lp-1:0] lb_match;
+  for (genvar i = 0; i < lb_els_lp; i++)
+    begin : match
+      assign lb_match[i] = lb_tag_v_r[i] & (lb_tag_r[i] == fwd_line_li);
+    end
+  wire lb_hit_v = |(lb_match & ~lb_busy_r);
+  wire lb_wait = |(lb_match & lb_busy_r);
+  logic [lg_lb_els_lp-1:0] lb_hit_entry;
+  bsg_encode_one_hot
+   #(.width_p(lb_els_lp))
+   hit_encode
+    (.i(lb_match & ~lb_busy_r)
+     ,.addr_o(lb_hit_entry)
+     ,.v_o()
+     );
+
+  // Prefetcher: pf_next_r and pf_remaining_r are the lines still to request,
+  //   pf_line_r is the line being requested word by word into pf_entry_r
+  logic pf_active_r;
+  logic [lg_lb_els_lp-1:0] pf_entry_r, pf_alloc_r;
+  logic [line_addr_width_lp-1:0] pf_line_r, pf_next_r;
+  logic [lg_line_words_lp-1:0] pf_word_r;
+  logic [`BSG_SAFE_CLOG2(prefetch_lines_p+1)-1:0] pf_remaining_r;
+
+  logic [lb_els_lp-1:0] pf_next_match;
+  for (genvar i = 0; i < lb_els_lp; i++)
+    begin : pf_match
+      assign pf_next_match[i] = lb_tag_v_r[i] & (lb_tag_r[i] == pf_next_r);
+    end
+  // pf_next_r wraps to the start of a row block when it leaves the last one
+  wire pf_in_row = (row_lines_width_lp != 0)
+    & (pf_next_r[0+:`BSG_MAX(row_lines_width_lp, 1)] != '0);
+  wire pf_pending = ~pf_active_r & (pf_remaining_r != '0) & pf_in_row;
+  wire pf_skip    = pf_pending & |pf_next_match;
+  wire pf_start   = pf_pending & ~|pf_next_match & ~lb_busy_r[pf_alloc_r];
+
+  // Demand requests go first; the prefetcher uses the cycles they leave
+  logic demand_v_li, demand_yumi_li, hit_v_li, pf_v_li, pf_yumi_li;
+  logic [`BSG_WIDTH(outstanding_words_p)-1:0] demand_cnt_lo;
+  wire [paddr_width_p-1:0] pf_addr_li = {pf_line_r, pf_word_r, 2'b00};
+  wire [paddr_width_p-1:0] req_addr_li = demand_v_li ? fsm_fwd_addr_li : pf_addr_li;
+
   // DRAM hash function
   logic [x_cord_width_p-1:0] dram_x_cord_lo;
   logic [y_cord_width_p-1:0] dram_y_cord_lo;
   logic [addr_width_p-1:0] dram_epa_lo;
 
-  wire [data_width_p-2:0] dram_addr_li = fsm_fwd_addr_li + dram_offset_i;
+  wire [data_width_p-2:0] dram_addr_li = req_addr_li + dram_offset_i;
   wire [data_width_p-1:0] dram_eva_li  = {1'b1, dram_addr_li};
   wire [pod_y_cord_width_p-1:0] dram_pod_y_li = dram_pod_i[0+:pod_y_cord_width_p];
   wire [pod_x_cord_width_p-1:0] dram_pod_x_li = dram_pod_i[pod_y_cord_width_p+:pod_x_cord_width_p];
@@ -276,37 +358,152 @@ module bp_me_manycore_dram
      ,.r_data_o(dram_rev_header_lo)
      );
 
+  // Which requests were prefetches, and where their data goes
+  logic rev_is_pf_lo;
+  logic [lg_lb_els_lp-1:0] rev_pf_entry_lo;
+  logic [lg_line_words_lp-1:0] rev_pf_word_lo;
+  bsg_mem_1r1w
+   #(.width_p(1+lg_lb_els_lp+lg_line_words_lp), .els_p(outstanding_words_p))
+   return_pf
+    (.w_clk_i(clk_i)
+     ,.w_reset_i(reset_i)
+
+     ,.w_v_i(trans_id_yumi_li)
+     ,.w_addr_i(trans_id_lo)
+     ,.w_data_i({pf_yumi_li, pf_entry_r, pf_word_r})
+
+     ,.r_v_i(dram_rev_v_lo)
+     ,.r_addr_i(dram_rev_id_lo)
+     ,.r_data_o({rev_is_pf_lo, rev_pf_entry_lo, rev_pf_word_lo})
+     );
+
+  wire lb_w_v_li = dram_rev_v_lo & rev_is_pf_lo;
+  logic [word_width_gp-1:0] lb_data_lo;
+  bsg_mem_1r1w
+   #(.width_p(word_width_gp), .els_p(lb_els_lp*line_words_lp))
+   lb_data
+    (.w_clk_i(clk_i)
+     ,.w_reset_i(reset_i)
+
+     ,.w_v_i(lb_w_v_li)
+     ,.w_addr_i(lb_addr_width_lp'({rev_pf_entry_lo, rev_pf_word_lo}))
+     ,.w_data_i(dram_rev_data_lo)
+
+     ,.r_v_i(hit_v_li)
+     ,.r_addr_i(lb_addr_width_lp'({lb_hit_entry, fwd_word_li}))
+     ,.r_data_o(lb_data_lo)
+     );
+
   //////////////////////////////////////////////
   // Outgoing Request
   //////////////////////////////////////////////
   always_comb
     begin
-      fsm_fwd_yumi_lo = fsm_fwd_v_li & trans_id_v_lo & packet_ready_lo;
-      trans_id_yumi_li = fsm_fwd_yumi_lo;
+      // Hits are answered in order with the demand responses
+      hit_v_li = fsm_fwd_v_li & fwd_is_rd & lb_hit_v & (demand_cnt_lo == '0) & fsm_rev_ready_then_li;
+      demand_v_li = fsm_fwd_v_li & (~fwd_is_rd | (~lb_hit_v & ~lb_wait));
+      demand_yumi_li = demand_v_li & trans_id_v_lo & packet_ready_lo;
+      pf_v_li = pf_active_r & ~demand_v_li;
+      pf_yumi_li = pf_v_li & trans_id_v_lo & packet_ready_lo;
+
+      fsm_fwd_yumi_lo = demand_yumi_li | hit_v_li;
+      trans_id_yumi_li = demand_yumi_li | pf_yumi_li;
       packet_v_li = trans_id_yumi_li;
 
       packet_li = '0;
-      packet_li.op_v2        = (fsm_fwd_header_li.msg_type inside {e_bedrock_mem_wr}) ? e_remote_sw : e_remote_load;
+      packet_li.op_v2        = (demand_v_li & fwd_is_wr) ? e_remote_sw : e_remote_load;
       packet_li.src_y_cord   = global_y_i;
       packet_li.src_x_cord   = global_x_i;
       packet_li.addr         = dram_epa_lo;
       packet_li.y_cord       = dram_y_cord_lo;
       packet_li.x_cord       = dram_x_cord_lo;
-      packet_li.payload.data = fsm_fwd_data_li;
+      packet_li.payload.data = (demand_v_li & fwd_is_wr) ? fsm_fwd_data_li : '0;
       packet_li.reg_id       = bsg_manycore_reg_id_width_gp'(trans_id_lo);
 
       // We can always ack mmio requests, because we've allocated space in the reorder fifo
       return_packet_yumi_li = return_packet_v_lo;
       dram_returned_v_li = return_packet_yumi_li;
 
-      // Send out mmio response opportunistically
-      fsm_rev_header_lo = dram_rev_header_lo;
-      fsm_rev_data_lo = dram_rev_data_lo;
-      fsm_rev_v_lo = fsm_rev_ready_then_li & dram_rev_v_lo;
-      dram_rev_yumi_li = fsm_rev_v_lo;
+      // Send out mmio response opportunistically; prefetched words go to the line buffer
+      fsm_rev_header_lo = hit_v_li ? fsm_fwd_header_li : dram_rev_header_lo;
+      fsm_rev_data_lo = hit_v_li ? lb_data_lo : dram_rev_data_lo;
+      fsm_rev_v_lo = hit_v_li | (fsm_rev_ready_then_li & dram_rev_v_lo & ~rev_is_pf_lo);
+      dram_rev_yumi_li = lb_w_v_li | (fsm_rev_v_lo & ~hit_v_li);
     end
 
+  wire demand_return_li = dram_rev_yumi_li & ~rev_is_pf_lo;
+  bsg_counter_up_down
+   #(.max_val_p(outstanding_words_p), .init_val_p(0), .max_step_p(1))
+   demand_counter
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.up_i(demand_yumi_li)
+     ,.down_i(demand_return_li)
+
+     ,.count_o(demand_cnt_lo)
+     );
+
+  wire demand_rd_start = demand_yumi_li & fwd_is_rd & fsm_fwd_new_lo;
+  wire hit_start = hit_v_li & fsm_fwd_new_lo;
+  wire pf_done = pf_yumi_li & (pf_word_r == lg_line_words_lp'(line_words_lp-1));
+  wire lb_fill_done = lb_w_v_li & (rev_pf_word_lo == lg_line_words_lp'(line_words_lp-1));
+  always_ff @(posedge clk_i)
+    if (reset_i)
+      begin
+        lb_tag_v_r <= '0;
+        lb_busy_r <= '0;
+        pf_active_r <= 1'b0;
+        pf_alloc_r <= '0;
+        pf_word_r <= '0;
+        pf_remaining_r <= '0;
+      end
+    else
+      begin
+        for (integer i = 0; i < lb_els_lp; i++)
+          begin
+            if (pf_start & (pf_alloc_r == i))
+              begin
+                lb_tag_r[i] <= pf_next_r;
+                lb_tag_v_r[i] <= 1'b1;
+                lb_busy_r[i] <= 1'b1;
+              end
+            if (lb_fill_done & (rev_pf_entry_lo == i))
+              lb_busy_r[i] <= 1'b0;
+            if (demand_yumi_li & fwd_is_wr & lb_match[i])
+              lb_tag_v_r[i] <= 1'b0;
+            if (hit_v_li & fsm_fwd_last_lo & (lb_hit_entry == i))
+              lb_tag_v_r[i] <= 1'b0;
+            if (lb_inval_i)
+              lb_tag_v_r[i] <= 1'b0;
+          end
+
+        if (pf_start)
+          begin
+            pf_active_r <= 1'b1;
+            pf_entry_r <= pf_alloc_r;
+            pf_line_r <= pf_next_r;
+            pf_alloc_r <= (pf_alloc_r == lg_lb_els_lp'(lb_els_lp-1)) ? '0 : pf_alloc_r + 1'b1;
+          end
+        else if (pf_done)
+          pf_active_r <= 1'b0;
+
+        if (pf_yumi_li)
+          pf_word_r <= pf_word_r + 1'b1;
+
+        // Every read restarts the stream just past its line
+        if (demand_rd_start | hit_start)
+          begin
+            pf_next_r <= fwd_line_li + 1'b1;
+            pf_remaining_r <= prefetch_lines_p;
+          end
+        else if (pf_skip | pf_start)
+          begin
+            pf_next_r <= pf_next_r + 1'b1;
+            pf_remaining_r <= pf_remaining_r - 1'b1;
+          end
+      end
+
 endmodule
 
 `BSG_ABSTRACT_MODULE(bp_me_manycore_dram)
-
@@ -25,6 +25,11 @@ module bp_me_manycore_mmio
    , localparam y_subcord_width_lp = `BSG_SAFE_CLOG2(num_tiles_y_p)
 
    , parameter `BSG_INV_PARAM(outstanding_words_p)
+   , parameter endpoint_fifo_els_p = 4
+   // Combine subword stores to vcache (DRAM) words before they are sent
+   , parameter write_combine_p = 0
+   // Cycles a combined store waits for another store to the same word
+   , parameter merge_timeout_p = 4
 
    , localparam mc_link_sif_width_lp =
        `bsg_manycore_link_sif_width(addr_width_p, data_width_p, x_cord_width_p, y_cord_width_p)
@@ -71,6 +76,71 @@ module bp_me_manycore_mmio
   `bp_cast_o(bp_bedrock_mem_fwd_header_s, mem_fwd_header);
   `bp_cast_i(bp_bedrock_mem_rev_header_s, mem_rev_header);
 
+  // 64b and block accesses are split into a train of data_width_p words, one
+  //   manycore packet each. The responses come back through the reorder fifo
+  //   in request order and are reassembled into a single BedRock response.
+  bp_bedrock_mem_fwd_header_s fsm_fwd_header_li;
+  logic [data_width_p-1:0] fsm_fwd_data_li;
+  logic fsm_fwd_v_li, fsm_fwd_yumi_lo;
+  logic [paddr_width_p-1:0] fsm_fwd_addr_li;
+  logic fsm_fwd_new_lo, fsm_fwd_critical_lo, fsm_fwd_last_lo;
+  bp_me_stream_pump_in
+   #(.bp_params_p(bp_params_p)
+     ,.data_width_p(data_width_p)
+     ,.payload_width_p(mem_fwd_payload_width_lp)
+     ,.msg_stream_mask_p(mem_fwd_stream_mask_gp)
+     ,.fsm_stream_mask_p(mem_fwd_stream_mask_gp | mem_rev_stream_mask_gp)
+     )
+   mmio_pump_in
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.msg_header_i(mem_fwd_header_cast_i)
+     ,.msg_data_i(mem_fwd_data_i)
+     ,.msg_v_i(mem_fwd_v_i)
+     ,.msg_ready_and_o(mem_fwd_ready_and_o)
+
+     ,.fsm_header_o(fsm_fwd_header_li)
+     ,.fsm_data_o(fsm_fwd_data_li)
+     ,.fsm_v_o(fsm_fwd_v_li)
+     ,.fsm_yumi_i(fsm_fwd_yumi_lo)
+     ,.fsm_addr_o(fsm_fwd_addr_li)
+     ,.fsm_new_o(fsm_fwd_new_lo)
+     ,.fsm_critical_o(fsm_fwd_critical_lo)
+     ,.fsm_last_o(fsm_fwd_last_lo)
+     );
+
+  bp_bedrock_mem_rev_header_s fsm_rev_header_lo;
+  logic [data_width_p-1:0] fsm_rev_data_lo;
+  logic fsm_rev_v_lo, fsm_rev_ready_then_li;
+  logic [paddr_width_p-1:0] fsm_rev_addr_lo;
+  logic fsm_rev_new_lo, fsm_rev_critical_lo, fsm_rev_last_lo;
+  bp_me_stream_pump_out
+   #(.bp_params_p(bp_params_p)
+     ,.data_width_p(data_width_p)
+     ,.payload_width_p(mem_rev_payload_width_lp)
+     ,.msg_stream_mask_p(mem_rev_stream_mask_gp)
+     ,.fsm_stream_mask_p(mem_fwd_stream_mask_gp | mem_rev_stream_mask_gp)
+     )
+   mmio_pump_out
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.msg_header_o(mem_rev_header_cast_o)
+     ,.msg_data_o(mem_rev_data_o)
+     ,.msg_v_o(mem_rev_v_o)
+     ,.msg_ready_and_i(mem_rev_ready_and_i)
+
+     ,.fsm_header_i(fsm_rev_header_lo)
+     ,.fsm_data_i(fsm_rev_data_lo)
+     ,.fsm_v_i(fsm_rev_v_lo)
+     ,.fsm_ready_then_o(fsm_rev_ready_then_li)
+     ,.fsm_addr_o(fsm_rev_addr_lo)
+     ,.fsm_new_o(fsm_rev_new_lo)
+     ,.fsm_critical_o(fsm_rev_critical_lo)
+     ,.fsm_last_o(fsm_rev_last_lo)
+     );
+
   bsg_manycore_packet_s                    packet_lo;
   logic                                    packet_v_lo;
   logic                                    packet_yumi_li;
@@ -87,11 +157,12 @@ module bp_me_manycore_mmio
   logic                                    return_packet_yumi_li;
   logic                                    return_packet_fifo_full_lo;
 
-  logic [5:0]                              out_credits_used_lo;
+  logic [`BSG_WIDTH(outstanding_words_p)-1:0] out_credits_used_lo;
   bsg_manycore_endpoint_fc
    #(.x_cord_width_p(x_cord_width_p)
      ,.y_cord_width_p(y_cord_width_p)
-     ,.fifo_els_p(4)
+     ,.fifo_els_p(endpoint_fifo_els_p)
+     ,.credit_counter_width_p(`BSG_WIDTH(outstanding_words_p))
      ,.data_width_p(data_width_p)
      ,.addr_width_p(addr_width_p)
      ,.icache_block_size_in_words_p(icache_block_size_in_words_p)
@@ -136,36 +207,36 @@ module bp_me_manycore_mmio
 
   // Other MMIO
   localparam tile_addr_width_lp = 18;
-  wire [addr_width_p-1:0]      mmio_tile_epa_lo = mem_fwd_header_cast_i.addr[2+:tile_addr_width_lp-2];
-  wire [x_cord_width_p-1:0] mmio_tile_x_cord_lo = mem_fwd_header_cast_i.addr[tile_addr_width_lp+:x_cord_width_p];
-  wire [y_cord_width_p-1:0] mmio_tile_y_cord_lo = mem_fwd_header_cast_i.addr[tile_addr_width_lp+x_cord_width_p+:y_cord_width_p];
+  wire [addr_width_p-1:0]      mmio_tile_epa_lo = fsm_fwd_addr_li[2+:tile_addr_width_lp-2];
+  wire [x_cord_width_p-1:0] mmio_tile_x_cord_lo = fsm_fwd_addr_li[tile_addr_width_lp+:x_cord_width_p];
+  wire [y_cord_width_p-1:0] mmio_tile_y_cord_lo = fsm_fwd_addr_li[tile_addr_width_lp+x_cord_width_p+:y_cord_width_p];
 
   localparam vcache_addr_width_lp = 29;
-  wire [vcache_addr_width_lp-1:0] mmio_vcache_epa_lo     = mem_fwd_header_cast_i.addr[2+:vcache_addr_width_lp-2];
-  wire [x_cord_width_p-1:0]    mmio_vcache_x_cord_lo     = mem_fwd_header_cast_i.addr[vcache_addr_width_lp+:x_cord_width_p];
+  wire [vcache_addr_width_lp-1:0] mmio_vcache_epa_lo     = fsm_fwd_addr_li[2+:vcache_addr_width_lp-2];
+  wire [x_cord_width_p-1:0]    mmio_vcache_x_cord_lo     = fsm_fwd_addr_li[vcache_addr_width_lp+:x_cord_width_p];
   // If we have extra address space it goes to y_pod. Additionally, we drop the low bit because all vcache pods are even
-  wire [pod_y_cord_width_p-1:0] mmio_vcache_y_pod_lo     = (mem_fwd_header_cast_i.addr[paddr_width_p-2:vcache_addr_width_lp+x_cord_width_p] << 1);
+  wire [pod_y_cord_width_p-1:0] mmio_vcache_y_pod_lo     = (fsm_fwd_addr_li[paddr_width_p-2:vcache_addr_width_lp+x_cord_width_p] << 1);
   wire [y_subcord_width_lp-1:0] mmio_vcache_y_subcord_lo = (mmio_vcache_y_pod_lo[1] == '0) ? '1 : '0;
   wire [y_cord_width_p-1:0] mmio_vcache_y_cord_lo        = {mmio_vcache_y_pod_lo, mmio_vcache_y_subcord_lo};
 
-  wire [addr_width_p-1:0] host_epa_lo = mem_fwd_header_cast_i.addr[2+:addr_width_p];
+  wire [addr_width_p-1:0] host_epa_lo = fsm_fwd_addr_li[2+:addr_width_p];
 
   logic [(data_width_p>>3)-1:0] store_mask;
   always_comb
-    case (mem_fwd_header_cast_i.size)
-       e_bedrock_msg_size_1: store_mask = 4'h1 << mem_fwd_header_cast_i.addr[0+:2];
-       e_bedrock_msg_size_2: store_mask = 4'h3 << mem_fwd_header_cast_i.addr[0+:2];
-       // e_bedrock_msg_size_4:
-       default:              store_mask = 4'hf << mem_fwd_header_cast_i.addr[0+:2];
+    case (fsm_fwd_header_li.size)
+       e_bedrock_msg_size_1: store_mask = 4'h1 << fsm_fwd_addr_li[0+:2];
+       e_bedrock_msg_size_2: store_mask = 4'h3 << fsm_fwd_addr_li[0+:2];
+       // >= e_bedrock_msg_size_4, each word of the train is a full store
+       default:              store_mask = 4'hf;
     endcase
 
   localparam trans_id_width_lp = `BSG_SAFE_CLOG2(outstanding_words_p);
-  logic [trans_id_width_lp-1:0] trans_id_lo;
+  logic [trans_id_width_lp-1:0] trans_id_lo, wcb_id_r;
   logic trans_id_v_lo, trans_id_yumi_li;
   logic [data_width_p-1:0] mmio_rev_data_lo;
   logic [trans_id_width_lp-1:0] mmio_rev_id_lo;
   logic mmio_rev_v_lo, mmio_rev_yumi_li;
-  logic mmio_returned_v_li;
+  logic mmio_returned_v_li, mmio_merged_v_li;
 
   wire [bsg_manycore_reg_id_width_gp-1:0] mmio_returned_reg_id_li = return_packet_lo.reg_id;
   wire [data_width_p-1:0] mmio_returned_data_li = return_packet_lo.data;
@@ -182,9 +253,11 @@ module bp_me_manycore_mmio
      // We write an entry on credit return in order to determine when to send
      //   back a store response.  A little inefficent, but allocating storage for
      //   worst case (all loads) isn't unreasonable
-     ,.write_id_i(mmio_returned_reg_id_li[0+:trans_id_width_lp])
+     //   Stores absorbed into the write-combining buffer are completed here
+     //   directly, as their data is carried by a later store
+     ,.write_id_i(mmio_merged_v_li ? wcb_id_r : mmio_returned_reg_id_li[0+:trans_id_width_lp])
      ,.write_data_i(mmio_returned_data_li)
-     ,.write_v_i(mmio_returned_v_li)
+     ,.write_v_i(mmio_merged_v_li | mmio_returned_v_li)
 
      ,.fifo_deq_data_o(mmio_rev_data_lo)
      ,.fifo_deq_id_o(mmio_rev_id_lo)
@@ -196,27 +269,45 @@ module bp_me_manycore_mmio
 
   bp_bedrock_mem_rev_header_s mmio_rev_header_lo;
   bsg_mem_1r1w
-   #(.width_p($bits(mem_fwd_header_i)), .els_p(outstanding_words_p))
+   #(.width_p($bits(fsm_fwd_header_li)), .els_p(outstanding_words_p))
    return_headers
     (.w_clk_i(clk_i)
      ,.w_reset_i(reset_i)
 
      ,.w_v_i(trans_id_yumi_li)
      ,.w_addr_i(trans_id_lo)
-     ,.w_data_i(mem_fwd_header_i)
+     ,.w_data_i(fsm_fwd_header_li)
 
      ,.r_v_i(mmio_rev_yumi_li)
      ,.r_addr_i(mmio_rev_id_lo)
      ,.r_data_o(mmio_rev_header_lo)
      );
 
-  logic [data_width_p-1:0] store_payload;
-  logic [bsg_manycore_reg_id_width_gp-1:0] store_reg_id;
-  bsg_manycore_packet_op_e store_op;
+  // Write-combining buffer
+  //
+  // With write_combine_p set, stores to vcache (DRAM) words wait here for up
+  //   to merge_timeout_p idle cycles. Further stores to disjoint bytes of the
+  //   same word are merged into it, so that byte and halfword marshalling of
+  //   arguments costs one packet per word. The buffered store is sent as soon
+  //   as anything else needs the link: a store to another word or to bytes
+  //   already buffered (sent in the same cycle the new store is buffered), a
+  //   load, an AMO or a store that is not combined.
+  // Stores to the host or to tiles may have side effects and are never held
+  //   or merged; they are sent directly, as are all stores by default.
+  logic wcb_v_r;
+  logic [paddr_width_p-3:0] wcb_word_r;
+  logic [data_width_p-1:0] wcb_data_r;
+  logic [(data_width_p>>3)-1:0] wcb_mask_r;
+  bsg_manycore_packet_s wcb_dest_r;
+  logic [`BSG_WIDTH(merge_timeout_p)-1:0] wcb_idle_r;
+
+  logic [data_width_p-1:0] store_payload, wcb_payload;
+  logic [bsg_manycore_reg_id_width_gp-1:0] store_reg_id, wcb_reg_id;
+  bsg_manycore_packet_op_e store_op, wcb_op;
   bsg_manycore_reg_id_encode
    #(.data_width_p(data_width_p))
    reg_id_encode
-    (.data_i(mem_fwd_data_i[0+:word_width_gp])
+    (.data_i(fsm_fwd_data_li)
      ,.mask_i(store_mask)
      ,.reg_id_i(bsg_manycore_reg_id_width_gp'(trans_id_lo))
 
@@ -225,88 +316,166 @@ module bp_me_manycore_mmio
      ,.op_o(store_op)
      );
 
+  bsg_manycore_reg_id_encode
+   #(.data_width_p(data_width_p))
+   wcb_reg_id_encode
+    (.data_i(wcb_data_r)
+     ,.mask_i(wcb_mask_r)
+     ,.reg_id_i(bsg_manycore_reg_id_width_gp'(wcb_id_r))
+
+     ,.data_o(wcb_payload)
+     ,.reg_id_o(wcb_reg_id)
+     ,.op_o(wcb_op)
+     );
+
   //////////////////////////////////////////////
   // Outgoing Request
   //////////////////////////////////////////////
-  wire is_mc_compute_tile_li = mem_fwd_v_i & mem_fwd_header_cast_i.addr[paddr_width_p-1-:2] == 2'b11;
-  wire is_mc_vcache_tile_li  = mem_fwd_v_i & mem_fwd_header_cast_i.addr[paddr_width_p-1-:2] == 2'b10;
-
+  wire is_mc_compute_tile_li = fsm_fwd_v_li & fsm_fwd_addr_li[paddr_width_p-1-:2] == 2'b11;
+  wire is_mc_vcache_tile_li  = fsm_fwd_v_li & fsm_fwd_addr_li[paddr_width_p-1-:2] == 2'b10;
+
+  bsg_manycore_packet_s fwd_packet_li, wcb_packet_li;
+  logic fwd_merge_li, fwd_capture_li, fwd_send_li, wcb_send_li;
+  wire fwd_is_store_li = ~(fsm_fwd_header_li.msg_type inside {e_bedrock_mem_rd, e_bedrock_mem_amo});
+  wire fwd_combine_li = (write_combine_p != 0) & fwd_is_store_li & is_mc_vcache_tile_li;
+  wire [paddr_width_p-3:0] fwd_word_li = fsm_fwd_addr_li[paddr_width_p-1:2];
   always_comb
     begin
-      mem_fwd_ready_and_o = trans_id_v_lo & packet_ready_lo;
-      trans_id_yumi_li = mem_fwd_ready_and_o & mem_fwd_v_i;
-      packet_v_li = trans_id_yumi_li;
-
-      packet_li = '0;
-      packet_li.src_y_cord = global_y_i;
-      packet_li.src_x_cord = global_x_i;
+      fwd_packet_li = '0;
+      fwd_packet_li.src_y_cord = global_y_i;
+      fwd_packet_li.src_x_cord = global_x_i;
       if (is_mc_compute_tile_li)
         begin
-          packet_li.addr   = mmio_tile_epa_lo;
-          packet_li.y_cord = mmio_tile_y_cord_lo;
-          packet_li.x_cord = mmio_tile_x_cord_lo;
+          fwd_packet_li.addr   = mmio_tile_epa_lo;
+          fwd_packet_li.y_cord = mmio_tile_y_cord_lo;
+          fwd_packet_li.x_cord = mmio_tile_x_cord_lo;
         end
       else if (is_mc_vcache_tile_li)
         begin
-          packet_li.addr   = mmio_vcache_epa_lo;
-          packet_li.y_cord = mmio_vcache_y_cord_lo;
-          packet_li.x_cord = mmio_vcache_x_cord_lo;
+          fwd_packet_li.addr   = mmio_vcache_epa_lo;
+          fwd_packet_li.y_cord = mmio_vcache_y_cord_lo;
+          fwd_packet_li.x_cord = mmio_vcache_x_cord_lo;
         end
       else // Send to host
         begin
-          packet_li.addr   = host_epa_lo;
-          packet_li.y_cord = host_y_i;
-          packet_li.x_cord = host_x_i;
+          fwd_packet_li.addr   = host_epa_lo;
+          fwd_packet_li.y_cord = host_y_i;
+          fwd_packet_li.x_cord = host_x_i;
         end
 
-      case (mem_fwd_header_cast_i.msg_type)
+      case (fsm_fwd_header_li.msg_type)
         e_bedrock_mem_rd:
           begin
-            packet_li.op_v2                                    = e_remote_load;
-            packet_li.payload.load_info_s.load_info.is_byte_op = (mem_fwd_header_cast_i.size == e_bedrock_msg_size_1);
-            packet_li.payload.load_info_s.load_info.is_hex_op  = (mem_fwd_header_cast_i.size == e_bedrock_msg_size_2);
-            packet_li.payload.load_info_s.load_info.part_sel   = mem_fwd_header_cast_i.addr[0+:2];
-            packet_li.reg_id                                   = bsg_manycore_reg_id_width_gp'(trans_id_lo);
+            fwd_packet_li.op_v2                                    = e_remote_load;
+            fwd_packet_li.payload.load_info_s.load_info.is_byte_op = (fsm_fwd_header_li.size == e_bedrock_msg_size_1);
+            fwd_packet_li.payload.load_info_s.load_info.is_hex_op  = (fsm_fwd_header_li.size == e_bedrock_msg_size_2);
+            fwd_packet_li.payload.load_info_s.load_info.part_sel   = fsm_fwd_addr_li[0+:2];
+            fwd_packet_li.reg_id                                   = bsg_manycore_reg_id_width_gp'(trans_id_lo);
           end
         e_bedrock_mem_amo:
           begin
-            packet_li.payload.data = mem_fwd_data_i;
-            packet_li.reg_id = bsg_manycore_reg_id_width_gp'(trans_id_lo);
-            unique case (mem_fwd_header_cast_i.subop)
-              e_bedrock_amoadd:  packet_li.op_v2               = e_remote_amoadd;
-              e_bedrock_amoor:   packet_li.op_v2               = e_remote_amoor;
-              e_bedrock_amoswap: packet_li.op_v2               = e_remote_amoswap;
-              default: packet_li.op_v2 = e_remote_amoswap; // Must never come here
+            fwd_packet_li.payload.data = fsm_fwd_data_li;
+            fwd_packet_li.reg_id = bsg_manycore_reg_id_width_gp'(trans_id_lo);
+            unique case (fsm_fwd_header_li.subop)
+              e_bedrock_amoadd:  fwd_packet_li.op_v2               = e_remote_amoadd;
+              e_bedrock_amoor:   fwd_packet_li.op_v2               = e_remote_amoor;
+              e_bedrock_amoswap: fwd_packet_li.op_v2               = e_remote_amoswap;
+              default: fwd_packet_li.op_v2 = e_remote_amoswap; // Must never come here
             endcase
           end
         default: // e_bedrock_mem_wr:
           begin
-            packet_li.op_v2                                    = store_op;
-            packet_li.payload.data                             = store_payload;
-            packet_li.reg_id                                   = store_reg_id;
+            fwd_packet_li.op_v2                                    = store_op;
+            fwd_packet_li.payload.data                             = store_payload;
+            fwd_packet_li.reg_id                                   = store_reg_id;
           end
       endcase
 
-      // We can always ack mmio requests, because we've allocated space in the reorder fifo
-      return_packet_yumi_li = return_packet_v_lo;
+      wcb_packet_li = wcb_dest_r;
+      wcb_packet_li.op_v2        = wcb_op;
+      wcb_packet_li.payload.data = wcb_payload;
+      wcb_packet_li.reg_id       = wcb_reg_id;
+
+      // A combined store merges into the buffer, or replaces it as it is sent
+      fwd_merge_li  = fwd_combine_li & wcb_v_r & (fwd_word_li == wcb_word_r)
+                      & ((store_mask & wcb_mask_r) == '0);
+      wcb_send_li   = wcb_v_r & ~fwd_merge_li
+                      & (fsm_fwd_v_li | (wcb_idle_r == merge_timeout_p)) & packet_ready_lo;
+      fwd_capture_li = fwd_combine_li & trans_id_v_lo
+                      & (fwd_merge_li | ~wcb_v_r | wcb_send_li);
+      fwd_send_li   = fsm_fwd_v_li & ~fwd_combine_li & ~wcb_v_r & trans_id_v_lo & packet_ready_lo;
+
+      fsm_fwd_yumi_lo = fwd_capture_li | fwd_send_li;
+      trans_id_yumi_li = fsm_fwd_yumi_lo;
+      packet_v_li = wcb_send_li | fwd_send_li;
+      packet_li = wcb_send_li ? wcb_packet_li : fwd_packet_li;
+
+      // We can always ack mmio requests, because we've allocated space in the reorder fifo,
+      //   unless the reorder fifo is completing a merged store this cycle
+      mmio_merged_v_li = fwd_capture_li & fwd_merge_li;
+      return_packet_yumi_li = return_packet_v_lo & ~mmio_merged_v_li;
       mmio_returned_v_li = return_packet_yumi_li;
 
-      mem_rev_v_o = mmio_rev_v_lo;
-      mem_rev_header_cast_o = mmio_rev_header_lo;
-      mmio_rev_yumi_li = mem_rev_ready_and_i & mem_rev_v_o;
+      // Send out mmio response opportunistically
+      fsm_rev_header_lo = mmio_rev_header_lo;
+      fsm_rev_v_lo = fsm_rev_ready_then_li & mmio_rev_v_lo;
+      mmio_rev_yumi_li = fsm_rev_v_lo;
     end
 
-  localparam sel_width_lp = `BSG_SAFE_CLOG2(dword_width_gp>>3);
-  localparam size_width_lp = `BSG_SAFE_CLOG2(sel_width_lp);
+  logic [data_width_p-1:0] wcb_data_n;
+  for (genvar i = 0; i < (data_width_p>>3); i++)
+    begin : merge
+      assign wcb_data_n[8*i+:8] = (store_mask[i] | ~fwd_merge_li) ? fsm_fwd_data_li[8*i+:8] : wcb_data_r[8*i+:8];
+    end
+
+  always_ff @(posedge clk_i)
+    if (reset_i)
+      begin
+        wcb_v_r <= 1'b0;
+        wcb_idle_r <= '0;
+      end
+    else
+      begin
+        if (fwd_capture_li)
+          begin
+            wcb_v_r <= 1'b1;
+            wcb_id_r <= trans_id_lo;
+            wcb_word_r <= fwd_word_li;
+            wcb_data_r <= wcb_data_n;
+            wcb_mask_r <= store_mask | (fwd_merge_li ? wcb_mask_r : '0);
+            wcb_dest_r <= fwd_packet_li;
+          end
+        else if (wcb_send_li)
+          wcb_v_r <= 1'b0;
+
+        if (fwd_capture_li | ~wcb_v_r)
+          wcb_idle_r <= '0;
+        else if (wcb_idle_r != merge_timeout_p)
+          wcb_idle_r <= wcb_idle_r + 1'b1;
+      end
+
+  // Subword loads are returned in the low bits; words of a train pass through
+  localparam sel_width_lp = `BSG_SAFE_CLOG2(data_width_p>>3);
+  localparam size_width_lp = `BSG_SAFE_CLOG2(sel_width_lp+1);
+  wire [size_width_lp-1:0] mmio_rev_size_li =
+    (mmio_rev_header_lo.size > sel_width_lp) ? size_width_lp'(sel_width_lp) : mmio_rev_header_lo.size;
   bsg_bus_pack
-   #(.in_width_p(data_width_p), .out_width_p(bedrock_fill_width_p))
+   #(.in_width_p(data_width_p), .out_width_p(data_width_p))
    fwd_bus_pack
     (.data_i(mmio_rev_data_lo)
      ,.sel_i('0) // We are aligned
-     ,.size_i(mem_rev_header_cast_o.size[0+:size_width_lp])
-     ,.data_o(mem_rev_data_o)
+     ,.size_i(mmio_rev_size_li)
+     ,.data_o(fsm_rev_data_lo)
      );
 
+  // synopsys translate_off
+  always @(negedge clk_i) begin
+    if (~reset_i & fsm_fwd_v_li & (fsm_fwd_header_li.msg_type == e_bedrock_mem_amo)) begin
+       assert (fsm_fwd_header_li.size <= e_bedrock_msg_size_4) else $error("[BSG_ERROR] Manycore network cannot perform 64b AMOs");
+    end
+  end
+  // synopsys translate_on
+
   //////////////////////////////////////////////
   // Incoming packet
   //////////////////////////////////////////////
@@ -13,6 +13,8 @@ module bsg_manycore_axil_bridge
    , parameter `BSG_INV_PARAM(m_axil_data_width_p)
    , parameter `BSG_INV_PARAM(s_axil_addr_width_p)
    , parameter `BSG_INV_PARAM(s_axil_data_width_p)
+   // Maximum AXIL-to-manycore requests in flight
+   , parameter outstanding_p = 8
 
    , localparam m_axil_mask_width_lp = m_axil_data_width_p>>3
    , localparam s_axil_mask_width_lp = s_axil_data_width_p>>3
@@ -118,7 +120,7 @@ module bsg_manycore_axil_bridge
   logic returned_yumi_li;
   logic [data_width_p-1:0] returned_data_r_lo;
   bsg_manycore_return_packet_type_e returned_pkt_type_r_lo;
-  logic [bsg_manycore_reg_id_width_gp-1:0] returned_reg_id_r_lo;
+  logic [bsg_manycore_reg_id_width_gp-1:0] returned_reg_id_r_lo, returned_credit_reg_id_r_lo;
   logic returned_fifo_full_lo;
 
   bsg_manycore_endpoint_standard
@@ -130,7 +132,7 @@ module bsg_manycore_axil_bridge
 
      // Reasonable defaults
      ,.fifo_els_p(2)
-     ,.credit_counter_width_p(2)
+     ,.credit_counter_width_p(`BSG_WIDTH(outstanding_p))
      ,.rev_fifo_els_p(2)
      ,.use_credits_for_local_fifo_p(1)
      )
@@ -165,6 +167,7 @@ module bsg_manycore_axil_bridge
      ,.returned_credit_v_r_o(returned_credit_v_r_lo)
      ,.returned_data_r_o(returned_data_r_lo)
      ,.returned_reg_id_r_o(returned_reg_id_r_lo)
+     ,.returned_credit_reg_id_r_o(returned_credit_reg_id_r_lo)
      ,.returned_pkt_type_r_o(returned_pkt_type_r_lo)
      ,.returned_fifo_full_o(returned_fifo_full_lo)
      ,.returned_yumi_i(returned_yumi_li)
@@ -172,7 +175,6 @@ module bsg_manycore_axil_bridge
      /* Unused */
      ,.in_src_x_cord_o()
      ,.in_src_y_cord_o()
-     ,.returned_credit_reg_id_r_o()
      ,.out_credits_used_o()
      );
 
@@ -187,6 +189,7 @@ module bsg_manycore_axil_bridge
   bsg_axil_fifo_client
    #(.axil_data_width_p(s_axil_data_width_p)
      ,.axil_addr_width_p(s_axil_addr_width_p)
+     ,.outstanding_p(outstanding_p)
      )
    axil_client
     (.clk_i(clk_i)
@@ -206,6 +209,47 @@ module bsg_manycore_axil_bridge
      ,.*
      );
 
+  // Requests are tagged with a transaction id in reg_id, and the responses are
+  //   put back in request order by a reorder fifo. Stores with an irregular
+  //   mask carry the mask in reg_id instead, so they are sent alone, once
+  //   every earlier response has gone back over AXIL.
+  localparam trans_id_width_lp = `BSG_SAFE_CLOG2(outstanding_p);
+  logic [trans_id_width_lp-1:0] trans_id_lo, masked_id_r;
+  logic trans_id_v_lo, trans_id_yumi_li;
+  logic masked_v_r, rob_empty_lo;
+
+  if (trans_id_width_lp > bsg_manycore_reg_id_width_gp)
+    $error("outstanding_p exceeds the ids reg_id can carry");
+
+  wire returned_any_v_li = returned_v_r_lo | returned_credit_v_r_lo;
+  wire [bsg_manycore_reg_id_width_gp-1:0] returned_any_reg_id_li =
+    returned_v_r_lo ? returned_reg_id_r_lo : returned_credit_reg_id_r_lo;
+  bsg_fifo_reorder
+   #(.width_p(data_width_p), .els_p(outstanding_p))
+   rob
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.fifo_alloc_id_o(trans_id_lo)
+     ,.fifo_alloc_v_o(trans_id_v_lo)
+     ,.fifo_alloc_yumi_i(trans_id_yumi_li)
+
+     // Store credits are written too, to keep write responses in order
+     ,.write_id_i(masked_v_r ? masked_id_r : returned_any_reg_id_li[0+:trans_id_width_lp])
+     ,.write_data_i(returned_data_r_lo)
+     ,.write_v_i(returned_any_v_li)
+
+     ,.fifo_deq_data_o(c_rdata_li)
+     ,.fifo_deq_id_o()
+     ,.fifo_deq_v_o(c_v_li)
+     ,.fifo_deq_yumi_i(c_ready_and_lo & c_v_li)
+
+     ,.empty_o(rob_empty_lo)
+     );
+
+  // Space was allocated in the reorder fifo, so responses are always accepted
+  assign returned_yumi_li = returned_any_v_li;
+
   bsg_manycore_packet_op_e out_op_v2;
   bsg_manycore_packet_reg_id_u out_reg_id;
   bsg_manycore_packet_payload_u out_payload;
@@ -231,14 +275,14 @@ module bsg_manycore_axil_bridge
    reg_id_encode
     (.data_i(c_wdata_lo)
      ,.mask_i(c_wmask_lo)
-     ,.reg_id_i('0)
+     ,.reg_id_i(bsg_manycore_reg_id_width_gp'(trans_id_lo))
      ,.data_o(out_st_payload)
      ,.reg_id_o(out_st_reg_id)
      ,.op_o(out_st_op)
      );
 
   assign out_op_v2 = c_w_lo ? out_st_op : e_remote_load;
-  assign out_reg_id = c_w_lo ? out_st_reg_id : '0;
+  assign out_reg_id = c_w_lo ? out_st_reg_id : bsg_manycore_reg_id_width_gp'(trans_id_lo);
   assign out_payload = c_w_lo ? out_st_payload : out_load_info;
 
   assign out_packet_li.addr       = (c_addr_lo >> 2'b10);
@@ -249,12 +293,26 @@ module bsg_manycore_axil_bridge
   assign out_packet_li.src_y_cord = my_y_i;
   assign out_packet_li.y_cord     = dest_y_i;
   assign out_packet_li.x_cord     = dest_x_i;
-  assign out_v_li = c_v_lo;
-  assign c_ready_and_li = out_credit_or_ready_lo;
 
-  assign c_rdata_li = returned_data_r_lo;
-  assign c_v_li = returned_v_r_lo | returned_credit_v_r_lo;
-  assign returned_yumi_li = c_ready_and_lo & c_v_li;
+  wire out_masked_li = c_w_lo & (out_st_op == e_remote_store);
+  wire out_ready_li = out_credit_or_ready_lo & trans_id_v_lo & ~masked_v_r
+    & (~out_masked_li | rob_empty_lo);
+
+  assign out_v_li = c_v_lo & out_ready_li;
+  assign c_ready_and_li = out_ready_li;
+  assign trans_id_yumi_li = out_v_li;
+
+  always_ff @(posedge clk_i)
+    if (reset_i)
+      masked_v_r <= 1'b0;
+    else if (out_v_li & out_masked_li)
+      masked_v_r <= 1'b1;
+    else if (returned_any_v_li)
+      masked_v_r <= 1'b0;
+
+  always_ff @(posedge clk_i)
+    if (out_v_li & out_masked_li)
+      masked_id_r <= trans_id_lo;
 
   logic [m_axil_data_width_p-1:0] m_wdata_li;
   logic [m_axil_addr_width_p-1:0] m_addr_li;
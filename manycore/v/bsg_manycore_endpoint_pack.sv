@@ -0,0 +1,118 @@
+
+`include "bsg_defines.sv"
+
+// Serializes packets onto a host_width_p fifo, several to a transfer
+//
+// With pack_els_p = 0, each packet is sent as width_p/host_width_p beats.
+// Otherwise, packets are buffered, and each transfer is a count beat followed
+//   by that many packets back to back. A transfer takes every packet buffered
+//   when it starts (at most pack_els_p), so the host reads one count for a
+//   burst of packets when it falls behind, and pays one extra beat per packet
+//   when it keeps up.
+module bsg_manycore_endpoint_pack
+ #(parameter `BSG_INV_PARAM(width_p)
+   , parameter `BSG_INV_PARAM(host_width_p)
+   , parameter pack_els_p = 0
+   )
+  (input                                 clk_i
+   , input                               reset_i
+
+   , input [width_p-1:0]                 data_i
+   , input                               v_i
+   , output logic                        ready_and_o
+
+   , output logic [host_width_p-1:0]     data_o
+   , output logic                        v_o
+   , input                               yumi_i
+   );
+
+  logic [width_p-1:0] piso_data_li;
+  logic piso_v_li, piso_ready_and_lo;
+  logic [host_width_p-1:0] piso_data_lo;
+  logic piso_v_lo, piso_yumi_li;
+  bsg_parallel_in_serial_out
+   #(.width_p(host_width_p), .els_p(width_p/host_width_p))
+   piso
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.data_i(piso_data_li)
+     ,.valid_i(piso_v_li)
+     ,.ready_and_o(piso_ready_and_lo)
+
+     ,.data_o(piso_data_lo)
+     ,.valid_o(piso_v_lo)
+     ,.yumi_i(piso_yumi_li)
+     );
+
+  if (pack_els_p == 0)
+    begin : serial
+      assign piso_data_li = data_i;
+      assign piso_v_li = v_i;
+      assign ready_and_o = piso_ready_and_lo;
+
+      assign data_o = piso_data_lo;
+      assign v_o = piso_v_lo;
+      assign piso_yumi_li = yumi_i;
+    end
+  else
+    begin : packed
+      localparam count_width_lp = `BSG_WIDTH(pack_els_p);
+
+      logic fifo_v_lo, fifo_yumi_li;
+      bsg_fifo_1r1w_small
+       #(.width_p(width_p), .els_p(pack_els_p))
+       packet_fifo
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
+
+         ,.data_i(data_i)
+         ,.v_i(v_i)
+         ,.ready_param_o(ready_and_o)
+
+         ,.data_o(piso_data_li)
+         ,.v_o(fifo_v_lo)
+         ,.yumi_i(fifo_yumi_li)
+         );
+
+      logic [count_width_lp-1:0] buffered_lo;
+      bsg_counter_up_down
+       #(.max_val_p(pack_els_p), .init_val_p(0), .max_step_p(1))
+       buffered_counter
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
+
+         ,.up_i(v_i & ready_and_o)
+         ,.down_i(fifo_yumi_li)
+
+         ,.count_o(buffered_lo)
+         );
+
+      // Packets left in the current transfer, the count beat is next at 0
+      logic [count_width_lp-1:0] remaining_r;
+      wire count_v_li = ~piso_v_lo & (remaining_r == '0) & fifo_v_lo;
+
+      assign piso_v_li = (remaining_r != '0) & fifo_v_lo;
+      assign fifo_yumi_li = piso_v_li & piso_ready_and_lo;
+
+      // The last packet of a transfer drains before the next count beat
+      assign data_o = piso_v_lo ? piso_data_lo : host_width_p'(buffered_lo);
+      assign v_o = piso_v_lo | count_v_li;
+      assign piso_yumi_li = yumi_i & piso_v_lo;
+
+      always_ff @(posedge clk_i)
+        if (reset_i)
+          remaining_r <= '0;
+        else if (yumi_i & count_v_li)
+          remaining_r <= buffered_lo;
+        else if (fifo_yumi_li)
+          remaining_r <= remaining_r - 1'b1;
+
+      if (host_width_p < count_width_lp)
+        $error("host_width_p too narrow for the count beat");
+    end
+
+endmodule
+
+`BSG_ABSTRACT_MODULE(bsg_manycore_endpoint_pack)
+
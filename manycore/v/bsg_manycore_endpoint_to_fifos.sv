@@ -32,6 +32,9 @@
  * Convert manycore packets into FIFO data streams, with fields aligned
  * to 8-bit/1-byte boundaries, or vice-versa.
  *
+ * With pack_els_p > 0, every fifo transfer is a count beat followed by up
+ * to pack_els_p packets, in both directions (see bsg_manycore_endpoint_pack).
+ *
  */
 
 `include "bsg_manycore_defines.svh"
@@ -50,6 +53,7 @@ module bsg_manycore_endpoint_to_fifos
    , parameter `BSG_INV_PARAM(icache_block_size_in_words_p)
 
    , parameter debug_p = 0
+   , parameter pack_els_p = 0
 
    , parameter credit_counter_width_p = `BSG_WIDTH(32)
    , localparam link_sif_width_lp = `bsg_manycore_link_sif_width(addr_width_p,data_width_p,x_cord_width_p,y_cord_width_p)
@@ -98,9 +102,9 @@ module bsg_manycore_endpoint_to_fifos
   bsg_manycore_packet_s packet_ep_req_li;
   bsg_manycore_packet_aligned_s aligned_packet_ep_req_li;
   logic packet_ep_req_ready_lo, packet_ep_req_v_li;
-  bsg_serial_in_parallel_out_full
-   #(.width_p(host_width_p), .els_p(fifo_width_p/host_width_p))
-   req_sipo
+  bsg_manycore_endpoint_unpack
+   #(.width_p(fifo_width_p), .host_width_p(host_width_p), .pack_els_p(pack_els_p))
+   req_unpack
     (.clk_i(clk_i)
      ,.reset_i(reset_i)
 
@@ -121,18 +125,18 @@ module bsg_manycore_endpoint_to_fifos
 
   bsg_manycore_return_packet_aligned_s aligned_packet_mc_rsp_lo;
   logic packet_mc_rsp_ready_li, packet_mc_rsp_v_lo;
-  bsg_parallel_in_serial_out
-   #(.width_p(host_width_p), .els_p(fifo_width_p/host_width_p))
-   rsp_piso
+  bsg_manycore_endpoint_pack
+   #(.width_p(fifo_width_p), .host_width_p(host_width_p), .pack_els_p(pack_els_p))
+   rsp_pack
     (.clk_i(clk_i)
      ,.reset_i(reset_i)
 
      ,.data_i(aligned_packet_mc_rsp_lo)
-     ,.valid_i(packet_mc_rsp_v_lo)
+     ,.v_i(packet_mc_rsp_v_lo)
      ,.ready_and_o(packet_mc_rsp_ready_li)
 
      ,.data_o(mc_rsp_o)
-     ,.valid_o(mc_rsp_v_o)
+     ,.v_o(mc_rsp_v_o)
      ,.yumi_i(mc_rsp_ready_i & mc_rsp_v_o)
      );
 
@@ -148,18 +152,18 @@ module bsg_manycore_endpoint_to_fifos
   bsg_manycore_packet_s packet_mc_req_lo;
   bsg_manycore_packet_aligned_s aligned_packet_mc_req_lo;
   logic packet_mc_req_ready_li, packet_mc_req_v_lo;
-  bsg_parallel_in_serial_out
-   #(.width_p(host_width_p), .els_p(fifo_width_p/host_width_p))
-   req_piso
+  bsg_manycore_endpoint_pack
+   #(.width_p(fifo_width_p), .host_width_p(host_width_p), .pack_els_p(pack_els_p))
+   req_pack
     (.clk_i(clk_i)
      ,.reset_i(reset_i)
 
      ,.data_i(aligned_packet_mc_req_lo)
-     ,.valid_i(packet_mc_req_v_lo)
+     ,.v_i(packet_mc_req_v_lo)
      ,.ready_and_o(packet_mc_req_ready_li)
 
      ,.data_o(mc_req_o)
-     ,.valid_o(mc_req_v_o)
+     ,.v_o(mc_req_v_o)
      ,.yumi_i(mc_req_ready_i & mc_req_v_o)
      );
 
@@ -167,9 +171,9 @@ module bsg_manycore_endpoint_to_fifos
   bsg_manycore_return_packet_s packet_ep_rsp_li;
   bsg_manycore_return_packet_aligned_s aligned_packet_ep_rsp_li;
   logic packet_ep_rsp_ready_lo, packet_ep_rsp_v_li;
-  bsg_serial_in_parallel_out_full
-   #(.width_p(host_width_p), .els_p(fifo_width_p/host_width_p))
-   rsp_sipo
+  bsg_manycore_endpoint_unpack
+   #(.width_p(fifo_width_p), .host_width_p(host_width_p), .pack_els_p(pack_els_p))
+   rsp_unpack
     (.clk_i(clk_i)
      ,.reset_i(reset_i)
 
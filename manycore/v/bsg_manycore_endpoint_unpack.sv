@@ -0,0 +1,91 @@
+
+`include "bsg_defines.sv"
+
+// Deserializes packets from a host_width_p fifo, the inverse of
+//   bsg_manycore_endpoint_pack
+//
+// With pack_els_p = 0, each packet is width_p/host_width_p beats. Otherwise,
+//   each transfer is a count beat followed by that many packets. A count of
+//   0 is ignored.
+module bsg_manycore_endpoint_unpack
+ #(parameter `BSG_INV_PARAM(width_p)
+   , parameter `BSG_INV_PARAM(host_width_p)
+   , parameter pack_els_p = 0
+   )
+  (input                                 clk_i
+   , input                               reset_i
+
+   , input [host_width_p-1:0]            data_i
+   , input                               v_i
+   , output logic                        ready_and_o
+
+   , output logic [width_p-1:0]          data_o
+   , output logic                        v_o
+   , input                               yumi_i
+   );
+
+  localparam beats_lp = width_p/host_width_p;
+
+  logic sipo_v_li, sipo_ready_and_lo;
+  bsg_serial_in_parallel_out_full
+   #(.width_p(host_width_p), .els_p(beats_lp))
+   sipo
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.data_i(data_i)
+     ,.v_i(sipo_v_li)
+     ,.ready_and_o(sipo_ready_and_lo)
+
+     ,.data_o(data_o)
+     ,.v_o(v_o)
+     ,.yumi_i(yumi_i)
+     );
+
+  if (pack_els_p == 0)
+    begin : serial
+      assign sipo_v_li = v_i;
+      assign ready_and_o = sipo_ready_and_lo;
+    end
+  else
+    begin : packed
+      localparam count_width_lp = `BSG_WIDTH(pack_els_p);
+
+      // Packets left in the current transfer, the count beat is next at 0
+      logic [count_width_lp-1:0] remaining_r;
+      logic [`BSG_SAFE_CLOG2(beats_lp)-1:0] beat_r;
+      wire is_count = (remaining_r == '0);
+
+      assign sipo_v_li = v_i & ~is_count;
+      assign ready_and_o = is_count | sipo_ready_and_lo;
+
+      wire beat_yumi_li = sipo_v_li & sipo_ready_and_lo;
+      wire last_beat_li = (beat_r == beats_lp-1);
+      always_ff @(posedge clk_i)
+        if (reset_i)
+          begin
+            remaining_r <= '0;
+            beat_r <= '0;
+          end
+        else if (v_i & is_count)
+          remaining_r <= data_i[0+:count_width_lp];
+        else if (beat_yumi_li)
+          begin
+            beat_r <= last_beat_li ? '0 : beat_r + 1'b1;
+            if (last_beat_li)
+              remaining_r <= remaining_r - 1'b1;
+          end
+
+      // synopsys translate_off
+      always @(negedge clk_i) begin
+        if (~reset_i & v_i & is_count) begin
+           assert (data_i <= pack_els_p) else $error("[BSG_ERROR] Transfer of %0d packets exceeds pack_els_p", data_i);
+        end
+      end
+      // synopsys translate_on
+    end
+
+endmodule
+
+`BSG_ABSTRACT_MODULE(bsg_manycore_endpoint_unpack)
+
@@ -0,0 +1,280 @@
+
+`include "bsg_manycore_defines.svh"
+
+// Connects one manycore link (multi) to num_ports_p links
+//
+// Requests from multi are steered by EPA: port i takes EPAs from
+//   split_addr_p[i] up to split_addr_p[i+1], with split_addr_p[0] = 0.
+// Requests from the ports are arbitrated onto multi. Return packets are not
+//   tagged with a port, so each direction talks to one port at a time and only
+//   switches once that port's outstanding requests have drained.
+//
+// fwd_arb_p arbitrates requests into multi, rev_arb_p arbitrates returns
+//   into multi; see bsg_manycore_switch_arb for the policies. Each port may
+//   have up to credits_p requests outstanding in each direction.
+//
+// Per port, the switch counts requests in flight and the cycles that a port's
+//   request (fwd_stall_o) or return (rev_stall_o) was held off. Stall counters
+//   wrap.
+module bsg_manycore_switch_1xn
+ import bsg_manycore_pkg::*;
+ #(parameter `BSG_INV_PARAM(addr_width_p)
+   , parameter `BSG_INV_PARAM(data_width_p)
+   , parameter `BSG_INV_PARAM(x_cord_width_p)
+   , parameter `BSG_INV_PARAM(y_cord_width_p)
+   , parameter `BSG_INV_PARAM(num_ports_p)
+   , parameter [num_ports_p-1:0][addr_width_p-1:0] split_addr_p = '0
+
+   , parameter fwd_arb_p = 0
+   , parameter rev_arb_p = 0
+   , parameter [num_ports_p-1:0][7:0] weights_p = {num_ports_p{8'd1}}
+   , parameter credits_p = 127
+   , parameter stall_width_p = 32
+
+   , localparam lg_ports_lp = `BSG_SAFE_CLOG2(num_ports_p)
+   , localparam credit_width_lp = `BSG_WIDTH(credits_p)
+   , localparam fwd_link_sif_width_lp =
+       `bsg_ready_and_link_sif_width(`bsg_manycore_packet_width(addr_width_p, data_width_p, x_cord_width_p, y_cord_width_p))
+   , localparam rev_link_sif_width_lp =
+       `bsg_ready_and_link_sif_width(`bsg_manycore_return_packet_width(x_cord_width_p, y_cord_width_p, data_width_p))
+   )
+  (input                                                     clk_i
+   , input                                                   reset_i
+
+   , input [num_ports_p-1:0][fwd_link_sif_width_lp-1:0]        fwd_link_sif_i
+   , output logic [num_ports_p-1:0][rev_link_sif_width_lp-1:0] rev_link_sif_o
+   , output logic [num_ports_p-1:0][fwd_link_sif_width_lp-1:0] fwd_link_sif_o
+   , input [num_ports_p-1:0][rev_link_sif_width_lp-1:0]        rev_link_sif_i
+
+   , output logic [fwd_link_sif_width_lp-1:0]                multi_fwd_link_sif_o
+   , input [fwd_link_sif_width_lp-1:0]                       multi_fwd_link_sif_i
+   , output logic [rev_link_sif_width_lp-1:0]                multi_rev_link_sif_o
+   , input [rev_link_sif_width_lp-1:0]                       multi_rev_link_sif_i
+
+   , output logic [num_ports_p-1:0][credit_width_lp-1:0]     send_credits_used_o
+   , output logic [num_ports_p-1:0][credit_width_lp-1:0]     recv_credits_used_o
+   , output logic [num_ports_p-1:0][stall_width_p-1:0]       fwd_stall_o
+   , output logic [num_ports_p-1:0][stall_width_p-1:0]       rev_stall_o
+   );
+
+  `declare_bsg_manycore_link_sif_s(addr_width_p, data_width_p, x_cord_width_p, y_cord_width_p);
+  `declare_bsg_manycore_packet_s(addr_width_p, data_width_p, x_cord_width_p, y_cord_width_p);
+  bsg_manycore_fwd_link_sif_s [num_ports_p-1:0] fwd_link_sif_cast_i, fwd_link_sif_cast_o;
+  bsg_manycore_rev_link_sif_s [num_ports_p-1:0] rev_link_sif_cast_i, rev_link_sif_cast_o;
+  bsg_manycore_fwd_link_sif_s multi_fwd_link_sif_cast_i, multi_fwd_link_sif_cast_o;
+  bsg_manycore_rev_link_sif_s multi_rev_link_sif_cast_i, multi_rev_link_sif_cast_o;
+
+  assign fwd_link_sif_cast_i = fwd_link_sif_i;
+  assign multi_rev_link_sif_cast_i = multi_rev_link_sif_i;
+  assign rev_link_sif_o = rev_link_sif_cast_o;
+  assign multi_fwd_link_sif_o = multi_fwd_link_sif_cast_o;
+  assign multi_fwd_link_sif_cast_i = multi_fwd_link_sif_i;
+  assign rev_link_sif_cast_i = rev_link_sif_i;
+  assign multi_rev_link_sif_o = multi_rev_link_sif_cast_o;
+  assign fwd_link_sif_o = fwd_link_sif_cast_o;
+
+  //////////////////////////////////////////////////
+  //  TX
+  //////////////////////////////////////////////////
+  logic send_v_r;
+  logic [lg_ports_lp-1:0] send_sel_r;
+
+  bsg_manycore_packet_s fwd_packet;
+  assign fwd_packet = multi_fwd_link_sif_cast_i.data;
+  wire [1:0] fwd_part_sel = fwd_packet.payload.load_info_s.load_info.part_sel;
+  wire [addr_width_p-1:0] fwd_epa = (fwd_packet.addr << 2) | fwd_part_sel;
+  logic [lg_ports_lp-1:0] fwd_select;
+  always_comb
+    begin
+      fwd_select = '0;
+      for (integer i = 1; i < num_ports_p; i++)
+        if (fwd_epa >= split_addr_p[i])
+          fwd_select = lg_ports_lp'(i);
+    end
+
+  logic [num_ports_p-1:0][credit_width_lp-1:0] send_cnt_lo;
+  wire send_credit_li = (send_cnt_lo[send_sel_r] < credits_p);
+  wire send_v_li = multi_fwd_link_sif_cast_i.v & send_v_r & (fwd_select == send_sel_r) & send_credit_li;
+  for (genvar i = 0; i < num_ports_p; i++)
+    begin : send
+      assign fwd_link_sif_cast_o[i].data = multi_fwd_link_sif_cast_i.data;
+      assign fwd_link_sif_cast_o[i].v    = send_v_li & (send_sel_r == i);
+    end
+  assign multi_fwd_link_sif_cast_o.ready_and_rev = send_v_li & fwd_link_sif_cast_i[send_sel_r].ready_and_rev;
+  wire send_yumi_li = multi_fwd_link_sif_cast_o.ready_and_rev;
+
+  bsg_manycore_return_packet_s multi_rev_data_lo;
+  logic [lg_ports_lp-1:0] multi_rev_tag_lo;
+  logic multi_rev_v_lo, multi_rev_yumi_li;
+  logic [num_ports_p-1:0] rev_yumi_lo, rev_v_li;
+  logic [num_ports_p-1:0][$bits(bsg_manycore_return_packet_s)-1:0] rev_data_li;
+  for (genvar i = 0; i < num_ports_p; i++)
+    begin : rev
+      assign rev_data_li[i] = rev_link_sif_cast_i[i].data;
+      assign rev_v_li[i] = rev_link_sif_cast_i[i].v;
+      assign rev_link_sif_cast_o[i].ready_and_rev = rev_yumi_lo[i];
+    end
+
+  bsg_manycore_switch_arb
+   #(.width_p($bits(bsg_manycore_return_packet_s))
+     ,.num_in_p(num_ports_p)
+     ,.arb_p(rev_arb_p)
+     ,.weights_p(weights_p)
+     )
+   rev_arb
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.data_i(rev_data_li)
+     ,.v_i(rev_v_li)
+     ,.yumi_o(rev_yumi_lo)
+
+     ,.data_o(multi_rev_data_lo)
+     ,.tag_o(multi_rev_tag_lo)
+     ,.v_o(multi_rev_v_lo)
+     ,.yumi_i(multi_rev_yumi_li)
+     );
+
+  assign multi_rev_link_sif_cast_o.data = multi_rev_data_lo;
+  assign multi_rev_link_sif_cast_o.v = multi_rev_v_lo;
+  assign multi_rev_yumi_li = multi_rev_link_sif_cast_i.ready_and_rev & multi_rev_v_lo;
+
+  for (genvar i = 0; i < num_ports_p; i++)
+    begin : sfc
+      bsg_counter_up_down
+       #(.max_val_p(credits_p), .init_val_p(0), .max_step_p(1))
+       cnt
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
+
+         ,.up_i(send_yumi_li & (send_sel_r == i))
+         ,.down_i(rev_yumi_lo[i])
+
+         ,.count_o(send_cnt_lo[i])
+         );
+    end
+
+  // Wait for a request, then stay on its port until it has drained
+  wire send_pending = multi_fwd_link_sif_cast_i.v & (~send_v_r | (fwd_select != send_sel_r));
+  wire send_drained = (send_cnt_lo[send_sel_r] == '0) & ~send_yumi_li;
+  wire send_switch  = send_pending & (~send_v_r | send_drained);
+  bsg_dff_reset_en
+   #(.width_p(1+lg_ports_lp))
+   send_reg
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+     ,.en_i(send_switch | (send_v_r & send_drained))
+     ,.data_i({send_switch, fwd_select})
+     ,.data_o({send_v_r, send_sel_r})
+     );
+
+  //////////////////////////////////////////////////
+  //  RX
+  //////////////////////////////////////////////////
+  logic recv_v_r;
+  logic [lg_ports_lp-1:0] recv_sel_r;
+  logic [num_ports_p-1:0][credit_width_lp-1:0] recv_cnt_lo;
+
+  bsg_manycore_packet_s multi_fwd_data_lo;
+  logic [lg_ports_lp-1:0] multi_fwd_tag_lo;
+  logic multi_fwd_v_lo, multi_fwd_yumi_li;
+  logic [num_ports_p-1:0] fwd_v_li, fwd_yumi_lo;
+  logic [num_ports_p-1:0][$bits(bsg_manycore_packet_s)-1:0] fwd_data_li;
+  for (genvar i = 0; i < num_ports_p; i++)
+    begin : fwd
+      assign fwd_data_li[i] = fwd_link_sif_cast_i[i].data;
+      assign fwd_v_li[i] = fwd_link_sif_cast_i[i].v & (recv_cnt_lo[i] < credits_p);
+      assign fwd_link_sif_cast_o[i].ready_and_rev = fwd_yumi_lo[i];
+    end
+
+  bsg_manycore_switch_arb
+   #(.width_p($bits(bsg_manycore_packet_s))
+     ,.num_in_p(num_ports_p)
+     ,.arb_p(fwd_arb_p)
+     ,.weights_p(weights_p)
+     )
+   fwd_arb
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.data_i(fwd_data_li)
+     ,.v_i(fwd_v_li)
+     ,.yumi_o(fwd_yumi_lo)
+
+     ,.data_o(multi_fwd_data_lo)
+     ,.tag_o(multi_fwd_tag_lo)
+     ,.v_o(multi_fwd_v_lo)
+     ,.yumi_i(multi_fwd_yumi_li)
+     );
+
+  assign multi_fwd_link_sif_cast_o.data = multi_fwd_data_lo;
+  assign multi_fwd_link_sif_cast_o.v = multi_fwd_v_lo & (~recv_v_r | (multi_fwd_tag_lo == recv_sel_r));
+  assign multi_fwd_yumi_li = multi_fwd_link_sif_cast_i.ready_and_rev & multi_fwd_link_sif_cast_o.v;
+
+  for (genvar i = 0; i < num_ports_p; i++)
+    begin : recv
+      assign rev_link_sif_cast_o[i].data = multi_rev_link_sif_cast_i.data;
+      assign rev_link_sif_cast_o[i].v    = multi_rev_link_sif_cast_i.v & recv_v_r & (recv_sel_r == i);
+    end
+  assign multi_rev_link_sif_cast_o.ready_and_rev = recv_v_r & rev_link_sif_cast_i[recv_sel_r].ready_and_rev;
+  wire recv_return_li = multi_rev_link_sif_cast_o.ready_and_rev & multi_rev_link_sif_cast_i.v;
+
+  for (genvar i = 0; i < num_ports_p; i++)
+    begin : rfc
+      bsg_counter_up_down
+       #(.max_val_p(credits_p), .init_val_p(0), .max_step_p(1))
+       cnt
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
+
+         ,.up_i(multi_fwd_yumi_li & (multi_fwd_tag_lo == i))
+         ,.down_i(recv_return_li & (recv_sel_r == i))
+
+         ,.count_o(recv_cnt_lo[i])
+         );
+    end
+
+  wire recv_drained = (recv_cnt_lo[recv_sel_r] == '0) & ~multi_fwd_yumi_li;
+  bsg_dff_reset_en
+   #(.width_p(1+lg_ports_lp))
+   recv_reg
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+     ,.en_i(multi_fwd_yumi_li | (recv_v_r & recv_drained))
+     ,.data_i({multi_fwd_yumi_li, multi_fwd_tag_lo})
+     ,.data_o({recv_v_r, recv_sel_r})
+     );
+
+  //////////////////////////////////////////////////
+  //  Statistics
+  //////////////////////////////////////////////////
+  for (genvar i = 0; i < num_ports_p; i++)
+    begin : stall
+      bsg_counter_clear_up
+       #(.max_val_p({stall_width_p{1'b1}}), .init_val_p(0), .disable_overflow_warning_p(1))
+       fwd_cnt
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
+         ,.clear_i(1'b0)
+         ,.up_i(fwd_link_sif_cast_i[i].v & ~fwd_yumi_lo[i])
+         ,.count_o(fwd_stall_o[i])
+         );
+
+      bsg_counter_clear_up
+       #(.max_val_p({stall_width_p{1'b1}}), .init_val_p(0), .disable_overflow_warning_p(1))
+       rev_cnt
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
+         ,.clear_i(1'b0)
+         ,.up_i(rev_link_sif_cast_i[i].v & ~rev_yumi_lo[i])
+         ,.count_o(rev_stall_o[i])
+         );
+    end
+
+  assign send_credits_used_o = send_cnt_lo;
+  assign recv_credits_used_o = recv_cnt_lo;
+
+endmodule
+
+`BSG_ABSTRACT_MODULE(bsg_manycore_switch_1xn)
+
@@ -0,0 +1,98 @@
+
+`include "bsg_defines.sv"
+
+// N-to-1 arbiter for the manycore switch, with the same interface as
+//   bsg_round_robin_n_to_1
+//
+// arb_p:
+//   0: round-robin
+//   1: fixed priority, input 0 first (by convention the host)
+//   2: weighted round-robin, input i keeps the grant for up to weights_p[i]
+//        consecutive packets while it has more to send (weights_p[i] >= 1)
+module bsg_manycore_switch_arb
+ #(parameter `BSG_INV_PARAM(width_p)
+   , parameter `BSG_INV_PARAM(num_in_p)
+   , parameter arb_p = 0
+   , parameter [num_in_p-1:0][7:0] weights_p = {num_in_p{8'd1}}
+
+   , localparam tag_width_lp = `BSG_SAFE_CLOG2(num_in_p)
+   )
+  (input                                   clk_i
+   , input                                 reset_i
+
+   , input [num_in_p-1:0][width_p-1:0]     data_i
+   , input [num_in_p-1:0]                  v_i
+   , output logic [num_in_p-1:0]           yumi_o
+
+   , output logic [width_p-1:0]            data_o
+   , output logic [tag_width_lp-1:0]       tag_o
+   , output logic                          v_o
+   , input                                 yumi_i
+   );
+
+  logic [num_in_p-1:0] grants_lo;
+  if (arb_p == 1)
+    begin : prio
+      bsg_priority_encode_one_hot_out
+       #(.width_p(num_in_p), .lo_to_hi_p(1))
+       pe
+        (.i(v_i)
+         ,.o(grants_lo)
+         ,.v_o()
+         );
+    end
+  else
+    begin : rr
+      logic [num_in_p-1:0] rr_grants_lo, hold_r;
+      logic [7:0] burst_r;
+      wire hold_li = (arb_p == 2) & (burst_r != '0) & |(hold_r & v_i);
+
+      bsg_arb_round_robin
+       #(.width_p(num_in_p))
+       arb
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
+
+         ,.reqs_i(v_i)
+         ,.grants_o(rr_grants_lo)
+         ,.yumi_i(yumi_i & ~hold_li)
+         );
+
+      assign grants_lo = hold_li ? hold_r : rr_grants_lo;
+
+      bsg_dff_reset_en
+       #(.width_p(num_in_p+8))
+       burst_reg
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
+         ,.en_i(yumi_i)
+         ,.data_i({grants_lo, hold_li ? 8'(burst_r - 1'b1) : 8'(weights_p[tag_o] - 1'b1)})
+         ,.data_o({hold_r, burst_r})
+         );
+    end
+
+  bsg_mux_one_hot
+   #(.width_p(width_p), .els_p(num_in_p))
+   data_mux
+    (.data_i(data_i)
+     ,.sel_one_hot_i(grants_lo)
+     ,.data_o(data_o)
+     );
+
+  bsg_encode_one_hot
+   #(.width_p(num_in_p))
+   tag_encode
+    (.i(grants_lo)
+     ,.addr_o(tag_o)
+     ,.v_o(v_o)
+     );
+
+  assign yumi_o = grants_lo & {num_in_p{yumi_i}};
+
+  if (arb_p > 2)
+    $error("Unknown arb_p %d", arb_p);
+
+endmodule
+
+`BSG_ABSTRACT_MODULE(bsg_manycore_switch_arb)
+
@@ -397,6 +397,12 @@ module bsg_manycore_tile_blackparrot
      ,.global_y_i(fifo_y_li)
      );
 
+  // Any exchange with the manycore may publish its DRAM writes to BP: the
+  //   manycore requests to BP and the MMIO and FIFO responses to it
+  wire dram_inval_li = (proc_fwd_v_lo[2] & proc_fwd_ready_and_li[2])
+    | (dev_rev_v_lo[3] & dev_rev_ready_and_li[3])
+    | (dev_rev_v_lo[4] & dev_rev_ready_and_li[4]);
+
   for (genvar i = 0; i < 2; i++)
     begin : d
       wire [x_cord_width_p-1:0] dram_x_li = global_x_i[2+i];
@@ -437,6 +443,7 @@ module bsg_manycore_tile_blackparrot
 
          ,.dram_pod_i(dram_pod_lo)
          ,.dram_offset_i(dram_offset_lo)
+         ,.lb_inval_i(dram_inval_li)
          ,.global_x_i(dram_x_li)
          ,.global_y_i(dram_y_li)
          );
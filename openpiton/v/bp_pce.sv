@@ -20,6 +20,8 @@ module bp_pce
    , parameter metadata_latency_p = 1
    , parameter req_fifo_els_p = pce_id_p == 0 ? 1 : 8
    , parameter ret_fifo_els_p = pce_id_p == 0 ? 4 : 8
+   // Cacheable misses in flight to the L1.5, each sent on its own threadid
+   , parameter mshr_els_p = pce_id_p == 0 ? 1 : 2
    `declare_bp_proc_params(bp_params_p)
    `declare_bp_cache_engine_generic_if_widths(paddr_width_p, tag_width_p, sets_p, assoc_p, data_width_p, block_width_p, fill_width_p, id_width_p, cache)
    `declare_bp_pce_l15_if_widths(paddr_width_p, dword_width_gp)
@@ -32,6 +34,7 @@ module bp_pce
    , localparam block_offset_width_lp = word_offset_width_lp + byte_offset_width_lp
    , localparam index_width_lp = `BSG_SAFE_CLOG2(sets_p)
    , localparam way_width_lp = `BSG_SAFE_CLOG2(assoc_p)
+   , localparam mshr_id_width_lp = `BSG_SAFE_CLOG2(mshr_els_p)
    )
   ( input                                          clk_i
   , input                                          reset_i
@@ -102,9 +105,9 @@ module bp_pce
      ,.yumi_i(cache_req_done)
      );
   assign cache_req_yumi_o = cache_req_ready_and_lo & cache_req_v_i;
-  assign cache_req_addr_o = cache_req_lo.addr;
 
   bp_cache_req_metadata_s cache_req_metadata_lo;
+  logic cache_req_metadata_v_lo;
   bsg_two_fifo
    #(.width_p($bits(bp_cache_req_metadata_s)))
    cache_req_metadata_reg
@@ -115,7 +118,7 @@ module bp_pce
      ,.data_i(cache_req_metadata_cast_i)
      ,.ready_param_o(/* Same size as cache_req by construction */)
 
-     ,.v_o(/* Follows cache_req by construction */)
+     ,.v_o(cache_req_metadata_v_lo)
      ,.data_o(cache_req_metadata_lo)
      ,.yumi_i(cache_req_done)
      );
@@ -190,10 +193,71 @@ module bp_pce
   wire amo_sc_v_r     = cache_req_v_lo & cache_req_lo.msg_type inside {e_uc_amo} & cache_req_lo.subop inside {e_req_amosc};
   wire amo_op_v_r     = cache_req_v_lo & cache_req_lo.msg_type inside {e_uc_amo} & cache_req_lo.subop inside {e_req_amoswap, e_req_amoadd, e_req_amoxor, e_req_amoand, e_req_amoor, e_req_amomin, e_req_amomax, e_req_amominu, e_req_amomaxu};
 
+  // Miss status holding registers
+  //
+  // Cacheable misses are retired from the request fifo as soon as they are sent,
+  //   and are filled from here when the L1.5 returns them. The L1.5 tracks one
+  //   load per thread, so the MSHR id is sent as the threadid and comes back
+  //   with the fill.
+  bp_cache_req_s [mshr_els_p-1:0] mshr_req_r;
+  bp_cache_req_metadata_s [mshr_els_p-1:0] mshr_metadata_r;
+  logic [mshr_els_p-1:0] mshr_v_r, mshr_set_match, mshr_block_match;
+  logic [mshr_id_width_lp-1:0] mshr_alloc_id_lo;
+  logic mshr_alloc_v_lo, mshr_alloc_li, mshr_fill_yumi_li;
+
+  bsg_priority_encode
+   #(.width_p(mshr_els_p), .lo_to_hi_p(1))
+   mshr_alloc_pe
+    (.i(~mshr_v_r)
+     ,.addr_o(mshr_alloc_id_lo)
+     ,.v_o(mshr_alloc_v_lo)
+     );
+
+  wire mshr_fill_v_li = is_ifill_ret | is_load_ret;
+  wire [mshr_id_width_lp-1:0] mshr_fill_id_li = mshr_id_width_lp'(l15_pce_ret_li.threadid);
+  for (genvar i = 0; i < mshr_els_p; i++)
+    begin : mshr
+      assign mshr_set_match[i] = mshr_v_r[i]
+        & (mshr_req_r[i].addr[block_offset_width_lp+:index_width_lp] == cache_req_lo.addr[block_offset_width_lp+:index_width_lp]);
+      assign mshr_block_match[i] = mshr_v_r[i]
+        & (mshr_req_r[i].addr[paddr_width_p-1:block_offset_width_lp] == cache_req_lo.addr[paddr_width_p-1:block_offset_width_lp]);
+    end
+
+  // synopsys sync_set_reset "reset_i"
+  always_ff @(posedge clk_i)
+    if (reset_i)
+      mshr_v_r <= '0;
+    else
+      mshr_v_r <= (mshr_v_r | (mshr_alloc_li << mshr_alloc_id_lo)) & ~(mshr_fill_yumi_li << mshr_fill_id_li);
+
+  always_ff @(posedge clk_i)
+    if (mshr_alloc_li)
+      begin
+        mshr_req_r[mshr_alloc_id_lo] <= cache_req_lo;
+        mshr_metadata_r[mshr_alloc_id_lo] <= cache_req_metadata_lo;
+      end
+
+  // Misses wait for a free MSHR and for earlier misses to the same set, which
+  //   may have picked the same way. Write-through stores wait for misses to the
+  //   same block. Everything else waits for all misses, so that threadids
+  //   belong to the MSHRs only.
+  wire mshr_stall = miss_v_r
+    ? (~mshr_alloc_v_lo | ~cache_req_metadata_v_lo | |mshr_set_match)
+    : wt_store_v_r
+      ? |mshr_block_match
+      : |mshr_v_r;
+
+  // Fills are for an MSHR, other returns are for the request in the fifo
+  bp_cache_req_s fill_req_lo;
+  bp_cache_req_metadata_s fill_metadata_lo;
+  assign fill_req_lo = mshr_fill_v_li ? mshr_req_r[mshr_fill_id_li] : cache_req_lo;
+  assign fill_metadata_lo = mshr_fill_v_li ? mshr_metadata_r[mshr_fill_id_li] : cache_req_metadata_lo;
+  assign cache_req_addr_o = fill_req_lo.addr;
+
   // We can't accept any more requests
   assign cache_req_credits_full_o  =  cache_req_v_lo & ~pce_l15_req_ready_and_i;
   // We have finished processing all of our requests
-  assign cache_req_credits_empty_o = ~cache_req_v_lo;
+  assign cache_req_credits_empty_o = ~cache_req_v_lo & ~|mshr_v_r;
   // Force immediate acceptance of invalidations
   assign cache_req_lock_o          = is_reset | is_init | inval_v_li | clear_v_li;
 
@@ -254,7 +318,7 @@ module bp_pce
 
       fill_data = fill_data_le;
 
-      case (cache_req_lo.size)
+      case (fill_req_lo.size)
         e_size_1B : fill_data_packed = {fill_width_p/8{fill_data[0+:8]}};
         e_size_2B : fill_data_packed = {fill_width_p/16{fill_data[0+:16]}};
         e_size_4B : fill_data_packed = {fill_width_p/32{fill_data[0+:32]}};
@@ -307,6 +371,8 @@ module bp_pce
       pce_l15_req_v_o = '0;
 
       l15_pce_ret_yumi_lo = '0;
+      mshr_alloc_li = '0;
+      mshr_fill_yumi_li = '0;
       state_n = state_r;
 
       unique case (state_r)
@@ -334,7 +400,7 @@ module bp_pce
 
         e_ready:
           begin
-                pce_l15_req_v_o = cache_req_v_lo;
+                pce_l15_req_v_o = cache_req_v_lo & ~mshr_stall;
 
                 pce_l15_req_cast_o.data     = req_data;
                 pce_l15_req_cast_o.size     = req_size;
@@ -366,8 +432,10 @@ module bp_pce
                 pce_l15_req_cast_o.address = (pce_id_p == 1)
                   ? {cache_req_lo.addr[paddr_width_p-1:4], 4'b0}
                   : {cache_req_lo.addr[paddr_width_p-1:5], 5'b0};
+                pce_l15_req_cast_o.threadid = mshr_alloc_id_lo;
 
-                state_n = (pce_l15_req_ready_and_i & pce_l15_req_v_o) ? e_read_wait : state_r;
+                mshr_alloc_li = pce_l15_req_ready_and_i & pce_l15_req_v_o;
+                cache_req_done = mshr_alloc_li;
               end
             else if (amo_lr_v_r | amo_sc_v_r | amo_op_v_r)
               begin
@@ -391,6 +459,7 @@ module bp_pce
         e_read_wait:
           begin
             // LR comes as a cacheline fill, so we don't treat it as non-cacheable
+            //   Cacheable fills are for an MSHR, and are handled below
             if (l15_pce_ret_li.noncacheable | is_amo_lr_ret)
               begin
                 data_mem_pkt_cast_o.opcode = e_cache_data_mem_uncached;
@@ -399,36 +468,40 @@ module bp_pce
 
                 l15_pce_ret_yumi_lo = data_mem_pkt_yumi_i;
               end
-            else
-              begin
-                data_mem_pkt_cast_o.opcode = e_cache_data_mem_write;
-                data_mem_pkt_cast_o.index = cache_req_lo.addr[block_offset_width_lp+:index_width_lp];
-                data_mem_pkt_cast_o.way_id = cache_req_metadata_lo.hit_or_repl_way;
-                data_mem_pkt_cast_o.fill_index = 1'b1;
-                data_mem_pkt_cast_o.data = fill_data_packed;
-                // Checking for return types here since we could also have
-                // invalidations coming in at anytime
-                data_mem_pkt_v_o = is_ifill_ret | is_load_ret;
-
-                tag_mem_pkt_cast_o.opcode = e_cache_tag_mem_set_tag;
-                tag_mem_pkt_cast_o.index = cache_req_lo.addr[block_offset_width_lp+:index_width_lp];
-                tag_mem_pkt_cast_o.way_id = cache_req_metadata_lo.hit_or_repl_way;
-                tag_mem_pkt_cast_o.tag = cache_req_lo.addr[block_offset_width_lp+index_width_lp+:ctag_width_p];
-                tag_mem_pkt_cast_o.state = is_ifill_ret ? e_COH_S : e_COH_M;
-                tag_mem_pkt_v_o = is_ifill_ret | is_load_ret;
-
-                l15_pce_ret_yumi_lo = data_mem_pkt_yumi_i & tag_mem_pkt_yumi_i;
-              end
 
             cache_req_critical_o = data_mem_pkt_v_o;
-            cache_req_last_o = load_resp_v_li;
-            cache_req_done = load_resp_v_li & l15_pce_ret_yumi_lo;
+            cache_req_last_o = load_resp_v_li & ~mshr_fill_v_li;
+            cache_req_done = cache_req_last_o & l15_pce_ret_yumi_lo;
 
             state_n = cache_req_done ? e_ready : state_r;
           end
         default: state_n = e_reset;
       endcase
 
+      // Fills can return while any request is in flight
+      if ((is_ready | is_store_wait | is_read_wait) & mshr_fill_v_li)
+        begin
+          data_mem_pkt_cast_o.opcode = e_cache_data_mem_write;
+          data_mem_pkt_cast_o.index = fill_req_lo.addr[block_offset_width_lp+:index_width_lp];
+          data_mem_pkt_cast_o.way_id = fill_metadata_lo.hit_or_repl_way;
+          data_mem_pkt_cast_o.fill_index = 1'b1;
+          data_mem_pkt_cast_o.data = fill_data_packed;
+          data_mem_pkt_v_o = 1'b1;
+
+          tag_mem_pkt_cast_o.opcode = e_cache_tag_mem_set_tag;
+          tag_mem_pkt_cast_o.index = fill_req_lo.addr[block_offset_width_lp+:index_width_lp];
+          tag_mem_pkt_cast_o.way_id = fill_metadata_lo.hit_or_repl_way;
+          tag_mem_pkt_cast_o.tag = fill_req_lo.addr[block_offset_width_lp+index_width_lp+:ctag_width_p];
+          tag_mem_pkt_cast_o.state = is_ifill_ret ? e_COH_S : e_COH_M;
+          tag_mem_pkt_v_o = 1'b1;
+
+          l15_pce_ret_yumi_lo = data_mem_pkt_yumi_i & tag_mem_pkt_yumi_i;
+          mshr_fill_yumi_li = l15_pce_ret_yumi_lo;
+
+          cache_req_critical_o = 1'b1;
+          cache_req_last_o = 1'b1;
+        end
+
       // Need to support invalidations no matter what
       // Supporting inval all way and single way for both caches. OpenPiton
       // doesn't support inval all way for dcache and inval specific way for
@@ -456,5 +529,8 @@ module bp_pce
     else
       state_r <= state_n;
 
+  if (mshr_els_p > 2)
+    $error("L1.5 threadid can only tag 2 MSHRs");
+
 endmodule
 
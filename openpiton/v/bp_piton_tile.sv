@@ -12,6 +12,8 @@ module bp_piton_tile
  import bp_me_pkg::*;
  #(parameter bp_params_e bp_params_p = e_bp_unicore_parrotpiton_cfg // Warning: Change this at your own peril!
    `declare_bp_proc_params(bp_params_p)
+   // Requests buffered per PCE ahead of the L1.5 arbiter
+   , parameter pce_req_fifo_els_p = 4
    `declare_bp_bedrock_if_widths(paddr_width_p, lce_id_width_p, cce_id_width_p, did_width_p, lce_assoc_p)
    `declare_bp_pce_l15_if_widths(paddr_width_p, dword_width_gp)
    )
@@ -336,13 +338,14 @@ module bp_piton_tile
      );
 
   // PCE -> L1.5 - Arbitration logic
-  // 2 elements to support writeback
+  // Buffering absorbs D$ writeback bursts, round-robin arbitration keeps I$ fills
+  //   moving under them, and the granted request is registered before the L1.5
   bp_pce_l15_req_s [1:0] fifo_lo;
   logic [1:0] fifo_v_lo, fifo_yumi_li;
   for (genvar i = 0; i < 2; i++)
     begin : fifo
-      bsg_two_fifo
-       #(.width_p($bits(bp_pce_l15_req_s)))
+      bsg_fifo_1r1w_small
+       #(.width_p($bits(bp_pce_l15_req_s)), .els_p(pce_req_fifo_els_p))
        mem_fifo
         (.clk_i(posedge_clk)
          ,.reset_i(reset_i)
@@ -358,12 +361,16 @@ module bp_piton_tile
     end
 
   logic [1:0] fifo_grants_lo;
-  bsg_arb_fixed
-   #(.inputs_p(2), .lo_to_hi_p(0))
+  logic l15_req_ready_and_lo;
+  bsg_arb_round_robin
+   #(.width_p(2))
    cmd_arbiter
-    (.ready_then_i(1'b1)
+    (.clk_i(posedge_clk)
+     ,.reset_i(reset_i)
+
      ,.reqs_i(fifo_v_lo)
      ,.grants_o(fifo_grants_lo)
+     ,.yumi_i(l15_req_ready_and_lo & |fifo_v_lo)
      );
 
   bp_pce_l15_req_s fifo_selected_lo;
@@ -374,21 +381,50 @@ module bp_piton_tile
      ,.sel_one_hot_i(fifo_grants_lo)
      ,.data_o(fifo_selected_lo)
      );
+  assign fifo_yumi_li = fifo_grants_lo & {2{l15_req_ready_and_lo}};
+
+  bp_pce_l15_req_s l15_req_lo;
+  bsg_two_fifo
+   #(.width_p($bits(bp_pce_l15_req_s)))
+   l15_req_fifo
+    (.clk_i(posedge_clk)
+     ,.reset_i(reset_i)
+
+     ,.data_i(fifo_selected_lo)
+     ,.v_i(|fifo_v_lo)
+     ,.ready_param_o(l15_req_ready_and_lo)
+
+     ,.data_o(l15_req_lo)
+     ,.v_o(transducer_l15_val)
+     ,.yumi_i(transducer_l15_val & l15_transducer_ack)
+     );
+
+  // synopsys translate_off
+  // Cycles each PCE had a request buffered that was not sent. These are
+  //   simulation-only, since the port list has to match the OpenPiton wrapper.
+  longint arb_stall_r [1:0];
+  always_ff @(posedge posedge_clk)
+    for (integer i = 0; i < 2; i++)
+      if (reset_i)
+        arb_stall_r[i] <= '0;
+      else if (fifo_v_lo[i] & ~fifo_yumi_li[i])
+        arb_stall_r[i] <= arb_stall_r[i] + 1'b1;
+
+  final
+    $display("%m: PCE arbitration stalls: I$ %0d, D$ %0d", arb_stall_r[0], arb_stall_r[1]);
+  // synopsys translate_on
 
   // PCE -> L1.5 signals
-  assign transducer_l15_rqtype = fifo_selected_lo.rqtype;
-  assign transducer_l15_nc = fifo_selected_lo.nc;
-  assign transducer_l15_size = fifo_selected_lo.size;
-  assign transducer_l15_address = fifo_selected_lo.address;
-  assign transducer_l15_data = fifo_selected_lo.data;
-  assign transducer_l15_l1rplway = fifo_selected_lo.l1rplway;
-  assign transducer_l15_val = |fifo_grants_lo;
-  assign transducer_l15_amo_op = fifo_selected_lo.amo_op;
-  assign fifo_yumi_li[0] = fifo_grants_lo[0] & l15_transducer_ack;
-  assign fifo_yumi_li[1] = fifo_grants_lo[1] & l15_transducer_ack;
+  assign transducer_l15_rqtype = l15_req_lo.rqtype;
+  assign transducer_l15_nc = l15_req_lo.nc;
+  assign transducer_l15_size = l15_req_lo.size;
+  assign transducer_l15_address = l15_req_lo.address;
+  assign transducer_l15_data = l15_req_lo.data;
+  assign transducer_l15_l1rplway = l15_req_lo.l1rplway;
+  assign transducer_l15_amo_op = l15_req_lo.amo_op;
+  assign transducer_l15_threadid = l15_req_lo.threadid;
 
   // Unused signals
-  assign transducer_l15_threadid = '0;
   assign transducer_l15_prefetch = '0;
   assign transducer_l15_invalidate_cacheline = '0;
   assign transducer_l15_blockstore = '0;
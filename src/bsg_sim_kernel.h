@@ -0,0 +1,228 @@
+
+#ifndef BSG_SIM_KERNEL_H
+#define BSG_SIM_KERNEL_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "verilated.h"
+
+  // Clock and time keeping for the Verilator testbenches
+  //
+  // Each clock drives a 1b model input with its own period and phase, so
+  //   clock domains may run at any ratio. Times are in units of the context
+  //   time precision. The kernel jumps from one edge to the next and
+  //   evaluates the model once per distinct edge time, however many clocks
+  //   share it:
+  //   - pre_edge callbacks run just before a rising edge, with the model
+  //     settled. BFMs sample outputs and complete handshakes here. Inputs
+  //     changed here are seen by the edge, but not by the pre_edge callbacks
+  //     of other clocks rising at the same time.
+  //   - post_edge callbacks run after the rising edge, at the start of the
+  //     next step. BFMs drive the inputs for the next cycle here. The
+  //     changes are not evaluated on their own, but together with the next
+  //     edge.
+  //   - the model is only settled before a rising edge when that edge has
+  //     pre_edge callbacks and inputs changed since the last eval.
+  //   A single clock with a pre/post BFM thus takes two evals per cycle,
+  //   one at each edge. A run ends right after an edge, before its post_edge
+  //   callbacks: done checks and code between runs see the cycle as the edge
+  //   left it, and callbacks added after reset still drive before they
+  //   first sample.
+  //
+  // Timers are clocks without a model input: their callbacks run at the
+  //   timer period, e.g. to drive source-synchronous data between the edges
+  //   of a clock, but a timer never evaluates the model on its own.
+  //
+  // Monitors run after every eval, for BFMs that sample a clock generated
+  //   by the model, which may toggle on any edge.
+  class bsg_sim_kernel {
+    public:
+      typedef std::function<void()> callback;
+
+      template <typename model_t>
+      bsg_sim_kernel(VerilatedContext *contextp, model_t *dut)
+        : contextp(contextp), model(dut), eval_fn(&eval_model<model_t>) { }
+
+      // A clock on pin with its first rising edge at offset; the pin is held
+      //   low until then. Returns the clock id.
+      int add_clock(uint8_t &pin, uint64_t period, uint64_t offset = 0) {
+        pin = 0;
+        dirty = true;
+        return add(&pin, period, offset);
+      }
+
+      // A timer with its first tick at offset. Returns the clock id.
+      int add_timer(uint64_t period, uint64_t offset = 0) {
+        return add(nullptr, period, offset);
+      }
+
+      void pre_edge(int id, callback cb) { clocks[id].pre.push_back(cb); }
+      void post_edge(int id, callback cb) { clocks[id].post.push_back(cb); }
+      void monitor(callback cb) { monitors.push_back(cb); }
+
+      // Called with the time after every eval, e.g. to dump a trace
+      void trace(std::function<void(uint64_t)> dump) { dump_fn = dump; }
+
+      // Inputs changed outside of a callback
+      void touch() { dirty = true; }
+
+      // Evaluates pending input changes at the current time
+      void settle() {
+        if (dirty)
+          eval();
+      }
+
+      // Stops run_until; the remaining callbacks of the step are skipped
+      void stop() { stopped = true; }
+      bool is_stopped() const { return stopped; }
+
+      uint64_t time() const { return now; }
+      uint64_t cycles(int id) const { return clocks[id].cycles; }
+      uint64_t evals() const { return eval_count; }
+
+      // Advances to the next edge time
+      void step() {
+        // Drive phase of the last rising edge
+        for (clock_s *c : rising)
+          for (auto &cb : c->post)
+            if (!stopped) {
+              cb();
+              dirty = true;
+            }
+
+        const uint64_t t = next;
+        now = t;
+        contextp->time(t);
+
+        // Falling edges first, finding the edge after this one as we go
+        next = std::numeric_limits<uint64_t>::max();
+        rising.clear();
+        bool falling = false, sampled = false;
+        for (clock_s &c : clocks) {
+          if (c.next == t) {
+            if (c.high) {
+              *c.pin = 0;
+              c.high = false;
+              c.next += c.period - c.period/2;
+              falling = true;
+            } else {
+              rising.push_back(&c);
+              sampled |= !c.pre.empty();
+              continue;
+            }
+          }
+          next = std::min(next, c.next);
+        }
+
+        // Without a rising edge, run_until does not check done after the step
+        mid_cycle = rising.empty();
+        if (mid_cycle) {
+          // Evaluated together with anything the last post_edge changed
+          eval();
+          return;
+        }
+
+        // Falling edges at t are folded into the settle or the rising edge
+        dirty |= falling;
+        if (sampled)
+          settle();
+        for (clock_s *c : rising)
+          for (auto &cb : c->pre)
+            if (!stopped)
+              cb();
+
+        bool edge = false;
+        for (clock_s *c : rising) {
+          if (c->pin) {
+            *c->pin = 1;
+            c->high = true;
+            c->next += c->period/2;
+            edge = true;
+          } else {
+            c->next += c->period;
+          }
+          c->cycles++;
+          next = std::min(next, c->next);
+        }
+        // Falling edges still need an eval at t if nothing settled them
+        if (edge || (dirty && falling))
+          eval();
+      }
+
+      // Runs n rising edges of clock id
+      void run(uint64_t n, int id = 0) {
+        stopped = false;
+        uint64_t target = clocks[id].cycles + n;
+        while (clocks[id].cycles < target)
+          step();
+      }
+
+      // Runs until done, stop() or the time reaches timeout; returns done().
+      //   done is checked after rising edges, before their drive phase.
+      template <typename done_t>
+      bool run_until(done_t done,
+                     uint64_t timeout = std::numeric_limits<uint64_t>::max()) {
+        stopped = false;
+        while (!stopped && now < timeout && (mid_cycle || !done()))
+          step();
+        return done();
+      }
+
+    private:
+      struct clock_s {
+        uint8_t *pin;
+        uint64_t period;
+        uint64_t next;
+        bool high = false;
+        uint64_t cycles = 0;
+        std::vector<callback> pre;
+        std::vector<callback> post;
+
+        clock_s(uint8_t *pin, uint64_t period, uint64_t offset)
+          : pin(pin), period(period), next(offset) { }
+      };
+
+      // Clocks are set up before the first step
+      int add(uint8_t *pin, uint64_t period, uint64_t offset) {
+        clocks.emplace_back(pin, period, offset);
+        rising.reserve(clocks.size());
+        next = std::min(next, offset);
+        return clocks.size() - 1;
+      }
+
+      template <typename model_t>
+      static void eval_model(void *dut) { static_cast<model_t *>(dut)->eval(); }
+
+      void eval() {
+        eval_fn(model);
+        eval_count++;
+        dirty = false;
+        if (dump_fn)
+          dump_fn(now);
+        for (auto &cb : monitors)
+          cb();
+      }
+
+      VerilatedContext *contextp;
+      void *model;
+      void (*eval_fn)(void *);
+      std::function<void(uint64_t)> dump_fn;
+
+      std::vector<clock_s> clocks;
+      std::vector<clock_s *> rising;
+      std::vector<callback> monitors;
+
+      uint64_t now = 0;
+      uint64_t next = std::numeric_limits<uint64_t>::max();
+      uint64_t eval_count = 0;
+      bool dirty = true;
+      bool stopped = false;
+      bool mid_cycle = false;
+  };
+
+#endif
+
@@ -2,7 +2,7 @@
 #include "svdpi.h"
 #include "verilated_fst_c.h"
 #include "Vtop.h"
-#include "bsg_nonsynth_dpi_clock_gen.hpp"
+#include "bsg_sim_kernel.h"
 
 #include "bp_pkg.h"
 #include "bp_me_wb_master_ctrl.h"
@@ -12,14 +12,6 @@
 #include <memory>
 #include <numeric>
 
-using namespace bsg_nonsynth_dpi;
-
-void tick(Vtop *dut, VerilatedFstC *tfp) {
-    bsg_timekeeper::next();
-    dut->eval();
-    tfp->dump(Verilated::time());
-}
-
 long count_bytes(std::vector<BP_pkg> packages) {
     long bytes = 0;
     for (const BP_pkg& package : packages)
@@ -127,16 +119,23 @@ int main(int argc, char* argv[]) {
     BP_me_WB_client_ctrl client_ctrl{test_size, seed};
 
     // simulate until all responses have been recieved
-    dut->eval();
-    tfp->dump(Verilated::time());
-
-    int i = 0;
-    while (!master_ctrl.done()) {
+    bsg_sim_kernel kernel(dut->contextp(), dut.get());
+    kernel.trace([&](uint64_t t) { tfp->dump(t); });
+    int clk = kernel.add_clock(dut->clk_i, 4, 2);
+    // The DPI fifos only accept calls in their window, so the controllers
+    // get a chance before every clock edge
+    auto sim = [&]() {
         master_ctrl.sim_read();
         client_ctrl.sim_read();
         client_ctrl.sim_write();
         master_ctrl.sim_write();
-        tick(dut.get(), tfp.get());
+    };
+    kernel.pre_edge(clk, sim);
+    kernel.post_edge(clk, sim);
+    kernel.settle();
+
+    while (!master_ctrl.done()) {
+        kernel.run(1, clk);
 
         // progress bar
         int len = 50;
@@ -17,12 +17,11 @@ module top
     , localparam wb_size_width_lp = `BSG_WIDTH(wb_sel_width_lp)
     , localparam wb_adr_width_lp = paddr_width_p - wb_sel_width_lp
 
-    , localparam cycle_time_lp      = 4
     , localparam reset_cycles_lo_lp = 0
     , localparam reset_cycles_hi_lp = 1
     , localparam debug_lp           = 0
   )
-  ();
+  (input clk_i);
 
   `declare_bp_bedrock_mem_if(paddr_width_p, did_width_p, lce_id_width_p, lce_assoc_p);
 
@@ -60,16 +59,10 @@ module top
   logic                               ack;
 
   /*
-   * generate clk and reset
+   * clk is driven by the simulation kernel in sim_main.cpp; generate reset
    */
   logic clk;
-  bsg_nonsynth_dpi_clock_gen
-    #(
-      .cycle_time_p(cycle_time_lp)
-    )
-    clock_gen(
-      .o(clk)
-    );
+  assign clk = clk_i;
 
   logic reset;
   bsg_nonsynth_reset_gen
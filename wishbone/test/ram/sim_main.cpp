@@ -2,22 +2,15 @@
 #include "svdpi.h"
 #include "verilated_fst_c.h"
 #include "Vtop.h"
-#include "bsg_nonsynth_dpi_clock_gen.hpp"
+#include "bsg_sim_kernel.h"
 
 #include "bp_pkg.h"
 #include "bp_me_wb_master_ctrl.h"
 
+#include <array>
 #include <iostream>
 #include <memory>
 
-using namespace bsg_nonsynth_dpi;
-
-void tick(Vtop *dut, VerilatedFstC *tfp) {
-    bsg_timekeeper::next();
-    dut->eval();
-    tfp->dump(Verilated::time());
-}
-
 uint8_t get_byte(uint64_t data, int i) {
     return (data >> (8*i)) & 0xFF;
 }
@@ -100,12 +93,21 @@ int main(int argc, char* argv[]) {
     BP_me_WB_master_ctrl ram_ctrl{test_size, seed};
 
     // simulate until all responses have been recieved
-    dut->eval();
-    tfp->dump(Verilated::time());
-    while (!ram_ctrl.done()) {
+    bsg_sim_kernel kernel(dut->contextp(), dut.get());
+    kernel.trace([&](uint64_t t) { tfp->dump(t); });
+    int clk = kernel.add_clock(dut->clk_i, 4, 2);
+    // The DPI fifos only accept calls in their window, so the controllers
+    // get a chance before every clock edge
+    auto sim = [&]() {
         ram_ctrl.sim_read();
         ram_ctrl.sim_write();
-        tick(dut.get(), tfp.get());
+    };
+    kernel.pre_edge(clk, sim);
+    kernel.post_edge(clk, sim);
+    kernel.settle();
+
+    while (!ram_ctrl.done()) {
+        kernel.run(1, clk);
 
         // progress bar
         int len = 50;
@@ -18,12 +18,11 @@ module top
 
     , localparam ram_size_lp     = 2**12
 
-    , localparam cycle_time_lp      = 4
     , localparam reset_cycles_lo_lp = 0
     , localparam reset_cycles_hi_lp = 1
     , localparam debug_lp           = 0
   )
-  ();
+  (input clk_i);
 
   `declare_bp_bedrock_mem_if(paddr_width_p, did_width_p, lce_id_width_p, lce_assoc_p);
 
@@ -52,16 +51,10 @@ module top
   logic                               ack;
 
   /*
-   * generate clk and reset
+   * clk is driven by the simulation kernel in sim_main.cpp; generate reset
    */
   logic clk;
-  bsg_nonsynth_dpi_clock_gen
-    #(
-      .cycle_time_p(cycle_time_lp)
-    )
-    clock_gen(
-      .o(clk)
-    );
+  assign clk = clk_i;
 
   logic reset;
   bsg_nonsynth_reset_gen
@@ -2,11 +2,95 @@
 #ifndef BSG_ZYNQ_UART_H
 #define BSG_ZYNQ_UART_H
 
+#include <stdint.h>
+#include <stddef.h>
+
+  // MUST be sync-ed to bsg_axil_uart_bridge
+  //
+  // Fields are listed LSB first, which is also the order of the bytes on the
+  //   UART (the bridge shifts the first byte into the LSB of the packet).
+  //   Use the helpers below rather than sending this struct directly.
   typedef struct {
-    uint32_t data : 32;
+    uint32_t burst : 1;
+    uint32_t wr_not_rd : 1;
     uint32_t addr30to2 : 30;
-    uint8_t wr_not_rd : 1;
-    uint8_t port : 1;
+    uint32_t data : 32;
   } __attribute__((packed, aligned(4))) bsg_zynq_uart_pkt_h;
 
+  #define BSG_ZYNQ_UART_PKT_BYTES  8
+  #define BSG_ZYNQ_UART_WORD_BYTES 4
+
+  static inline void bsg_zynq_uart_put_word(uint8_t *buf, uint32_t word) {
+    buf[0] = (word >>  0) & 0xff;
+    buf[1] = (word >>  8) & 0xff;
+    buf[2] = (word >> 16) & 0xff;
+    buf[3] = (word >> 24) & 0xff;
+  }
+
+  static inline uint32_t bsg_zynq_uart_get_word(const uint8_t *buf) {
+    return ((uint32_t) buf[0] <<  0)
+         | ((uint32_t) buf[1] <<  8)
+         | ((uint32_t) buf[2] << 16)
+         | ((uint32_t) buf[3] << 24);
+  }
+
+  // Serializes a packet header into BSG_ZYNQ_UART_PKT_BYTES bytes
+  static inline size_t bsg_zynq_uart_pack(uint8_t *buf, const bsg_zynq_uart_pkt_h *pkt) {
+    bsg_zynq_uart_put_word(&buf[0], ((uint32_t) pkt->addr30to2 << 2)
+                                  | ((uint32_t) pkt->wr_not_rd << 1)
+                                  | ((uint32_t) pkt->burst << 0));
+    bsg_zynq_uart_put_word(&buf[4], pkt->data);
+    return BSG_ZYNQ_UART_PKT_BYTES;
+  }
+
+  static inline size_t bsg_zynq_uart_unpack(const uint8_t *buf, bsg_zynq_uart_pkt_h *pkt) {
+    uint32_t lo = bsg_zynq_uart_get_word(&buf[0]);
+    pkt->burst = (lo >> 0) & 1;
+    pkt->wr_not_rd = (lo >> 1) & 1;
+    pkt->addr30to2 = lo >> 2;
+    pkt->data = bsg_zynq_uart_get_word(&buf[4]);
+    return BSG_ZYNQ_UART_PKT_BYTES;
+  }
+
+  // Single 32b write; nothing is returned
+  static inline size_t bsg_zynq_uart_pack_write(uint8_t *buf, uint32_t addr, uint32_t data) {
+    bsg_zynq_uart_pkt_h pkt = { 0, 1, addr >> 2, data };
+    return bsg_zynq_uart_pack(buf, &pkt);
+  }
+
+  // Single 32b read; one word is returned
+  static inline size_t bsg_zynq_uart_pack_read(uint8_t *buf, uint32_t addr) {
+    bsg_zynq_uart_pkt_h pkt = { 0, 0, addr >> 2, 0 };
+    return bsg_zynq_uart_pack(buf, &pkt);
+  }
+
+  // Bytes needed to pack a burst write of count words
+  static inline size_t bsg_zynq_uart_burst_write_bytes(uint32_t count) {
+    return BSG_ZYNQ_UART_PKT_BYTES + (size_t) count * BSG_ZYNQ_UART_WORD_BYTES;
+  }
+
+  // Header plus count words to sequential addresses; nothing is returned
+  static inline size_t bsg_zynq_uart_pack_burst_write(uint8_t *buf, uint32_t addr
+                                                      , const uint32_t *data, uint32_t count) {
+    bsg_zynq_uart_pkt_h pkt = { 1, 1, addr >> 2, count };
+    size_t n = bsg_zynq_uart_pack(buf, &pkt);
+    for (uint32_t i = 0; i < count; i++, n += BSG_ZYNQ_UART_WORD_BYTES)
+      bsg_zynq_uart_put_word(&buf[n], data[i]);
+    return n;
+  }
+
+  // Header only; count words are returned
+  static inline size_t bsg_zynq_uart_pack_burst_read(uint8_t *buf, uint32_t addr, uint32_t count) {
+    bsg_zynq_uart_pkt_h pkt = { 1, 0, addr >> 2, count };
+    return bsg_zynq_uart_pack(buf, &pkt);
+  }
+
+  // Read responses are count words, LSB first
+  static inline size_t bsg_zynq_uart_unpack_words(const uint8_t *buf, uint32_t *data, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++)
+      data[i] = bsg_zynq_uart_get_word(&buf[i*BSG_ZYNQ_UART_WORD_BYTES]);
+    return (size_t) count * BSG_ZYNQ_UART_WORD_BYTES;
+  }
+
 #endif
+
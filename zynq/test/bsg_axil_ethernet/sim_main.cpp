@@ -0,0 +1,1170 @@
+#include "Vbsg_axil_ethernet.h"
+#include "verilated.h"
+#include <cstdio>
+#include <cstdint>
+#include <iostream>
+#include <verilated_fst_c.h>
+#include <random>
+#include <queue>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <cassert>
+#include <unordered_map>
+#include <string>
+
+#include "bsg_sim_kernel.h"
+
+// Frames streamed in each direction
+#define RX_FRAMES 1000
+#define TX_FRAMES 1000
+// Packet buffer size the model is built with (eth_mtu_p); a 16KB buffer
+//   takes jumbo frames with a 9000B payload
+#ifndef ETH_MTU
+#define ETH_MTU 2048
+#endif
+// Frame sizes without FCS; the MAC pads anything shorter than 60B
+#define MIN_FRAME 60
+#define MAX_FRAME (ETH_MTU >= 16384 ? 9014 : 1514)
+// Frames longer than the MAC fifos' 4KB default; with jumbo buffers every
+//   LARGE_EVERY-th frame is MAX_FRAME long so that some always are
+#define LARGE_FRAME 4096
+#define LARGE_EVERY 8
+// Offered RX load as a percentage of gigabit line rate
+#define RX_LOAD_PERCENT 100
+#define IFG_BYTES 12
+// The sequence number sits past the IPv4/UDP headers of +csum frames
+#define SEQ_OFFSET 42
+
+// Clocks, in ps
+#define CLK_HALF_PS 4000   // AXIL clock, 125 MHz
+#define CLK_OFFSET_PS 1000
+#define CLK250_HALF_PS 2000
+#define IODELAY_HALF_PS 3000
+#define RGMII_HALF_PS 4000 // 125 MHz DDR, data centered between edges
+#define TIMEOUT_PS (200000000000ULL)
+
+// Outstanding AXIL requests issued by the software model
+#define AXIL_OUTSTANDING 8
+
+// Controller register map
+#define ETH_RX_BUF     0x0000
+#define ETH_TX_BUF     ETH_MTU
+// Registers follow the buffers; offsets below are for a 2KB buffer
+#define ETH_REG(addr)  (2 * ETH_MTU + (addr) - 0x1000)
+#define ETH_RX_SIZE    ETH_REG(0x1004)
+#define ETH_RX_PENDING ETH_REG(0x1010)
+#define ETH_RX_ENABLE  ETH_REG(0x1014)
+#define ETH_TX_SEND    ETH_REG(0x1018)
+#define ETH_TX_READY   ETH_REG(0x101C)
+#define ETH_TX_SIZE    ETH_REG(0x1028)
+#define ETH_RX_COALESCE_FRAMES  ETH_REG(0x1038)
+#define ETH_RX_COALESCE_TIMEOUT ETH_REG(0x103C)
+#define ETH_DEBUG      ETH_REG(0x1050)
+#define ETH_RX_CSUM    ETH_REG(0x1054)
+#define ETH_TX_CSUM    ETH_REG(0x1058)
+#define ETH_RX_DROPPED ETH_REG(0x106C)
+#define ETH_DMA_CTRL     ETH_REG(0x1080)
+#define ETH_DMA_RX_BASE  ETH_REG(0x1084)
+#define ETH_DMA_RX_SIZE  ETH_REG(0x1088)
+#define ETH_DMA_RX_SLOTS ETH_REG(0x108C)
+#define ETH_DMA_RX_PROD  ETH_REG(0x1090)
+#define ETH_DMA_RX_CONS  ETH_REG(0x1094)
+#define ETH_DMA_TX_ADDR  ETH_REG(0x1098)
+#define ETH_DMA_TX_LEN   ETH_REG(0x109C)
+#define ETH_DMA_TX_CSUM  ETH_REG(0x10A4)
+#define ETH_FILTER_CTRL    ETH_REG(0x10C0)
+#define ETH_FILTER_MAC_LO  ETH_REG(0x10C4)
+#define ETH_FILTER_MAC_HI  ETH_REG(0x10C8)
+#define ETH_FILTER_HASH_LO ETH_REG(0x10CC)
+#define ETH_FILTER_HASH_HI ETH_REG(0x10D0)
+#define ETH_FILTER_DROPPED ETH_REG(0x10D4) // unicast, multicast, broadcast
+
+// RX checksum status bits
+#define CSUM_IP_CHECKED 0x1
+#define CSUM_IP_GOOD    0x2
+#define CSUM_L4_CHECKED 0x4
+#define CSUM_L4_GOOD    0x8
+
+// RX interrupt coalescing used with +coalesce; timeout in AXIL clock cycles
+#define COALESCE_FRAMES  8
+#define COALESCE_TIMEOUT 1000
+
+// Station address and multicast groups used with +filter; make_frame sends
+//   to the station address
+const uint8_t station_mac[6] = {0x02, 0, 0, 0, 0, 0x02};
+const uint8_t mcast_groups[4][6] = {
+    {0x01, 0x00, 0x5e, 0x00, 0x00, 0x01},
+    {0x01, 0x00, 0x5e, 0x00, 0x00, 0xfb},
+    {0x33, 0x33, 0x00, 0x00, 0x00, 0x01},
+    {0x33, 0x33, 0xff, 0x00, 0x00, 0x02}};
+
+// Memory layout used in DMA mode (run with +dma)
+#define DMA_RX_BASE  0x00100000
+#define DMA_RX_SIZE  0x000f0000
+#define DMA_RX_SLOTS 16
+#define DMA_TX_BASE  0x00200000
+#define DMA_TX_BUFS  8
+#define DMA_SLOT_BYTES ETH_MTU
+
+using namespace std;
+
+// Set your seed here:
+#define SEED 9877
+mt19937 random_generator(SEED);
+uniform_int_distribution<uint32_t> distribution;
+auto dice = bind(distribution, random_generator);
+
+uint32_t crc32(const uint8_t *data, size_t len)
+{
+    uint32_t crc = 0xffffffff;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int j = 0; j < 8; j++)
+            crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+    }
+    return crc ^ 0xffffffff;
+}
+
+// Ethernet frame without preamble/FCS, carrying a sequence number
+vector<uint8_t> make_frame(uint32_t seq)
+{
+    size_t len = MIN_FRAME + dice() % (MAX_FRAME - MIN_FRAME + 1);
+    if (MAX_FRAME > LARGE_FRAME && seq % LARGE_EVERY == 0)
+        len = MAX_FRAME;
+    vector<uint8_t> frame(len);
+    const uint8_t header[14] = {0x02, 0, 0, 0, 0, 0x02, 0x02, 0, 0, 0, 0, 0x01, 0x88, 0xb5};
+    copy(header, header + 14, frame.begin());
+    for (size_t i = 14; i < len; i++)
+        frame[i] = dice() & 0xff;
+    for (int i = 0; i < 4; i++)
+        frame[SEQ_OFFSET + i] = (seq >> (8*i)) & 0xff;
+    return frame;
+}
+
+uint32_t frame_seq(const vector<uint8_t> &frame)
+{
+    uint32_t seq = 0;
+    for (int i = 0; i < 4; i++)
+        seq |= (uint32_t) frame[SEQ_OFFSET + i] << (8*i);
+    return seq;
+}
+
+// RFC 1071 sum of big-endian 16-bit words; data starts on an even offset
+uint32_t csum_add(uint32_t sum, const uint8_t *data, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+        sum += (i % 2 == 0) ? (data[i] << 8) : data[i];
+    return sum;
+}
+
+uint16_t csum_fold(uint32_t sum)
+{
+    while (sum >> 16)
+        sum = (sum & 0xffff) + (sum >> 16);
+    return sum;
+}
+
+// Offset of the TCP/UDP checksum field in frames from make_ip
+size_t l4_csum_offset(const vector<uint8_t> &frame)
+{
+    return (frame[23] == 17) ? 40 : 50;
+}
+
+// TCP/UDP pseudo header sum, folded but not complemented
+uint16_t l4_pseudo_sum(const vector<uint8_t> &frame)
+{
+    uint32_t l4_len = (frame[16] << 8 | frame[17]) - 20;
+    return csum_fold(csum_add(0, &frame[26], 8) + frame[23] + l4_len);
+}
+
+// Multicast hash bin: ether_crc_le(6, addr) >> 26
+uint32_t mcast_bin(const uint8_t *addr)
+{
+    uint32_t crc = 0xffffffff;
+    for (int i = 0; i < 6; i++) {
+        crc ^= addr[i];
+        for (int j = 0; j < 8; j++)
+            crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+    }
+    return crc >> 26;
+}
+
+uint64_t mcast_hash()
+{
+    uint64_t hash = 0;
+    for (const uint8_t *group : mcast_groups)
+        hash |= 1ULL << mcast_bin(group);
+    return hash;
+}
+
+enum { e_dst_station, e_dst_unicast, e_dst_broadcast, e_dst_joined, e_dst_multicast };
+
+// Rewrites the destination of a frame for +filter
+void make_dst(vector<uint8_t> &frame)
+{
+    uint32_t roll = dice() % 20;
+    int kind = (roll < 10) ? e_dst_station : (roll < 13) ? e_dst_unicast :
+               (roll < 15) ? e_dst_broadcast : (roll < 17) ? e_dst_joined : e_dst_multicast;
+    switch (kind) {
+        case e_dst_station:
+            copy(station_mac, station_mac + 6, frame.begin());
+            break;
+        case e_dst_unicast:
+            for (int i = 0; i < 6; i++)
+                frame[i] = dice() & 0xff;
+            frame[0] &= ~1;
+            break;
+        case e_dst_broadcast:
+            fill(frame.begin(), frame.begin() + 6, 0xff);
+            break;
+        case e_dst_joined: {
+            const uint8_t *group = mcast_groups[dice() % 4];
+            copy(group, group + 6, frame.begin());
+            break;
+        }
+        case e_dst_multicast:
+            for (int i = 0; i < 6; i++)
+                frame[i] = dice() & 0xff;
+            frame[0] |= 1;
+            break;
+    }
+}
+
+// Software reference for the address filter as the driver programs it
+bool filter_accept(const vector<uint8_t> &frame)
+{
+    if (equal(frame.begin(), frame.begin() + 6, station_mac))
+        return true;
+    if (all_of(frame.begin(), frame.begin() + 6, [](uint8_t b) { return b == 0xff; }))
+        return true;
+    return (frame[0] & 1) && ((mcast_hash() >> mcast_bin(frame.data())) & 1);
+}
+
+enum { e_csum_good, e_csum_bad_ip, e_csum_bad_l4, e_csum_no_udp, e_csum_fragment,
+       e_csum_padded, e_csum_raw, e_csum_kinds };
+
+// Turns a frame into IPv4 with a TCP or UDP header and valid checksums,
+//   then applies the given defect. The sequence number is left in place.
+void make_ip(vector<uint8_t> &frame, int kind)
+{
+    if (kind == e_csum_raw)
+        return;
+    bool udp = dice() % 2;
+    uint32_t ip_len = frame.size() - 14;
+    if (kind == e_csum_padded)
+        ip_len -= 1 + dice() % 6;
+    uint32_t l4_len = ip_len - 20;
+    frame[12] = 0x08;
+    frame[13] = 0x00;
+    frame[14] = 0x45;
+    frame[16] = ip_len >> 8;
+    frame[17] = ip_len & 0xff;
+    // Don't Fragment, or More Fragments for a fragment
+    frame[20] = (kind == e_csum_fragment) ? 0x20 : 0x40;
+    frame[21] = 0;
+    frame[23] = udp ? 17 : 6;
+    if (udp) {
+        frame[38] = l4_len >> 8;
+        frame[39] = l4_len & 0xff;
+    }
+    else {
+        frame[46] = 0x50;
+    }
+    size_t l4_at = l4_csum_offset(frame);
+    frame[24] = frame[25] = 0;
+    frame[l4_at] = frame[l4_at + 1] = 0;
+
+    uint16_t ip_csum = ~csum_fold(csum_add(0, &frame[14], 20));
+    uint16_t l4_csum = ~csum_fold(csum_add(l4_pseudo_sum(frame), &frame[34], l4_len));
+    // 0 means no checksum for UDP; both encodings are valid for TCP
+    if (l4_csum == 0)
+        l4_csum = 0xffff;
+    if (kind == e_csum_bad_ip)
+        ip_csum ^= 1 << (dice() % 16);
+    if (kind == e_csum_bad_l4)
+        l4_csum ^= 1 << (dice() % 16);
+    if (kind == e_csum_no_udp && udp)
+        l4_csum = 0;
+    frame[24] = ip_csum >> 8;
+    frame[25] = ip_csum & 0xff;
+    frame[l4_at] = l4_csum >> 8;
+    frame[l4_at + 1] = l4_csum & 0xff;
+}
+
+// Software reference for the RX checksum status of the controller
+uint32_t csum_status(const vector<uint8_t> &f)
+{
+    if (f.size() < 34 || f[12] != 0x08 || f[13] != 0x00 || (f[14] >> 4) != 4 || (f[14] & 0xf) < 5)
+        return 0;
+    uint32_t hdr_len = (f[14] & 0xf) * 4;
+    uint32_t ip_len = f[16] << 8 | f[17];
+    if (ip_len < hdr_len || f.size() < 14 + ip_len)
+        return 0;
+    uint32_t status = CSUM_IP_CHECKED;
+    if (csum_fold(csum_add(0, &f[14], hdr_len)) == 0xffff)
+        status |= CSUM_IP_GOOD;
+
+    bool fragment = (f[20] & 0x3f) != 0 || f[21] != 0;
+    bool udp = (f[23] == 17);
+    size_t l4 = 14 + hdr_len;
+    uint32_t l4_len = ip_len - hdr_len;
+    if (fragment || !(udp || f[23] == 6))
+        return status;
+    if (udp && f[l4 + 6] == 0 && f[l4 + 7] == 0)
+        return status;
+    status |= CSUM_L4_CHECKED;
+    uint32_t sum = csum_add(0, &f[26], 8) + f[23] + l4_len;
+    if (csum_fold(csum_add(sum, &f[l4], l4_len)) == 0xffff)
+        status |= CSUM_L4_GOOD;
+    return status;
+}
+
+// RGMII PHY at 1000M: drives frames into the RX pins with the clock centered
+//   on the data and decodes frames coming out of the TX pins
+class rgmii_phy {
+    private:
+        VL_IN8 (&rx_clk,0,0);
+        VL_IN8 (&rxd,3,0);
+        VL_IN8 (&rx_ctl,0,0);
+        VL_OUT8(&tx_clk,0,0);
+        VL_OUT8(&txd,3,0);
+        VL_OUT8(&tx_ctl,0,0);
+
+        // RX wire state
+        vector<uint8_t> wire;
+        size_t wire_idx = 0;
+        uint32_t wire_seq = 0;
+        uint64_t idle_bytes = 0;
+        uint8_t cur_byte = 0;
+        bool cur_dv = false;
+
+        // TX sampling state
+        uint8_t tx_clk_prev = 0, txd_prev = 0, tx_ctl_prev = 0;
+        uint8_t tx_lo = 0;
+        bool tx_en = false;
+        vector<uint8_t> tx_frame;
+
+    public:
+        vector<vector<uint8_t>> *rx_frames;
+        size_t rx_next = 0;
+        bool rx_enable = false;
+        vector<uint64_t> rx_end_ps;
+        uint64_t rx_first_ps = 0, rx_last_ps = 0;
+
+        deque<vector<uint8_t>> tx_expected;
+        uint64_t tx_received = 0, tx_errors = 0, tx_bytes = 0, tx_large = 0;
+        uint64_t tx_first_ps = 0, tx_last_ps = 0;
+
+        rgmii_phy(vector<vector<uint8_t>> *rx_frames,
+            VL_IN8 (&rx_clk,0,0), VL_IN8 (&rxd,3,0), VL_IN8 (&rx_ctl,0,0),
+            VL_OUT8(&tx_clk,0,0), VL_OUT8(&txd,3,0), VL_OUT8(&tx_ctl,0,0)):
+        rx_clk(rx_clk), rxd(rxd), rx_ctl(rx_ctl), tx_clk(tx_clk), txd(txd), tx_ctl(tx_ctl),
+        rx_frames(rx_frames), rx_end_ps(rx_frames->size(), 0) {
+            this->rx_clk = 0;
+            this->rxd = 0;
+            this->rx_ctl = 0;
+        }
+
+        bool rx_done() const { return rx_next == rx_frames->size() && wire.empty(); }
+
+        // Called a quarter period before each edge of rx_clk
+        void drive(uint64_t t)
+        {
+            if (rx_clk == 0) {
+                // Next edge is rising: pick a byte, low nibble and RX_DV
+                cur_dv = false;
+                if (!wire.empty()) {
+                    cur_byte = wire[wire_idx++];
+                    cur_dv = true;
+                    if (wire_idx == wire.size()) {
+                        wire.clear();
+                        rx_end_ps[wire_seq] = t;
+                        rx_last_ps = t;
+                        idle_bytes = IFG_BYTES;
+                        // Stretch the gap to the requested load
+                        idle_bytes += (uint64_t) wire_idx * (100 - RX_LOAD_PERCENT) / RX_LOAD_PERCENT;
+                    }
+                }
+                else if (idle_bytes != 0) {
+                    idle_bytes--;
+                }
+                else if (rx_enable && rx_next < rx_frames->size()) {
+                    const vector<uint8_t> &frame = (*rx_frames)[rx_next];
+                    wire.assign(7, 0x55);
+                    wire.push_back(0xd5);
+                    wire.insert(wire.end(), frame.begin(), frame.end());
+                    uint32_t fcs = crc32(frame.data(), frame.size());
+                    for (int i = 0; i < 4; i++)
+                        wire.push_back((fcs >> (8*i)) & 0xff);
+                    wire_idx = 0;
+                    wire_seq = rx_next++;
+                    if (wire_seq == 0)
+                        rx_first_ps = t;
+                    cur_byte = wire[wire_idx++];
+                    cur_dv = true;
+                }
+                rxd = cur_dv ? (cur_byte & 0xf) : 0;
+                rx_ctl = cur_dv;
+            }
+            else {
+                // Next edge is falling: high nibble and RX_DV ^ RX_ER
+                rxd = cur_dv ? (cur_byte >> 4) : 0;
+                rx_ctl = cur_dv;
+            }
+        }
+
+        // Called every time the DUT is evaluated; TX pins are sampled with
+        //   the values held just before the clock edge
+        void sample(uint64_t t)
+        {
+            if (tx_clk != tx_clk_prev) {
+                if (tx_clk) {
+                    tx_lo = txd_prev;
+                    tx_en = tx_ctl_prev;
+                }
+                else {
+                    bool tx_er = tx_en ^ tx_ctl_prev;
+                    if (tx_en && !tx_er) {
+                        tx_frame.push_back(tx_lo | (txd_prev << 4));
+                    }
+                    else if (!tx_frame.empty()) {
+                        check_tx(t);
+                        tx_frame.clear();
+                    }
+                }
+            }
+            tx_clk_prev = tx_clk;
+            txd_prev = txd;
+            tx_ctl_prev = tx_ctl;
+        }
+
+        void check_tx(uint64_t t)
+        {
+            bool ok = tx_frame.size() >= 8 + MIN_FRAME + 4;
+            for (int i = 0; ok && i < 7; i++)
+                ok = (tx_frame[i] == 0x55);
+            ok = ok && (tx_frame[7] == 0xd5);
+            vector<uint8_t> frame;
+            if (ok) {
+                frame.assign(tx_frame.begin() + 8, tx_frame.end() - 4);
+                uint32_t fcs = 0;
+                for (int i = 0; i < 4; i++)
+                    fcs |= (uint32_t) tx_frame[tx_frame.size() - 4 + i] << (8*i);
+                ok = (fcs == crc32(frame.data(), frame.size()));
+            }
+            ok = ok && !tx_expected.empty() && (frame == tx_expected.front());
+            if (!ok && tx_errors++ < 8)
+                printf("PHY received a bad TX frame (%lu bytes on the wire)\n", tx_frame.size());
+            if (!tx_expected.empty())
+                tx_expected.pop_front();
+            if (tx_received++ == 0)
+                tx_first_ps = t;
+            tx_last_ps = t;
+            tx_bytes += frame.size();
+            tx_large += ok && frame.size() > LARGE_FRAME;
+        }
+};
+
+// Pipelined AXIL master for the software model; a batch holds either
+//   reads or writes only, so responses return in issue order
+class axil_driver {
+    private:
+        struct op {
+            bool w;
+            uint32_t addr;
+            uint32_t data;
+        };
+        vector<op> batch;
+        size_t aw_idx = 0, w_idx = 0, ar_idx = 0, done_idx = 0;
+
+        VL_IN  (&axil_awaddr,31,0);
+        VL_IN8 (&axil_awprot,2,0);
+        VL_IN8 (&axil_awvalid,0,0);
+        VL_OUT8(&axil_awready,0,0);
+        VL_IN  (&axil_wdata,31,0);
+        VL_IN8 (&axil_wstrb,3,0);
+        VL_IN8 (&axil_wvalid,0,0);
+        VL_OUT8(&axil_wready,0,0);
+        VL_OUT8(&axil_bresp,1,0);
+        VL_OUT8(&axil_bvalid,0,0);
+        VL_IN8 (&axil_bready,0,0);
+        VL_IN  (&axil_araddr,31,0);
+        VL_IN8 (&axil_arprot,2,0);
+        VL_IN8 (&axil_arvalid,0,0);
+        VL_OUT8(&axil_arready,0,0);
+        VL_OUT (&axil_rdata,31,0);
+        VL_OUT8(&axil_rresp,1,0);
+        VL_OUT8(&axil_rvalid,0,0);
+        VL_IN8 (&axil_rready,0,0);
+
+    public:
+        vector<uint32_t> rdata;
+        uint64_t accesses = 0;
+
+        axil_driver(
+            VL_IN  (&axil_awaddr,31,0),VL_IN8 (&axil_awprot,2,0),
+            VL_IN8 (&axil_awvalid,0,0),VL_OUT8(&axil_awready,0,0),
+            VL_IN  (&axil_wdata,31,0), VL_IN8 (&axil_wstrb,3,0),
+            VL_IN8 (&axil_wvalid,0,0), VL_OUT8(&axil_wready,0,0),
+            VL_OUT8(&axil_bresp,1,0),  VL_OUT8(&axil_bvalid,0,0),
+            VL_IN8 (&axil_bready,0,0), VL_IN  (&axil_araddr,31,0),
+            VL_IN8 (&axil_arprot,2,0), VL_IN8 (&axil_arvalid,0,0),
+            VL_OUT8(&axil_arready,0,0),VL_OUT (&axil_rdata,31,0),
+            VL_OUT8(&axil_rresp,1,0),  VL_OUT8(&axil_rvalid,0,0),
+            VL_IN8 (&axil_rready,0,0)):
+        axil_awaddr (axil_awaddr), axil_awprot (axil_awprot),
+        axil_awvalid(axil_awvalid), axil_awready(axil_awready),
+        axil_wdata  (axil_wdata), axil_wstrb  (axil_wstrb),
+        axil_wvalid (axil_wvalid), axil_wready (axil_wready),
+        axil_bresp  (axil_bresp), axil_bvalid (axil_bvalid),
+        axil_bready (axil_bready), axil_araddr (axil_araddr),
+        axil_arprot (axil_arprot), axil_arvalid(axil_arvalid),
+        axil_arready(axil_arready), axil_rdata  (axil_rdata),
+        axil_rresp  (axil_rresp), axil_rvalid (axil_rvalid),
+        axil_rready (axil_rready) {
+            this->axil_awaddr = 0;
+            this->axil_awprot = 0;
+            this->axil_awvalid = 0;
+            this->axil_wdata = 0;
+            this->axil_wstrb = 0;
+            this->axil_wvalid = 0;
+            this->axil_bready = 0;
+            this->axil_araddr = 0;
+            this->axil_arprot = 0;
+            this->axil_arvalid = 0;
+            this->axil_rready = 0;
+        }
+
+        bool idle() const { return done_idx == batch.size(); }
+
+        void write(uint32_t addr, uint32_t data) { batch.push_back({true, addr, data}); }
+        void read(uint32_t addr) { batch.push_back({false, addr, 0}); }
+
+        void start()
+        {
+            aw_idx = w_idx = ar_idx = done_idx = 0;
+            rdata.clear();
+        }
+
+        void clear()
+        {
+            batch.clear();
+            start();
+        }
+
+        void sim(bool post_read)
+        {
+            if (post_read == false) {
+                size_t limit = min(batch.size(), done_idx + AXIL_OUTSTANDING);
+                bool writes = !batch.empty() && batch[0].w;
+                axil_awvalid = writes && aw_idx < limit;
+                axil_awaddr = axil_awvalid ? batch[aw_idx].addr : 0;
+                axil_wvalid = writes && w_idx < limit;
+                axil_wdata = axil_wvalid ? batch[w_idx].data : 0;
+                axil_wstrb = 0xf;
+                axil_arvalid = !writes && ar_idx < limit;
+                axil_araddr = axil_arvalid ? batch[ar_idx].addr : 0;
+                axil_bready = 1;
+                axil_rready = 1;
+            }
+            else {
+                if (axil_awvalid == 1 && axil_awready == 1)
+                    aw_idx++;
+                if (axil_wvalid == 1 && axil_wready == 1)
+                    w_idx++;
+                if (axil_arvalid == 1 && axil_arready == 1)
+                    ar_idx++;
+                if (axil_bvalid == 1 && axil_bready == 1) {
+                    done_idx++;
+                    accesses++;
+                }
+                if (axil_rvalid == 1 && axil_rready == 1) {
+                    rdata.push_back(axil_rdata);
+                    done_idx++;
+                    accesses++;
+                }
+            }
+        }
+};
+
+// Memory behind the DMA master port; software accesses it directly
+class dma_mem {
+    private:
+        unordered_map<uint32_t, uint32_t> mem;
+        queue<uint32_t> r_data;
+        uint32_t b_pending = 0;
+
+        VL_OUT (&axil_awaddr,31,0);
+        VL_OUT8(&axil_awvalid,0,0);
+        VL_IN8 (&axil_awready,0,0);
+        VL_OUT (&axil_wdata,31,0);
+        VL_OUT8(&axil_wstrb,3,0);
+        VL_OUT8(&axil_wvalid,0,0);
+        VL_IN8 (&axil_wready,0,0);
+        VL_IN8 (&axil_bresp,1,0);
+        VL_IN8 (&axil_bvalid,0,0);
+        VL_OUT8(&axil_bready,0,0);
+        VL_OUT (&axil_araddr,31,0);
+        VL_OUT8(&axil_arvalid,0,0);
+        VL_IN8 (&axil_arready,0,0);
+        VL_IN  (&axil_rdata,31,0);
+        VL_IN8 (&axil_rresp,1,0);
+        VL_IN8 (&axil_rvalid,0,0);
+        VL_OUT8(&axil_rready,0,0);
+
+    public:
+        uint64_t writes = 0;
+        uint64_t reads = 0;
+
+        dma_mem(
+            VL_OUT (&axil_awaddr,31,0), VL_OUT8(&axil_awvalid,0,0),
+            VL_IN8 (&axil_awready,0,0), VL_OUT (&axil_wdata,31,0),
+            VL_OUT8(&axil_wstrb,3,0),   VL_OUT8(&axil_wvalid,0,0),
+            VL_IN8 (&axil_wready,0,0),  VL_IN8 (&axil_bresp,1,0),
+            VL_IN8 (&axil_bvalid,0,0),  VL_OUT8(&axil_bready,0,0),
+            VL_OUT (&axil_araddr,31,0), VL_OUT8(&axil_arvalid,0,0),
+            VL_IN8 (&axil_arready,0,0), VL_IN  (&axil_rdata,31,0),
+            VL_IN8 (&axil_rresp,1,0),   VL_IN8 (&axil_rvalid,0,0),
+            VL_OUT8(&axil_rready,0,0)):
+                axil_awaddr (axil_awaddr), axil_awvalid(axil_awvalid),
+                axil_awready(axil_awready), axil_wdata  (axil_wdata),
+                axil_wstrb  (axil_wstrb), axil_wvalid (axil_wvalid),
+                axil_wready (axil_wready), axil_bresp  (axil_bresp),
+                axil_bvalid (axil_bvalid), axil_bready (axil_bready),
+                axil_araddr (axil_araddr), axil_arvalid(axil_arvalid),
+                axil_arready(axil_arready), axil_rdata  (axil_rdata),
+                axil_rresp  (axil_rresp), axil_rvalid (axil_rvalid),
+                axil_rready (axil_rready) {
+                    this->axil_awready = 0;
+                    this->axil_wready = 0;
+                    this->axil_bresp = 0;
+                    this->axil_bvalid = 0;
+                    this->axil_arready = 0;
+                    this->axil_rdata = 0;
+                    this->axil_rresp = 0;
+                    this->axil_rvalid = 0;
+               }
+
+        uint32_t read(uint32_t addr) { return mem[addr & ~3U]; }
+        void write(uint32_t addr, uint32_t data) { mem[addr & ~3U] = data; }
+
+        // Responses return one cycle after the request
+        void sim(bool post_read)
+        {
+            if (post_read == false) {
+                axil_bvalid = (b_pending != 0);
+                axil_bresp = 0;
+                axil_rvalid = !r_data.empty();
+                axil_rdata = r_data.empty() ? 0 : r_data.front();
+                axil_rresp = 0;
+                axil_awready = axil_awvalid && axil_wvalid;
+                axil_wready = axil_awvalid && axil_wvalid;
+                axil_arready = 1;
+            }
+            else {
+                if (axil_bvalid == 1 && axil_bready == 1)
+                    b_pending--;
+                if (axil_rvalid == 1 && axil_rready == 1)
+                    r_data.pop();
+                if (axil_awvalid == 1 && axil_awready == 1) {
+                    uint32_t &word = mem[axil_awaddr & ~3U];
+                    for (int i = 0; i < 4; i++)
+                        if (axil_wstrb & (1U << i))
+                            word = (word & ~(0xffU << (8*i))) | (axil_wdata & (0xffU << (8*i)));
+                    b_pending++;
+                    writes++;
+                }
+                if (axil_arvalid == 1 && axil_arready == 1) {
+                    r_data.push(mem[axil_araddr & ~3U]);
+                    reads++;
+                }
+            }
+        }
+};
+
+// Interrupt-driven Liteeth-style driver: services RX first whenever the
+//   interrupt is raised and otherwise keeps the TX ring busy. With a memory
+//   model, frames move through the DMA rings and only indices, descriptors
+//   and doorbells go over AXIL.
+class eth_driver {
+    private:
+        enum { e_init, e_link, e_dma_config, e_idle, e_rx_size, e_rx_data, e_rx_ack,
+               e_tx_ready, e_tx_send, e_stats, e_done } state = e_init;
+        axil_driver *bus;
+        rgmii_phy *phy;
+        dma_mem *mem;
+        bool coalesce;
+        bool csum;
+        bool filter;
+        uint32_t rx_cons = 0;
+        // Keep draining RX after an interrupt until nothing is left
+        bool servicing = false;
+        vector<vector<uint8_t>> *rx_frames;
+        vector<vector<uint8_t>> *tx_frames;
+        uint32_t rx_size = 0;
+        uint32_t rx_status = 0;
+        int64_t rx_last_seq = -1;
+        size_t tx_next = 0;
+        bool irq_prev = false;
+        uint64_t irq_rise_ps = 0;
+        bool irq_waiting = false;
+
+    public:
+        uint64_t rx_received = 0, rx_errors = 0, rx_dropped = 0, rx_bytes = 0, rx_large = 0;
+        uint64_t rx_hw_dropped = 0;
+        // Frames the address filter should have dropped, and its counters
+        uint64_t rx_filter_errors = 0, rx_filtered = 0, rx_hw_filtered = 0;
+        uint64_t irq_count = 0, irq_latency_sum = 0, irq_latency_max = 0;
+        uint64_t frame_latency_sum = 0, frame_latency_max = 0;
+        uint64_t rx_service_last_ps = 0;
+        // TX ready reads that found no space
+        uint64_t tx_polls = 0;
+        // RX checksum status: bad checksums flagged, statuses differing from software
+        uint64_t rx_csum_verified = 0, rx_csum_bad = 0, rx_csum_errors = 0;
+
+        eth_driver(axil_driver *bus, rgmii_phy *phy, dma_mem *mem, bool coalesce, bool csum,
+            bool filter, vector<vector<uint8_t>> *rx_frames, vector<vector<uint8_t>> *tx_frames):
+        bus(bus), phy(phy), mem(mem), coalesce(coalesce), csum(csum), filter(filter),
+        rx_frames(rx_frames), tx_frames(tx_frames) {
+            for (const vector<uint8_t> &frame : *rx_frames)
+                rx_filtered += !accepted(frame);
+        }
+
+        bool accepted(const vector<uint8_t> &frame) const { return !filter || filter_accept(frame); }
+
+        bool done() const { return state == e_done; }
+
+        // Called once per AXIL clock, after the bus model
+        void sim(uint64_t t, bool irq)
+        {
+            if (irq && !irq_prev) {
+                irq_rise_ps = t;
+                irq_waiting = true;
+            }
+            irq_prev = irq;
+
+            if (!bus->idle())
+                return;
+
+            switch (state) {
+                case e_init:
+                    bus->clear();
+                    bus->write(ETH_RX_ENABLE, 1);
+                    if (coalesce) {
+                        bus->write(ETH_RX_COALESCE_FRAMES, COALESCE_FRAMES);
+                        bus->write(ETH_RX_COALESCE_TIMEOUT, COALESCE_TIMEOUT);
+                    }
+                    if (filter) {
+                        uint64_t hash = mcast_hash();
+                        bus->write(ETH_FILTER_MAC_LO, station_mac[0] | station_mac[1] << 8
+                            | station_mac[2] << 16 | (uint32_t) station_mac[3] << 24);
+                        bus->write(ETH_FILTER_MAC_HI, station_mac[4] | station_mac[5] << 8);
+                        bus->write(ETH_FILTER_HASH_LO, hash & 0xffffffff);
+                        bus->write(ETH_FILTER_HASH_HI, hash >> 32);
+                        // Broadcast only
+                        bus->write(ETH_FILTER_CTRL, 0x2);
+                    }
+                    bus->start();
+                    state = e_link;
+                    break;
+                case e_link:
+                    // Wait for the MAC to detect 1000M on the RX clock
+                    if (!bus->rdata.empty() && (bus->rdata[0] & 0x3) == 0x2) {
+                        if (mem) {
+                            bus->clear();
+                            bus->write(ETH_DMA_RX_BASE, DMA_RX_BASE);
+                            bus->write(ETH_DMA_RX_SIZE, DMA_RX_SIZE);
+                            bus->write(ETH_DMA_RX_SLOTS, DMA_RX_SLOTS);
+                            bus->write(ETH_DMA_CTRL, 0x3);
+                            bus->start();
+                            state = e_dma_config;
+                        }
+                        else {
+                            phy->rx_enable = true;
+                            state = e_idle;
+                        }
+                    }
+                    else {
+                        bus->clear();
+                        bus->read(ETH_DEBUG);
+                        bus->start();
+                    }
+                    break;
+                case e_dma_config:
+                    phy->rx_enable = true;
+                    state = e_idle;
+                    break;
+                case e_idle:
+                    bus->clear();
+                    if (irq || servicing) {
+                        servicing = true;
+                        if (irq_waiting) {
+                            uint64_t latency = t - irq_rise_ps;
+                            irq_count++;
+                            irq_latency_sum += latency;
+                            irq_latency_max = max(irq_latency_max, latency);
+                            irq_waiting = false;
+                        }
+                        bus->read(mem ? ETH_DMA_RX_PROD : ETH_RX_SIZE);
+                        if (csum && !mem)
+                            bus->read(ETH_RX_CSUM);
+                        bus->start();
+                        state = e_rx_size;
+                    }
+                    else if (tx_next < tx_frames->size()) {
+                        bus->read(mem ? ETH_DMA_TX_LEN : ETH_TX_READY);
+                        bus->start();
+                        state = e_tx_ready;
+                    }
+                    else if (phy->rx_done() && phy->tx_expected.empty()) {
+                        bus->read(ETH_RX_DROPPED);
+                        for (int i = 0; i < 3; i++)
+                            bus->read(ETH_FILTER_DROPPED + 4*i);
+                        bus->start();
+                        state = e_stats;
+                    }
+                    break;
+                case e_rx_size:
+                    if (mem) {
+                        // Drain every completed slot, then return them with one doorbell
+                        uint32_t prod = bus->rdata[0] & 0xffff;
+                        for (; rx_cons != prod; rx_cons = (rx_cons + 1) & 0xffff) {
+                            uint32_t slot = rx_cons % DMA_RX_SLOTS;
+                            uint32_t size_word = mem->read(DMA_RX_SIZE + 4*slot);
+                            rx_size = size_word & 0xffff;
+                            rx_status = (size_word >> 16) & 0xf;
+                            vector<uint8_t> frame(rx_size);
+                            for (uint32_t i = 0; i < rx_size; i++)
+                                frame[i] = (mem->read(DMA_RX_BASE + slot*DMA_SLOT_BYTES + (i & ~3U)) >> (8 * (i % 4))) & 0xff;
+                            check_rx(t, frame);
+                        }
+                        bus->clear();
+                        bus->write(ETH_DMA_RX_CONS, rx_cons);
+                        bus->start();
+                        servicing = false;
+                        state = e_rx_ack;
+                        break;
+                    }
+                    rx_size = bus->rdata[0];
+                    if (csum)
+                        rx_status = bus->rdata[1];
+                    if (rx_size == 0) {
+                        servicing = false;
+                        state = e_idle;
+                        break;
+                    }
+                    bus->clear();
+                    for (uint32_t i = 0; i < (rx_size + 3) / 4; i++)
+                        bus->read(ETH_RX_BUF + 4*i);
+                    bus->start();
+                    state = e_rx_data;
+                    break;
+                case e_rx_data: {
+                    vector<uint8_t> frame(rx_size);
+                    for (uint32_t i = 0; i < rx_size; i++)
+                        frame[i] = (bus->rdata[i / 4] >> (8 * (i % 4))) & 0xff;
+                    check_rx(t, frame);
+                    bus->clear();
+                    bus->write(ETH_RX_PENDING, 1);
+                    bus->start();
+                    state = e_rx_ack;
+                    break;
+                }
+                case e_rx_ack:
+                    rx_service_last_ps = t;
+                    state = e_idle;
+                    break;
+                case e_tx_ready:
+                    if (bus->rdata[0] & 1) {
+                        // At most 4 descriptors are queued, so a buffer is fetched
+                        //   before it is reused
+                        uint32_t buf = DMA_TX_BASE + (tx_next % DMA_TX_BUFS) * DMA_SLOT_BYTES;
+                        const vector<uint8_t> &expected = (*tx_frames)[tx_next++];
+                        vector<uint8_t> frame = expected;
+                        bus->clear();
+                        if (csum) {
+                            // Offload the TCP/UDP checksum, seeded with the pseudo header
+                            size_t l4_at = l4_csum_offset(frame);
+                            uint16_t pseudo = l4_pseudo_sum(frame);
+                            frame[l4_at] = pseudo >> 8;
+                            frame[l4_at + 1] = pseudo & 0xff;
+                            bus->write(mem ? ETH_DMA_TX_CSUM : ETH_TX_CSUM,
+                                (1U << 31) | (l4_at << 16) | 34);
+                        }
+                        for (size_t i = 0; i < frame.size(); i += 4) {
+                            uint32_t word = 0;
+                            for (size_t j = 0; j < 4 && i + j < frame.size(); j++)
+                                word |= (uint32_t) frame[i + j] << (8*j);
+                            if (mem)
+                                mem->write(buf + i, word);
+                            else
+                                bus->write(ETH_TX_BUF + i, word);
+                        }
+                        if (mem) {
+                            bus->write(ETH_DMA_TX_ADDR, buf);
+                            bus->write(ETH_DMA_TX_LEN, frame.size());
+                        }
+                        else {
+                            bus->write(ETH_TX_SIZE, frame.size());
+                            bus->write(ETH_TX_SEND, 1);
+                        }
+                        bus->start();
+                        phy->tx_expected.push_back(expected);
+                        state = e_tx_send;
+                    }
+                    else {
+                        tx_polls++;
+                        state = e_idle;
+                    }
+                    break;
+                case e_tx_send:
+                    state = e_idle;
+                    break;
+                case e_stats:
+                    rx_hw_dropped = bus->rdata[0];
+                    rx_hw_filtered = bus->rdata[1] + bus->rdata[2] + bus->rdata[3];
+                    state = e_done;
+                    break;
+                case e_done:
+                    break;
+            }
+        }
+
+        void check_rx(uint64_t t, const vector<uint8_t> &frame)
+        {
+            uint32_t size = frame.size();
+            uint32_t seq = (size >= 18) ? frame_seq(frame) : ~0U;
+            if (seq >= rx_frames->size() || (int64_t) seq <= rx_last_seq || frame != (*rx_frames)[seq]) {
+                if (rx_errors++ < 8)
+                    printf("driver received a bad RX frame (%u bytes)\n", size);
+                return;
+            }
+            if (!accepted(frame) && rx_filter_errors++ < 8)
+                printf("frame %u: received but should have been filtered\n", seq);
+            if (csum) {
+                uint32_t expected = csum_status(frame);
+                if (rx_status != expected && rx_csum_errors++ < 8)
+                    printf("frame %u: checksum status %x, expected %x\n", seq, rx_status, expected);
+                if ((rx_status & CSUM_IP_CHECKED) && !(rx_status & CSUM_IP_GOOD))
+                    rx_csum_bad++;
+                else if ((rx_status & CSUM_L4_CHECKED) && !(rx_status & CSUM_L4_GOOD))
+                    rx_csum_bad++;
+                else if (rx_status & CSUM_L4_CHECKED)
+                    rx_csum_verified++;
+            }
+            count_dropped(seq);
+            rx_last_seq = seq;
+            rx_received++;
+            rx_bytes += size;
+            rx_large += size > LARGE_FRAME;
+            uint64_t latency = t - phy->rx_end_ps[seq];
+            frame_latency_sum += latency;
+            frame_latency_max = max(frame_latency_max, latency);
+        }
+
+        // Frames skipped before seq that the filter would have accepted
+        void count_dropped(uint32_t seq)
+        {
+            for (uint32_t i = rx_last_seq + 1; i < seq; i++)
+                rx_dropped += accepted((*rx_frames)[i]);
+        }
+
+        void finish()
+        {
+            count_dropped(rx_frames->size());
+        }
+};
+
+int main(int argc, char **argv, char **env)
+{
+    unique_ptr<VerilatedContext> contextp(new VerilatedContext);
+    contextp->commandArgs(argc, argv);
+    unique_ptr<VerilatedFstC> tfp(new VerilatedFstC);
+    contextp->traceEverOn(VM_TRACE_FST);
+    unique_ptr<Vbsg_axil_ethernet> dut(new Vbsg_axil_ethernet(contextp.get()));
+
+    dut->trace(tfp.get(), 10);
+    tfp->open("dump.fst");
+
+    vector<vector<uint8_t>> rx_frames, tx_frames;
+    bool dma = (string(contextp->commandArgsPlusMatch("dma")) == "+dma");
+    bool coalesce = (string(contextp->commandArgsPlusMatch("coalesce")) == "+coalesce");
+    bool csum = (string(contextp->commandArgsPlusMatch("csum")) == "+csum");
+    bool filter = (string(contextp->commandArgsPlusMatch("filter")) == "+filter");
+    for (uint32_t i = 0; i < RX_FRAMES; i++) {
+        rx_frames.push_back(make_frame(i));
+        if (csum)
+            make_ip(rx_frames.back(), dice() % e_csum_kinds);
+        if (filter)
+            make_dst(rx_frames.back());
+    }
+    for (uint32_t i = 0; i < TX_FRAMES; i++) {
+        tx_frames.push_back(make_frame(i));
+        if (csum)
+            make_ip(tx_frames.back(), e_csum_good);
+    }
+    uint64_t rx_large = count_if(rx_frames.begin(), rx_frames.end(),
+        [](const vector<uint8_t> &f) { return f.size() > LARGE_FRAME; });
+    uint64_t tx_large = count_if(tx_frames.begin(), tx_frames.end(),
+        [](const vector<uint8_t> &f) { return f.size() > LARGE_FRAME; });
+
+    rgmii_phy phy(&rx_frames,
+        dut->rgmii_rx_clk_i,
+        dut->rgmii_rxd_i,
+        dut->rgmii_rx_ctl_i,
+        dut->rgmii_tx_clk_o,
+        dut->rgmii_txd_o,
+        dut->rgmii_tx_ctl_o
+    );
+    axil_driver bus(
+        dut->s00_axi_awaddr,
+        dut->s00_axi_awprot,
+        dut->s00_axi_awvalid,
+        dut->s00_axi_awready,
+        dut->s00_axi_wdata,
+        dut->s00_axi_wstrb,
+        dut->s00_axi_wvalid,
+        dut->s00_axi_wready,
+        dut->s00_axi_bresp,
+        dut->s00_axi_bvalid,
+        dut->s00_axi_bready,
+        dut->s00_axi_araddr,
+        dut->s00_axi_arprot,
+        dut->s00_axi_arvalid,
+        dut->s00_axi_arready,
+        dut->s00_axi_rdata,
+        dut->s00_axi_rresp,
+        dut->s00_axi_rvalid,
+        dut->s00_axi_rready
+    );
+    dma_mem mem(
+        dut->m00_axi_awaddr,
+        dut->m00_axi_awvalid,
+        dut->m00_axi_awready,
+        dut->m00_axi_wdata,
+        dut->m00_axi_wstrb,
+        dut->m00_axi_wvalid,
+        dut->m00_axi_wready,
+        dut->m00_axi_bresp,
+        dut->m00_axi_bvalid,
+        dut->m00_axi_bready,
+        dut->m00_axi_araddr,
+        dut->m00_axi_arvalid,
+        dut->m00_axi_arready,
+        dut->m00_axi_rdata,
+        dut->m00_axi_rresp,
+        dut->m00_axi_rvalid,
+        dut->m00_axi_rready
+    );
+    eth_driver driver(&bus, &phy, dma ? &mem : NULL, coalesce, csum, filter, &rx_frames, &tx_frames);
+
+    dut->reset_i = 1;
+    dut->clk250_reset_i = 1;
+    dut->tx_clk_gen_reset_i = 1;
+    dut->tx_reset_i = 1;
+    dut->rx_reset_i = 1;
+    bsg_sim_kernel kernel(contextp.get(), dut.get());
+    kernel.trace([&](uint64_t t) { tfp->dump(t); });
+    int clk = kernel.add_clock(dut->clk_i, 2 * CLK_HALF_PS, CLK_OFFSET_PS);
+    kernel.add_clock(dut->clk250_i, 2 * CLK250_HALF_PS, CLK250_HALF_PS);
+    kernel.add_clock(dut->iodelay_ref_clk_i, 2 * IODELAY_HALF_PS, IODELAY_HALF_PS);
+    kernel.add_clock(dut->rgmii_rx_clk_i, 2 * RGMII_HALF_PS, RGMII_HALF_PS);
+    // RX data is centered between the edges of the RGMII RX clock
+    int rgmii_data = kernel.add_timer(RGMII_HALF_PS, RGMII_HALF_PS / 2);
+
+    kernel.post_edge(rgmii_data, [&]() { phy.drive(kernel.time()); });
+    kernel.monitor([&]() { phy.sample(kernel.time()); });
+    // Complete the handshakes seen before the rising edge, then drive the next cycle
+    kernel.pre_edge(clk, [&]() {
+        if (!dut->reset_i) {
+            bus.sim(true);
+            mem.sim(true);
+        }
+    });
+    kernel.post_edge(clk, [&]() {
+        if (!dut->reset_i) {
+            driver.sim(kernel.time(), dut->irq_o);
+            bus.sim(false);
+            mem.sim(false);
+        }
+    });
+    kernel.settle();
+
+    // Resets are released in order: clk250 -> tx -> rx -> user logic
+    const struct {
+        uint64_t ps;
+        uint8_t *reset;
+    } releases[] = {
+        {4000, &dut->tx_clk_gen_reset_i},
+        {1200000, &dut->clk250_reset_i},
+        {1300000, &dut->tx_reset_i},
+        {1400000, &dut->rx_reset_i},
+        {1500000, &dut->reset_i},
+    };
+    for (const auto &r : releases) {
+        kernel.run_until([&]() { return kernel.time() >= r.ps; });
+        *r.reset = 0;
+        kernel.touch();
+    }
+    kernel.run_until([&]() { return driver.done(); }, TIMEOUT_PS);
+    driver.finish();
+
+    printf("Total simulation time: %lu\n", contextp->time());
+    tfp->close();
+
+    double rx_s = (double) (driver.rx_service_last_ps - phy.rx_first_ps) * 1e-12;
+    double tx_s = (double) (phy.tx_last_ps - phy.tx_first_ps) * 1e-12;
+    printf("RX: %lu/%d frames, %lu dropped (controller counted %lu), %lu bad\n",
+        driver.rx_received, RX_FRAMES, driver.rx_dropped, driver.rx_hw_dropped, driver.rx_errors);
+    printf("RX: %.0f frames/s, %.1f Mb/s at %d%% offered load\n",
+        driver.rx_received / rx_s, driver.rx_bytes * 8 / rx_s / 1e6, RX_LOAD_PERCENT);
+    printf("TX: %lu/%d frames, %lu bad\n", phy.tx_received, TX_FRAMES, phy.tx_errors);
+    printf("TX: %.0f frames/s, %.1f Mb/s\n",
+        phy.tx_received / tx_s, phy.tx_bytes * 8 / tx_s / 1e6);
+    if (driver.irq_count != 0)
+        printf("IRQ to service: avg %lu ns, max %lu ns over %lu interrupts\n",
+            driver.irq_latency_sum / driver.irq_count / 1000, driver.irq_latency_max / 1000,
+            driver.irq_count);
+    if (driver.irq_count != 0)
+        printf("Frames per interrupt: %.2f%s\n", (double) driver.rx_received / driver.irq_count,
+            coalesce ? " (coalesced)" : "");
+    if (driver.rx_received != 0)
+        printf("Wire to software: avg %lu ns, max %lu ns\n",
+            driver.frame_latency_sum / driver.rx_received / 1000, driver.frame_latency_max / 1000);
+    printf("Mode: %s, %dB buffers\n", dma ? "DMA" : "MMIO", ETH_MTU);
+    if (rx_large + tx_large != 0)
+        printf("Frames over %dB: RX %lu/%lu, TX %lu/%lu\n", LARGE_FRAME,
+            driver.rx_large, rx_large, phy.tx_large, tx_large);
+    printf("AXIL accesses: %lu, %lu of them TX space polls (%.1f per frame otherwise)\n",
+        bus.accesses, driver.tx_polls,
+        (double) (bus.accesses - driver.tx_polls) / (driver.rx_received + phy.tx_received));
+    if (dma)
+        printf("DMA accesses: %lu writes, %lu reads\n", mem.writes, mem.reads);
+    if (filter)
+        printf("Address filter: %lu/%d frames filtered (controller counted %lu), %lu leaked\n",
+            driver.rx_filtered, RX_FRAMES, driver.rx_hw_filtered, driver.rx_filter_errors);
+    if (csum)
+        printf("Checksum offload: RX %lu verified, %lu bad flagged, %lu status mismatches; TX %lu inserted\n",
+            driver.rx_csum_verified, driver.rx_csum_bad, driver.rx_csum_errors, phy.tx_received);
+
+    bool pass = driver.done()
+        && driver.rx_errors == 0
+        && driver.rx_csum_errors == 0
+        && driver.rx_filter_errors == 0
+        && driver.rx_hw_filtered <= driver.rx_filtered
+        && phy.tx_errors == 0
+        && phy.tx_received == TX_FRAMES
+        && phy.tx_large == tx_large
+        && (rx_large == 0 || driver.rx_large != 0)
+        && driver.rx_received + driver.rx_dropped + driver.rx_filtered == RX_FRAMES;
+    if (pass) {
+        printf("Check succeeded\n");
+        return 0;
+    }
+    else {
+        printf("Check failed\n");
+        return 1;
+    }
+}
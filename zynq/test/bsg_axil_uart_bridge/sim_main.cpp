@@ -0,0 +1,577 @@
+#include "Vbsg_axil_uart_bridge.h"
+#include "verilated.h"
+#include <cstdio>
+#include <cstdint>
+#include <iostream>
+#include <verilated_fst_c.h>
+#include <random>
+#include <queue>
+#include <vector>
+#include <unordered_map>
+#include <functional>
+#include <cassert>
+
+#include "bsg_sim_kernel.h"
+#include "bsg_zynq_uart.h"
+
+// Words moved in each phase of the benchmark
+#define TEST_SIZE 512
+#define BURST_LEN 64
+#define MEM_BASE 0x80000000
+#define MEM_WORDS 4096
+
+// Fabric clock and swept baud rates; the first rate is the nominal link
+//   and must run without a single dropped byte
+#define CLK_FREQ_HZ 50000000
+static const uint64_t baud_rates[] = {921600, 3000000, 6250000, 12500000, 25000000};
+
+// UART(-Lite) register map and status bits seen by the bridge
+#define UART_RX_ADDR   0x0
+#define UART_TX_ADDR   0x4
+#define UART_STAT_ADDR 0x8
+#define UART_CTRL_ADDR 0xC
+#define UART_STAT_RX_VALID (1U << 0)
+#define UART_STAT_RX_FULL  (1U << 1)
+#define UART_STAT_TX_EMPTY (1U << 2)
+#define UART_STAT_TX_FULL  (1U << 3)
+#define UART_FIFO_DEPTH 16
+
+using namespace std;
+
+// Set your seed here:
+#define SEED 9877
+mt19937 random_generator(SEED);
+uniform_int_distribution<uint32_t> distribution;
+auto dice = bind(distribution, random_generator);
+
+
+// Xilinx UART-Lite, which the bridge is built against: its register map and
+//   16-entry fifos, plus the serial line to the host.
+//   Each direction moves one 10-bit frame per byte time; a byte arriving to
+//   a full RX fifo is an overrun and a write to a full TX fifo is lost.
+class uart_lite {
+    private:
+        queue<uint8_t> rx_fifo;
+        queue<uint8_t> tx_fifo;
+        uint64_t clks_per_byte_x16;
+        uint64_t rx_timer = 0;
+        uint64_t tx_timer = 0;
+        bool tx_busy = false;
+        uint8_t tx_shift = 0;
+
+        bool aw_got = false, w_got = false, b_pending = false;
+        uint32_t aw_addr = 0, w_data = 0;
+        bool r_pending = false;
+        uint32_t r_data = 0;
+
+        VL_OUT (&axil_awaddr,31,0);
+        VL_OUT8(&axil_awvalid,0,0);
+        VL_IN8 (&axil_awready,0,0);
+        VL_OUT (&axil_wdata,31,0);
+        VL_OUT8(&axil_wvalid,0,0);
+        VL_IN8 (&axil_wready,0,0);
+        VL_IN8 (&axil_bresp,1,0);
+        VL_IN8 (&axil_bvalid,0,0);
+        VL_OUT8(&axil_bready,0,0);
+        VL_OUT (&axil_araddr,31,0);
+        VL_OUT8(&axil_arvalid,0,0);
+        VL_IN8 (&axil_arready,0,0);
+        VL_IN  (&axil_rdata,31,0);
+        VL_IN8 (&axil_rresp,1,0);
+        VL_IN8 (&axil_rvalid,0,0);
+        VL_OUT8(&axil_rready,0,0);
+
+        uint32_t stat()
+        {
+            return (rx_fifo.size() != 0 ? UART_STAT_RX_VALID : 0)
+                 | (rx_fifo.size() == UART_FIFO_DEPTH ? UART_STAT_RX_FULL : 0)
+                 | (tx_fifo.size() == 0 ? UART_STAT_TX_EMPTY : 0)
+                 | (tx_fifo.size() == UART_FIFO_DEPTH ? UART_STAT_TX_FULL : 0);
+        }
+
+    public:
+        // Host side of the serial line
+        queue<uint8_t> host_tx;
+        queue<uint8_t> host_rx;
+        uint64_t rx_overruns = 0;
+        uint64_t tx_drops = 0;
+
+        uart_lite(
+            VL_OUT (&axil_awaddr,31,0), VL_OUT8(&axil_awvalid,0,0),
+            VL_IN8 (&axil_awready,0,0), VL_OUT (&axil_wdata,31,0),
+            VL_OUT8(&axil_wvalid,0,0),  VL_IN8 (&axil_wready,0,0),
+            VL_IN8 (&axil_bresp,1,0),   VL_IN8 (&axil_bvalid,0,0),
+            VL_OUT8(&axil_bready,0,0),  VL_OUT (&axil_araddr,31,0),
+            VL_OUT8(&axil_arvalid,0,0), VL_IN8 (&axil_arready,0,0),
+            VL_IN  (&axil_rdata,31,0),  VL_IN8 (&axil_rresp,1,0),
+            VL_IN8 (&axil_rvalid,0,0),  VL_OUT8(&axil_rready,0,0)):
+                axil_awaddr (axil_awaddr), axil_awvalid(axil_awvalid),
+                axil_awready(axil_awready), axil_wdata  (axil_wdata),
+                axil_wvalid (axil_wvalid), axil_wready (axil_wready),
+                axil_bresp  (axil_bresp), axil_bvalid (axil_bvalid),
+                axil_bready (axil_bready), axil_araddr (axil_araddr),
+                axil_arvalid(axil_arvalid), axil_arready(axil_arready),
+                axil_rdata  (axil_rdata), axil_rresp  (axil_rresp),
+                axil_rvalid (axil_rvalid), axil_rready (axil_rready) {
+                    this->axil_awready = 0;
+                    this->axil_wready = 0;
+                    this->axil_bresp = 0;
+                    this->axil_bvalid = 0;
+                    this->axil_arready = 0;
+                    this->axil_rdata = 0;
+                    this->axil_rresp = 0;
+                    this->axil_rvalid = 0;
+                    set_baud(baud_rates[0]);
+               }
+
+        // 10 bit times per byte, kept in 1/16 cycles to track fractional rates
+        void set_baud(uint64_t baud)
+        {
+            clks_per_byte_x16 = (16ULL * 10 * CLK_FREQ_HZ) / baud;
+            rx_timer = tx_timer = 0;
+        }
+
+        bool idle() const
+        {
+            return host_tx.empty() && rx_fifo.empty() && tx_fifo.empty() && !tx_busy;
+        }
+
+        void sim(bool post_read)
+        {
+            if(post_read == false) {
+                axil_bvalid = b_pending;
+                axil_bresp = 0;
+                axil_rvalid = r_pending;
+                axil_rdata = r_data;
+                axil_rresp = 0;
+                axil_awready = !aw_got && !b_pending;
+                axil_wready = !w_got && !b_pending;
+                axil_arready = !r_pending;
+            }
+            else {
+                if(axil_bvalid == 1 && axil_bready == 1)
+                    b_pending = false;
+                if(axil_rvalid == 1 && axil_rready == 1)
+                    r_pending = false;
+                if(axil_awvalid == 1 && axil_awready == 1) {
+                    aw_got = true;
+                    aw_addr = axil_awaddr;
+                }
+                if(axil_wvalid == 1 && axil_wready == 1) {
+                    w_got = true;
+                    w_data = axil_wdata;
+                }
+                if(aw_got && w_got) {
+                    if((aw_addr & 0xf) == UART_TX_ADDR) {
+                        if(tx_fifo.size() == UART_FIFO_DEPTH)
+                            tx_drops++;
+                        else
+                            tx_fifo.push(w_data & 0xff);
+                    }
+                    aw_got = w_got = false;
+                    b_pending = true;
+                }
+                if(axil_arvalid == 1 && axil_arready == 1) {
+                    r_data = 0;
+                    if((axil_araddr & 0xf) == UART_RX_ADDR && rx_fifo.size() != 0) {
+                        r_data = rx_fifo.front();
+                        rx_fifo.pop();
+                    }
+                    else if((axil_araddr & 0xf) == UART_STAT_ADDR) {
+                        r_data = stat();
+                    }
+                    r_pending = true;
+                }
+
+                // Serial line, host to controller
+                if(host_tx.size() != 0) {
+                    rx_timer += 16;
+                    if(rx_timer >= clks_per_byte_x16) {
+                        rx_timer -= clks_per_byte_x16;
+                        if(rx_fifo.size() == UART_FIFO_DEPTH)
+                            rx_overruns++;
+                        else
+                            rx_fifo.push(host_tx.front());
+                        host_tx.pop();
+                    }
+                }
+                else {
+                    rx_timer = 0;
+                }
+                // Serial line, controller to host
+                if(!tx_busy && tx_fifo.size() != 0) {
+                    tx_shift = tx_fifo.front();
+                    tx_fifo.pop();
+                    tx_busy = true;
+                    tx_timer = 0;
+                }
+                if(tx_busy) {
+                    tx_timer += 16;
+                    if(tx_timer >= clks_per_byte_x16) {
+                        host_rx.push(tx_shift);
+                        tx_busy = false;
+                    }
+                }
+            }
+        }
+};
+
+// AXIL memory behind the bridge, with random backpressure
+class axil_mem {
+    private:
+        unordered_map<uint32_t, uint32_t> mem;
+        bool aw_got = false, w_got = false, b_pending = false;
+        uint32_t aw_addr = 0, w_data = 0;
+        uint8_t w_strb = 0;
+        bool r_pending = false;
+        uint32_t r_data = 0;
+
+        VL_OUT (&axil_awaddr,31,0);
+        VL_OUT8(&axil_awvalid,0,0);
+        VL_IN8 (&axil_awready,0,0);
+        VL_OUT (&axil_wdata,31,0);
+        VL_OUT8(&axil_wstrb,3,0);
+        VL_OUT8(&axil_wvalid,0,0);
+        VL_IN8 (&axil_wready,0,0);
+        VL_IN8 (&axil_bresp,1,0);
+        VL_IN8 (&axil_bvalid,0,0);
+        VL_OUT8(&axil_bready,0,0);
+        VL_OUT (&axil_araddr,31,0);
+        VL_OUT8(&axil_arvalid,0,0);
+        VL_IN8 (&axil_arready,0,0);
+        VL_IN  (&axil_rdata,31,0);
+        VL_IN8 (&axil_rresp,1,0);
+        VL_IN8 (&axil_rvalid,0,0);
+        VL_OUT8(&axil_rready,0,0);
+
+    public:
+        uint64_t writes = 0;
+        uint64_t reads = 0;
+
+        axil_mem(
+            VL_OUT (&axil_awaddr,31,0), VL_OUT8(&axil_awvalid,0,0),
+            VL_IN8 (&axil_awready,0,0), VL_OUT (&axil_wdata,31,0),
+            VL_OUT8(&axil_wstrb,3,0),   VL_OUT8(&axil_wvalid,0,0),
+            VL_IN8 (&axil_wready,0,0),  VL_IN8 (&axil_bresp,1,0),
+            VL_IN8 (&axil_bvalid,0,0),  VL_OUT8(&axil_bready,0,0),
+            VL_OUT (&axil_araddr,31,0), VL_OUT8(&axil_arvalid,0,0),
+            VL_IN8 (&axil_arready,0,0), VL_IN  (&axil_rdata,31,0),
+            VL_IN8 (&axil_rresp,1,0),   VL_IN8 (&axil_rvalid,0,0),
+            VL_OUT8(&axil_rready,0,0)):
+                axil_awaddr (axil_awaddr), axil_awvalid(axil_awvalid),
+                axil_awready(axil_awready), axil_wdata  (axil_wdata),
+                axil_wstrb  (axil_wstrb), axil_wvalid (axil_wvalid),
+                axil_wready (axil_wready), axil_bresp  (axil_bresp),
+                axil_bvalid (axil_bvalid), axil_bready (axil_bready),
+                axil_araddr (axil_araddr), axil_arvalid(axil_arvalid),
+                axil_arready(axil_arready), axil_rdata  (axil_rdata),
+                axil_rresp  (axil_rresp), axil_rvalid (axil_rvalid),
+                axil_rready (axil_rready) {
+                    this->axil_awready = 0;
+                    this->axil_wready = 0;
+                    this->axil_bresp = 0;
+                    this->axil_bvalid = 0;
+                    this->axil_arready = 0;
+                    this->axil_rdata = 0;
+                    this->axil_rresp = 0;
+                    this->axil_rvalid = 0;
+               }
+
+        void sim(bool post_read)
+        {
+            if(post_read == false) {
+                axil_bvalid = b_pending && (dice() & 1U);
+                axil_bresp = 0;
+                axil_rvalid = r_pending && (dice() & 1U);
+                axil_rdata = r_data;
+                axil_rresp = 0;
+                axil_awready = !aw_got && !b_pending && (dice() & 1U);
+                axil_wready = !w_got && !b_pending && (dice() & 1U);
+                axil_arready = !r_pending && (dice() & 1U);
+            }
+            else {
+                if(axil_bvalid == 1 && axil_bready == 1)
+                    b_pending = false;
+                if(axil_rvalid == 1 && axil_rready == 1)
+                    r_pending = false;
+                if(axil_awvalid == 1 && axil_awready == 1) {
+                    aw_got = true;
+                    aw_addr = axil_awaddr;
+                }
+                if(axil_wvalid == 1 && axil_wready == 1) {
+                    w_got = true;
+                    w_data = axil_wdata;
+                    w_strb = axil_wstrb;
+                }
+                if(aw_got && w_got) {
+                    uint32_t &word = mem[aw_addr & ~3U];
+                    for(int i = 0; i < 4; i++)
+                        if(w_strb & (1U << i))
+                            word = (word & ~(0xffU << (8*i))) | (w_data & (0xffU << (8*i)));
+                    aw_got = w_got = false;
+                    b_pending = true;
+                    writes++;
+                }
+                if(axil_arvalid == 1 && axil_arready == 1) {
+                    auto it = mem.find(axil_araddr & ~3U);
+                    r_data = (it == mem.end()) ? 0 : it->second;
+                    r_pending = true;
+                    reads++;
+                }
+            }
+        }
+};
+
+// Host driver: streams bsg_zynq_uart_pkt_h traffic through the serial line.
+//   Writes are sent back-to-back at line rate; like a blocking driver, the
+//   host waits for the data of a read before sending anything else.
+class uart_host {
+    private:
+        struct command {
+            vector<uint8_t> bytes;
+            vector<uint32_t> expected;
+            uint32_t payload;
+        };
+        uart_lite *uart;
+        unordered_map<uint32_t, uint32_t> &shadow;
+        queue<command> commands;
+        vector<uint32_t> expected;
+        vector<uint8_t> rx_bytes;
+
+        uint32_t random_addr(uint32_t words)
+        {
+            return MEM_BASE + 4 * (dice() % (MEM_WORDS - words + 1));
+        }
+
+        uint32_t shadow_read(uint32_t addr)
+        {
+            auto it = shadow.find(addr);
+            return (it == shadow.end()) ? 0 : it->second;
+        }
+
+    public:
+        uint64_t payload_bytes = 0;
+        uint64_t errors = 0;
+
+        uart_host(uart_lite *uart, unordered_map<uint32_t, uint32_t> &shadow)
+            : uart(uart), shadow(shadow) { }
+
+        bool done() const
+        {
+            return commands.empty() && expected.empty() && uart->host_tx.empty();
+        }
+
+        void single_write()
+        {
+            command c;
+            uint32_t addr = random_addr(1), data = dice();
+            c.bytes.resize(BSG_ZYNQ_UART_PKT_BYTES);
+            bsg_zynq_uart_pack_write(c.bytes.data(), addr, data);
+            shadow[addr] = data;
+            c.payload = 4;
+            commands.push(c);
+        }
+
+        void single_read()
+        {
+            command c;
+            uint32_t addr = random_addr(1);
+            c.bytes.resize(BSG_ZYNQ_UART_PKT_BYTES);
+            bsg_zynq_uart_pack_read(c.bytes.data(), addr);
+            c.expected.push_back(shadow_read(addr));
+            c.payload = 4;
+            commands.push(c);
+        }
+
+        void burst_write(uint32_t count)
+        {
+            command c;
+            uint32_t addr = random_addr(count);
+            vector<uint32_t> data(count);
+            for(uint32_t i = 0; i < count; i++) {
+                data[i] = dice();
+                shadow[addr + 4*i] = data[i];
+            }
+            c.bytes.resize(bsg_zynq_uart_burst_write_bytes(count));
+            bsg_zynq_uart_pack_burst_write(c.bytes.data(), addr, data.data(), count);
+            c.payload = 4 * count;
+            commands.push(c);
+        }
+
+        void burst_read(uint32_t count)
+        {
+            command c;
+            uint32_t addr = random_addr(count);
+            c.bytes.resize(BSG_ZYNQ_UART_PKT_BYTES);
+            bsg_zynq_uart_pack_burst_read(c.bytes.data(), addr, count);
+            for(uint32_t i = 0; i < count; i++)
+                c.expected.push_back(shadow_read(addr + 4*i));
+            c.payload = 4 * count;
+            commands.push(c);
+        }
+
+        void sim()
+        {
+            // Collect read data
+            while(uart->host_rx.size() != 0) {
+                rx_bytes.push_back(uart->host_rx.front());
+                uart->host_rx.pop();
+                if(rx_bytes.size() == BSG_ZYNQ_UART_WORD_BYTES) {
+                    uint32_t word;
+                    bsg_zynq_uart_unpack_words(rx_bytes.data(), &word, 1);
+                    rx_bytes.clear();
+                    if(expected.empty() || word != expected.front()) {
+                        if(errors++ < 8)
+                            printf("read mismatch: got %08x expected %08x\n", word,
+                                expected.empty() ? 0 : expected.front());
+                    }
+                    if(!expected.empty())
+                        expected.erase(expected.begin());
+                }
+            }
+
+            // Keep the line busy with the next command
+            if(uart->host_tx.empty() && expected.empty() && !commands.empty()) {
+                command &c = commands.front();
+                for(uint8_t b : c.bytes)
+                    uart->host_tx.push(b);
+                expected = c.expected;
+                payload_bytes += c.payload;
+                commands.pop();
+            }
+        }
+};
+
+int main(int argc, char **argv, char **env)
+{
+    unique_ptr<VerilatedContext> contextp(new VerilatedContext);
+    contextp->commandArgs(argc, argv);
+    unique_ptr<VerilatedFstC> tfp(new VerilatedFstC);
+    contextp->traceEverOn(VM_TRACE_FST);
+    unique_ptr<Vbsg_axil_uart_bridge> dut(new Vbsg_axil_uart_bridge(contextp.get()));
+
+    dut->trace(tfp.get(), 10);
+    tfp->open("dump.fst");
+
+    uart_lite uart(
+        dut->uart_axil_awaddr_o,
+        dut->uart_axil_awvalid_o,
+        dut->uart_axil_awready_i,
+        dut->uart_axil_wdata_o,
+        dut->uart_axil_wvalid_o,
+        dut->uart_axil_wready_i,
+        dut->uart_axil_bresp_i,
+        dut->uart_axil_bvalid_i,
+        dut->uart_axil_bready_o,
+        dut->uart_axil_araddr_o,
+        dut->uart_axil_arvalid_o,
+        dut->uart_axil_arready_i,
+        dut->uart_axil_rdata_i,
+        dut->uart_axil_rresp_i,
+        dut->uart_axil_rvalid_i,
+        dut->uart_axil_rready_o
+    );
+    axil_mem mem(
+        dut->ui_axil_awaddr_o,
+        dut->ui_axil_awvalid_o,
+        dut->ui_axil_awready_i,
+        dut->ui_axil_wdata_o,
+        dut->ui_axil_wstrb_o,
+        dut->ui_axil_wvalid_o,
+        dut->ui_axil_wready_i,
+        dut->ui_axil_bresp_i,
+        dut->ui_axil_bvalid_i,
+        dut->ui_axil_bready_o,
+        dut->ui_axil_araddr_o,
+        dut->ui_axil_arvalid_o,
+        dut->ui_axil_arready_i,
+        dut->ui_axil_rdata_i,
+        dut->ui_axil_rresp_i,
+        dut->ui_axil_rvalid_i,
+        dut->ui_axil_rready_o
+    );
+
+    bsg_sim_kernel kernel(contextp.get(), dut.get());
+    kernel.trace([&](uint64_t t) { tfp->dump(t); });
+    int clk = kernel.add_clock(dut->clk_i, 2, 2);
+
+    dut->reset_i = 1;
+    kernel.run(1, clk);
+    dut->reset_i = 0;
+    kernel.touch();
+
+    // The host of the current phase, if any
+    uart_host *active = nullptr;
+    kernel.pre_edge(clk, [&]() {
+        uart.sim(true);
+        mem.sim(true);
+    });
+    kernel.post_edge(clk, [&]() {
+        if(active)
+            active->sim();
+        uart.sim(false);
+        mem.sim(false);
+    });
+
+    const char *phase_names[] = {"single write", "single read", "burst write", "burst read"};
+    unordered_map<uint32_t, uint32_t> shadow;
+    bool pass = true;
+    uint64_t ceiling = 0;
+    printf("%10s %-13s %10s %12s %12s %9s %8s\n",
+        "baud", "phase", "cycles", "line B/s", "payload B/s", "efficiency", "dropped");
+    for(uint64_t baud : baud_rates) {
+        bool clean = true;
+        for(int phase = 0; phase < 4 && clean; phase++) {
+            uart.set_baud(baud);
+            uint64_t drops_before = uart.rx_overruns + uart.tx_drops;
+            uart_host host(&uart, shadow);
+            // Reads come after writes so that they return known data
+            for(int i = 0; i < TEST_SIZE / ((phase < 2) ? 1 : BURST_LEN); i++) {
+                switch(phase) {
+                    case 0: host.single_write(); break;
+                    case 1: host.single_read(); break;
+                    case 2: host.burst_write(BURST_LEN); break;
+                    case 3: host.burst_read(BURST_LEN); break;
+                }
+            }
+
+            active = &host;
+            uint64_t start = kernel.cycles(clk);
+            uint64_t timeout = 100 * TEST_SIZE * 16 * (uint64_t) CLK_FREQ_HZ / baud;
+            kernel.run_until([&]() { return host.done() && uart.idle(); }, kernel.time() + 2 * timeout);
+            uint64_t cycles = kernel.cycles(clk) - start;
+            // Let the bridge retire the last request
+            kernel.run(256, clk);
+            active = nullptr;
+
+            uint64_t dropped = uart.rx_overruns + uart.tx_drops - drops_before;
+            double seconds = (double) cycles / CLK_FREQ_HZ;
+            double line_bw = (double) baud / 10;
+            double payload_bw = host.payload_bytes / seconds;
+            printf("%10lu %-13s %10lu %12.0f %12.0f %8.1f%% %8lu\n", baud, phase_names[phase],
+                cycles, line_bw, payload_bw, 100 * payload_bw / line_bw, dropped);
+
+            if(dropped != 0 || host.errors != 0 || !host.done())
+                clean = false;
+            if(baud == baud_rates[0] && (dropped != 0 || host.errors != 0 || !host.done()))
+                pass = false;
+        }
+        if(clean)
+            ceiling = baud;
+        else
+            break;
+    }
+
+    printf("Highest clean baud rate at %d Hz: %lu\n", CLK_FREQ_HZ, ceiling);
+    printf("Total simulation time: %lu\n", contextp->time());
+    tfp->close();
+
+    if(pass) {
+        printf("Check succeeded\n");
+        return 0;
+    }
+    else {
+        printf("Check failed\n");
+        return 1;
+    }
+}
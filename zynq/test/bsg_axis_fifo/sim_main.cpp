@@ -0,0 +1,384 @@
+#include "Vbsg_axis_fifo.h"
+#include "verilated.h"
+#include <cstdio>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+#include "bsg_sim_kernel.h"
+
+// Depth and mode the model is built with (els_p, packet_mode_p)
+#ifndef ELS
+#define ELS 128
+#endif
+#ifndef PACKET_MODE
+#define PACKET_MODE 1
+#endif
+
+// Frames streamed per load pattern, and their length in beats
+#define FRAMES 2000
+#define MIN_FRAME 1
+#define MAX_FRAME (ELS / 2)
+// Frames flagged bad with tuser, and frames too long to fit the fifo
+#define ERROR_PERCENT 10
+#define OVERSIZE_PERCENT 2
+#define RESET_CYCLES 16
+#define TIMEOUT_CYCLES (FRAMES * ELS * 8)
+// Every pattern must reach this fraction of the cycles its offered load allows
+#define MIN_EFFICIENCY 0.80
+
+// Status register map
+#define FIFO_OCCUPANCY 0x00
+#define FIFO_THRESHOLD 0x04
+#define FIFO_STATUS    0x08
+#define FIFO_DROPPED   0x0C
+#define FIFO_CONFIG    0x10
+#define FIFO_STATUS_ALMOST_FULL (1U << 0)
+#define FIFO_STATUS_FULL        (1U << 1)
+#define FIFO_STATUS_EMPTY       (1U << 2)
+
+using namespace std;
+
+// Set your seed here:
+#define SEED 9877
+mt19937 random_generator(SEED);
+uniform_int_distribution<uint32_t> distribution;
+auto dice = bind(distribution, random_generator);
+
+// Percent of cycles the source offers a beat and the sink takes one
+struct pattern {
+    int src_pct;
+    int sink_pct;
+};
+const pattern patterns[] = {{100, 100}, {100, 50}, {50, 100}, {75, 75}, {30, 90}};
+
+struct beat {
+    uint32_t data;
+    uint8_t keep;
+    bool last;
+};
+
+struct frame {
+    uint32_t seq;
+    vector<beat> beats;
+    bool error;
+};
+
+frame make_frame(uint32_t seq)
+{
+    frame f;
+    f.seq = seq;
+    f.error = (dice() % 100) < ERROR_PERCENT;
+    size_t len = MIN_FRAME + dice() % (MAX_FRAME - MIN_FRAME + 1);
+    if ((dice() % 100) < OVERSIZE_PERCENT)
+        len = ELS + 1 + dice() % ELS;
+    for (size_t i = 0; i < len; i++) {
+        bool last = (i == len - 1);
+        uint8_t keep = last ? (0xf >> (dice() % 4)) : 0xf;
+        f.beats.push_back({(seq << 16) | (uint32_t) i, keep, last});
+    }
+    return f;
+}
+
+// Whether the fifo forwards a frame
+bool forwarded(const frame &f)
+{
+    return !PACKET_MODE || (!f.error && f.beats.size() <= ELS);
+}
+
+class testbench {
+    private:
+        unique_ptr<VerilatedContext> contextp;
+        unique_ptr<Vbsg_axis_fifo> dut;
+        unique_ptr<bsg_sim_kernel> kernel;
+        int clk;
+        // Extra sampling for the current cycle
+        function<void()> sampler;
+
+        // Source side
+        deque<frame> src_frames;
+        size_t src_beat = 0;
+        bool src_holding = false;
+        // Sink side; expected frames carry their source sequence number
+        deque<frame> sink_frames;
+        size_t sink_beat = 0;
+
+        void handshake()
+        {
+            if (dut->m_axis_tvalid_o && dut->m_axis_tready_i) {
+                if (sink_frames.empty()) {
+                    errors++;
+                } else {
+                    const frame &f = sink_frames.front();
+                    const beat &b = f.beats[sink_beat];
+                    if (dut->m_axis_tdata_o != b.data
+                        || dut->m_axis_tlast_o != b.last
+                        || (b.last && dut->m_axis_tkeep_o != b.keep))
+                        errors++;
+                    // A frame must be complete at the source before it leaves
+                    if (PACKET_MODE && sink_beat == 0 && f.seq >= src_done)
+                        errors++;
+                    out_beats++;
+                    if (++sink_beat == f.beats.size()) {
+                        sink_frames.pop_front();
+                        sink_beat = 0;
+                    }
+                }
+            }
+            if (dut->s_axis_tvalid_i && dut->s_axis_tready_o) {
+                in_beats++;
+                src_holding = false;
+                if (++src_beat == src_frames.front().beats.size()) {
+                    src_frames.pop_front();
+                    src_beat = 0;
+                    src_done++;
+                }
+            }
+        }
+
+    public:
+        int src_pct = 100;
+        int sink_pct = 100;
+        uint64_t cycles = 0;
+        uint64_t in_beats = 0;
+        uint64_t out_beats = 0;
+        uint64_t errors = 0;
+        // Frames whose last beat the fifo has accepted
+        uint32_t src_done = 0;
+
+        testbench(int argc, char **argv):
+            contextp(new VerilatedContext)
+        {
+            contextp->commandArgs(argc, argv);
+            dut.reset(new Vbsg_axis_fifo{contextp.get()});
+            kernel.reset(new bsg_sim_kernel(contextp.get(), dut.get()));
+            clk = kernel->add_clock(dut->clk_i, 2, 1);
+            kernel->pre_edge(clk, [this]() {
+                handshake();
+                if (sampler)
+                    sampler();
+            });
+            dut->reset_i = 1;
+            dut->s_axis_tvalid_i = 0;
+            dut->s_axis_tdata_i = 0;
+            dut->s_axis_tkeep_i = 0;
+            dut->s_axis_tlast_i = 0;
+            dut->s_axis_tuser_i = 0;
+            dut->m_axis_tready_i = 0;
+            dut->s_axil_awaddr_i = 0;
+            dut->s_axil_awprot_i = 0;
+            dut->s_axil_awvalid_i = 0;
+            dut->s_axil_wdata_i = 0;
+            dut->s_axil_wstrb_i = 0;
+            dut->s_axil_wvalid_i = 0;
+            dut->s_axil_bready_i = 0;
+            dut->s_axil_araddr_i = 0;
+            dut->s_axil_arprot_i = 0;
+            dut->s_axil_arvalid_i = 0;
+            dut->s_axil_rready_i = 0;
+            kernel->settle();
+        }
+
+        ~testbench() { dut->final(); }
+
+        bool almost_full() const { return dut->almost_full_o; }
+        bool idle() const { return src_frames.empty() && sink_frames.empty(); }
+
+        void send(const frame &f)
+        {
+            src_frames.push_back(f);
+            if (forwarded(f))
+                sink_frames.push_back(f);
+        }
+
+        // Drives the streams and runs one clock cycle; the handshakes are
+        //   sampled, then sample is called, right before the rising edge
+        void cycle(function<void()> sample = nullptr)
+        {
+            if (!src_holding)
+                src_holding = !src_frames.empty() && (int) (dice() % 100) < src_pct;
+            dut->s_axis_tvalid_i = src_holding;
+            if (src_holding) {
+                const frame &f = src_frames.front();
+                const beat &b = f.beats[src_beat];
+                dut->s_axis_tdata_i = b.data;
+                dut->s_axis_tkeep_i = b.keep;
+                dut->s_axis_tlast_i = b.last;
+                dut->s_axis_tuser_i = b.last && f.error;
+            }
+            dut->m_axis_tready_i = (int) (dice() % 100) < sink_pct;
+
+            kernel->touch();
+
+            sampler = sample;
+            kernel->run(1, clk);
+            sampler = nullptr;
+            cycles++;
+        }
+
+        void reset()
+        {
+            src_frames.clear();
+            sink_frames.clear();
+            src_beat = sink_beat = 0;
+            src_holding = false;
+            dut->reset_i = 1;
+            for (int i = 0; i < RESET_CYCLES; i++)
+                cycle();
+            dut->reset_i = 0;
+            cycles = in_beats = out_beats = errors = 0;
+            src_done = 0;
+        }
+
+        uint32_t axil_read(uint32_t addr)
+        {
+            bool ar_done = false, r_done = false;
+            uint32_t data = 0;
+            while (!r_done) {
+                dut->s_axil_arvalid_i = !ar_done;
+                dut->s_axil_araddr_i = addr;
+                dut->s_axil_rready_i = 1;
+                cycle([&]() {
+                    if (dut->s_axil_arvalid_i && dut->s_axil_arready_o)
+                        ar_done = true;
+                    if (dut->s_axil_rvalid_o && dut->s_axil_rready_i) {
+                        data = dut->s_axil_rdata_o;
+                        r_done = true;
+                    }
+                });
+            }
+            dut->s_axil_arvalid_i = 0;
+            dut->s_axil_rready_i = 0;
+            return data;
+        }
+
+        void axil_write(uint32_t addr, uint32_t data)
+        {
+            bool aw_done = false, w_done = false, b_done = false;
+            while (!b_done) {
+                dut->s_axil_awvalid_i = !aw_done;
+                dut->s_axil_awaddr_i = addr;
+                dut->s_axil_wvalid_i = !w_done;
+                dut->s_axil_wdata_i = data;
+                dut->s_axil_wstrb_i = 0xf;
+                dut->s_axil_bready_i = 1;
+                cycle([&]() {
+                    if (dut->s_axil_awvalid_i && dut->s_axil_awready_o)
+                        aw_done = true;
+                    if (dut->s_axil_wvalid_i && dut->s_axil_wready_o)
+                        w_done = true;
+                    if (dut->s_axil_bvalid_o && dut->s_axil_bready_i)
+                        b_done = true;
+                });
+            }
+            dut->s_axil_awvalid_i = 0;
+            dut->s_axil_wvalid_i = 0;
+            dut->s_axil_bready_i = 0;
+        }
+};
+
+// Streams FRAMES frames with the given load and checks what comes out
+bool run_pattern(testbench &tb, const pattern &p)
+{
+    tb.reset();
+    tb.src_pct = p.src_pct;
+    tb.sink_pct = p.sink_pct;
+
+    uint32_t dropped = 0;
+    for (int i = 0; i < FRAMES; i++) {
+        frame f = make_frame(i);
+        dropped += !forwarded(f);
+        tb.send(f);
+    }
+    while (!tb.idle() && tb.cycles < TIMEOUT_CYCLES)
+        tb.cycle();
+    bool timeout = !tb.idle();
+    uint64_t cycles = tb.cycles;
+
+    // Let the sink settle before reading the counters
+    uint32_t dropped_lo = tb.axil_read(FIFO_DROPPED);
+    uint32_t occupancy_lo = tb.axil_read(FIFO_OCCUPANCY);
+
+    // Fewest cycles the offered load allows on each side
+    double ideal = max(tb.in_beats * 100.0 / p.src_pct, tb.out_beats * 100.0 / p.sink_pct);
+    double eff = ideal / cycles;
+    bool ok = !timeout && !tb.errors && dropped_lo == dropped && occupancy_lo == 0
+        && eff >= MIN_EFFICIENCY;
+
+    printf("%7d%% %7d%% | %9lu %9lu %9lu | %8.3f %8.3f | %7u %7u | %5.1f%%%s%s%s\n",
+        p.src_pct, p.sink_pct, (unsigned long) tb.in_beats, (unsigned long) tb.out_beats,
+        (unsigned long) cycles, (double) tb.in_beats / cycles, (double) tb.out_beats / cycles,
+        dropped, dropped_lo, 100.0 * eff,
+        timeout ? " TIMEOUT" : "", tb.errors ? " DATA ERROR" : "",
+        (dropped_lo != dropped || occupancy_lo != 0) ? " COUNTER ERROR" : "");
+    return ok;
+}
+
+// Fills the fifo past a programmed threshold with the sink stopped, then drains it
+bool run_watermark(testbench &tb)
+{
+    const uint32_t threshold = ELS / 4;
+    const uint32_t len = ELS / 2;
+    bool ok = true;
+
+    tb.reset();
+    tb.axil_write(FIFO_THRESHOLD, threshold);
+    ok &= (tb.axil_read(FIFO_THRESHOLD) == threshold);
+
+    frame f;
+    f.seq = 0;
+    f.error = false;
+    for (uint32_t i = 0; i < len; i++)
+        f.beats.push_back({i, 0xf, i == len - 1});
+    tb.src_pct = 100;
+    tb.sink_pct = 0;
+    tb.send(f);
+
+    bool early = false;
+    for (uint32_t i = 0; i < len + 8; i++)
+        tb.cycle([&]() { early |= (tb.in_beats < threshold) && tb.almost_full(); });
+    uint32_t occupancy_lo = tb.axil_read(FIFO_OCCUPANCY);
+    uint32_t fill_status_lo = tb.axil_read(FIFO_STATUS);
+    ok &= !early && tb.almost_full() && occupancy_lo == len
+        && (fill_status_lo & FIFO_STATUS_ALMOST_FULL) && !(fill_status_lo & FIFO_STATUS_EMPTY);
+
+    tb.sink_pct = 100;
+    for (int i = 0; i < TIMEOUT_CYCLES && !tb.idle(); i++)
+        tb.cycle();
+    uint32_t drain_status_lo = tb.axil_read(FIFO_STATUS);
+    ok &= tb.idle() && !tb.almost_full() && (drain_status_lo & FIFO_STATUS_EMPTY) && !tb.errors;
+
+    printf("Watermark at %u of %u beats: occupancy %u, status 0x%x after fill, 0x%x after drain%s\n",
+        threshold, ELS, occupancy_lo, fill_status_lo, drain_status_lo, ok ? "" : " ERROR");
+    return ok;
+}
+
+int main(int argc, char **argv, char **env)
+{
+    testbench tb(argc, argv);
+    bool ok = true;
+
+    tb.reset();
+    uint32_t config = tb.axil_read(FIFO_CONFIG);
+    printf("Fifo depth %u beats, %s\n", config & 0xffff,
+        (config >> 16) ? "store and forward" : "cut-through");
+    ok &= (config == (((uint32_t) PACKET_MODE << 16) | ELS));
+
+    printf("%8s %8s | %9s %9s %9s | %8s %8s | %7s %7s | %s\n", "src", "sink",
+        "beats in", "beats out", "cycles", "in/cyc", "out/cyc", "dropped", "counted", "of offered load");
+    for (const pattern &p : patterns)
+        ok &= run_pattern(tb, p);
+    ok &= run_watermark(tb);
+
+    if (ok) {
+        printf("Check succeeded\n");
+        return 0;
+    }
+    printf("Check failed\n");
+    return 1;
+}
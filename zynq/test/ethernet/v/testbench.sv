@@ -336,6 +336,16 @@ module testbench;
     ,.rx_interrupt_pending_o(rx_interrupt_pending_lo)
     ,.tx_interrupt_pending_o(tx_interrupt_pending_lo)
 
+    ,.dma_data_o(/* UNUSED */)
+    ,.dma_addr_o(/* UNUSED */)
+    ,.dma_v_o(/* UNUSED */)
+    ,.dma_w_o(/* UNUSED */)
+    ,.dma_wmask_o(/* UNUSED */)
+    ,.dma_ready_and_i(1'b0)
+    ,.dma_data_i('0)
+    ,.dma_v_i(1'b0)
+    ,.dma_ready_and_o(/* UNUSED */)
+
     ,.rgmii_rx_clk_i(rgmii_rx_clk_li)
     ,.rgmii_rxd_i(rgmii_rxd_li)
     ,.rgmii_rx_ctl_i(rgmii_rx_ctl_li)
@@ -3,8 +3,16 @@
 
 // Master address space is the whole BP space
 // Client address space is
-// DMI bridge: 0x00_0000 - 0x12_FFFF 
+// DMI bridge: 0x00_0000 - 0x11_FFFF
+// System bus data window: 0x12_0000 - 0x12_FFFF
 // DMI client port: 0x13_0000 -
+//
+// Every access to the system bus data window is a DMI access to sbdata0,
+//   so with sbautoincrement set (and sbreadondata, for reads) consecutive
+//   words go to consecutive memory addresses with one DMI access each.
+//   Accesses are held back while the previous system bus access is in
+//   flight, so the host does not have to poll sbbusy in between. Set up
+//   sbcs and sbaddress0 through the DMI bridge first.
 module bsg_axil_debug
  import dm::*;
  #(parameter m_axil_data_width_p = 32
@@ -13,6 +21,7 @@ module bsg_axil_debug
    , parameter s_axil_addr_width_p = 32
    , parameter bus_width_p = 32
 
+   , parameter debug_bulk_addr_p = 32'h120000
    , parameter debug_base_addr_p = 32'h130000
    , parameter debug_irq_addr_p  = 32'h30c000
    , parameter debug_npc_addr_p  = 32'h200010
@@ -215,6 +224,25 @@ module bsg_axil_debug
      ,.data_o(c_fifo_v_r)
      );
 
+  // The DM's system bus master has a request waiting for grant, or a granted
+  //   access waiting for its read or write response. A data window access
+  //   that starts no bus access (a read without sbreadondata, or any access
+  //   while sberror or sbbusyerror is set) leaves it clear. The DM raises its
+  //   request before the DMI response of the access that started it returns,
+  //   so the next window access always sees it.
+  logic sb_busy_r;
+  wire c_fifo_bulk_li = (c_fifo_addr_lo >= debug_bulk_addr_p) & (c_fifo_addr_lo < debug_base_addr_p);
+  bsg_dff_reset_set_clear
+   #(.width_p(1))
+   sb_busy_reg
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+     ,.set_i(master_req_lo & master_gnt_li)
+     ,.clear_i(master_r_valid_li)
+     ,.data_o(sb_busy_r)
+     );
+  wire sb_busy_li = master_req_lo | sb_busy_r;
+
   always_comb
     begin
       slave_req_li = '0;
@@ -231,13 +259,20 @@ module bsg_axil_debug
 
       c_fifo_v_li = '0;
 
-      if (c_fifo_addr_lo < debug_base_addr_p)
+      if (c_fifo_addr_lo < debug_bulk_addr_p)
         begin
           dmi_req_v_li = c_fifo_v_lo;
           dmi_req_li.addr = c_fifo_addr_lo >> 2'd2; // 23b word address
           dmi_req_li.op = c_fifo_w_lo ? DTM_WRITE : DTM_READ;
           dmi_req_li.data = c_fifo_data_lo;
         end
+      else if (c_fifo_bulk_li)
+        begin
+          dmi_req_v_li = c_fifo_v_lo & ~sb_busy_li;
+          dmi_req_li.addr = 7'(dm::SBData0);
+          dmi_req_li.op = c_fifo_w_lo ? DTM_WRITE : DTM_READ;
+          dmi_req_li.data = c_fifo_data_lo;
+        end
       else
         begin
           slave_req_li = c_fifo_v_lo;
@@ -246,7 +281,7 @@ module bsg_axil_debug
           slave_be_li = c_fifo_wmask_lo;
           slave_wdata_li = c_fifo_data_lo;
         end
-      c_fifo_ready_and_li = dmi_req_ready_lo;
+      c_fifo_ready_and_li = dmi_req_ready_lo & ~(c_fifo_bulk_li & sb_busy_li);
 
       c_fifo_v_li = c_fifo_v_r;
       c_fifo_data_li = dmi_resp_v_lo ? dmi_resp_lo.data : slave_rdata_lo;
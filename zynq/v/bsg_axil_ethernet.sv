@@ -6,6 +6,12 @@ module bsg_axil_ethernet
     // AXI CHANNEL PARAMS
     parameter axil_data_width_p = 32
   , parameter axil_addr_width_p = 32
+    // DMA master address width
+  , parameter m_axil_addr_width_p = 32
+    // maximum packet size, 16384 for jumbo frames (see ethernet_control_unit.sv)
+  , parameter eth_mtu_p = 2048
+    // DMA memory requests in flight on the master port
+  , parameter dma_outstanding_p = 8
   , localparam axil_mask_width_lp = (axil_addr_width_p >> 3)
 )
 (
@@ -54,6 +60,31 @@ module bsg_axil_ethernet
   , output logic                         s00_axi_rvalid
   , input                                s00_axi_rready
 
+  //====================== AXI-4 LITE DMA MASTER =========================
+  , output logic [m_axil_addr_width_p-1:0] m00_axi_awaddr
+  , output logic [2:0]                     m00_axi_awprot
+  , output logic                           m00_axi_awvalid
+  , input                                  m00_axi_awready
+
+  , output logic [axil_data_width_p-1:0]   m00_axi_wdata
+  , output logic [axil_mask_width_lp-1:0]  m00_axi_wstrb
+  , output logic                           m00_axi_wvalid
+  , input                                  m00_axi_wready
+
+  , input [1:0]                            m00_axi_bresp
+  , input                                  m00_axi_bvalid
+  , output logic                           m00_axi_bready
+
+  , output logic [m_axil_addr_width_p-1:0] m00_axi_araddr
+  , output logic [2:0]                     m00_axi_arprot
+  , output logic                           m00_axi_arvalid
+  , input                                  m00_axi_arready
+
+  , input [axil_data_width_p-1:0]          m00_axi_rdata
+  , input [1:0]                            m00_axi_rresp
+  , input                                  m00_axi_rvalid
+  , output logic                           m00_axi_rready
+
   //====================== Ethernet RGMII =========================
   , input  logic                         rgmii_rx_clk_i
   , input  logic [3:0]                   rgmii_rxd_i
@@ -77,6 +108,16 @@ module bsg_axil_ethernet
   logic                               axil_v_li;
   logic                               axil_ready_and_lo;
 
+  logic [axil_data_width_p-1:0]       dma_data_lo;
+  logic [m_axil_addr_width_p-1:0]     dma_addr_lo;
+  logic                               dma_v_lo;
+  logic                               dma_w_lo;
+  logic [axil_mask_width_lp-1:0]      dma_wmask_lo;
+  logic                               dma_ready_and_li;
+  logic [axil_data_width_p-1:0]       dma_data_li;
+  logic                               dma_v_li;
+  logic                               dma_ready_and_lo;
+
   logic                         disable_r;
 
   logic                         rx_interrupt_pending_lo;
@@ -121,8 +162,8 @@ module bsg_axil_ethernet
   iodelay_control iodc (
     .clk_i(clk_i)
     ,.reset_i(reset_i)
-    ,.iodelay_clk_i(iodelay_clk_i)
-    ,.iodelay_reset_i(iodelay_reset_i)
+    ,.iodelay_clk_i(iodelay_ref_clk_i)
+    ,.iodelay_reset_i(reset_i)
     ,.rgmii_rxd_i(rgmii_rxd_i)
     ,.rgmii_rx_ctl_i(rgmii_rx_ctl_i)
     ,.rgmii_rxd_delayed_o(rgmii_rxd_delayed_lo)
@@ -143,6 +184,8 @@ module bsg_axil_ethernet
 
   ethernet_controller#(
       .data_width_p(axil_data_width_p)
+     ,.dma_addr_width_p(m_axil_addr_width_p)
+     ,.eth_mtu_p(eth_mtu_p)
   ) eth_ctr_wrapper (
       .clk_i(clk_i)
      ,.reset_i(reset_i)
@@ -153,7 +196,6 @@ module bsg_axil_ethernet
      ,.tx_reset_i
      ,.rx_clk_o
      ,.rx_reset_i
-     ,.iodelay_ref_clk_i
 
      ,.addr_i(axil_addr_lo)
      ,.write_en_i(write_en_li)
@@ -165,6 +207,16 @@ module bsg_axil_ethernet
      ,.rx_interrupt_pending_o(rx_interrupt_pending_lo)
      ,.tx_interrupt_pending_o(tx_interrupt_pending_lo)
 
+     ,.dma_data_o(dma_data_lo)
+     ,.dma_addr_o(dma_addr_lo)
+     ,.dma_v_o(dma_v_lo)
+     ,.dma_w_o(dma_w_lo)
+     ,.dma_wmask_o(dma_wmask_lo)
+     ,.dma_ready_and_i(dma_ready_and_li)
+     ,.dma_data_i(dma_data_li)
+     ,.dma_v_i(dma_v_li)
+     ,.dma_ready_and_o(dma_ready_and_lo)
+
      ,.rgmii_rx_clk_i(rgmii_rx_clk_i)
      ,.rgmii_rxd_i(rgmii_rxd_delayed_lo)
      ,.rgmii_rx_ctl_i(rgmii_rx_ctl_delayed_lo)
@@ -193,7 +245,7 @@ module bsg_axil_ethernet
   bsg_axil_fifo_client #(
      .axil_data_width_p(axil_data_width_p)
     ,.axil_addr_width_p(axil_addr_width_p)
-    ,.fifo_els_p(2)
+    ,.outstanding_p(2)
   ) axil (
      .clk_i(clk_i)
     ,.reset_i(reset_i)
@@ -233,6 +285,52 @@ module bsg_axil_ethernet
     ,.s_axil_rvalid_o (s00_axi_rvalid )
     ,.s_axil_rready_i (s00_axi_rready )
   );
+  //////////////////////////////////////////////
+  // DMA master
+  bsg_axil_fifo_master #(
+     .axil_data_width_p(axil_data_width_p)
+    ,.axil_addr_width_p(m_axil_addr_width_p)
+    ,.outstanding_p(dma_outstanding_p)
+  ) dma (
+     .clk_i(clk_i)
+    ,.reset_i(reset_i)
+
+    ,.data_i(dma_data_lo)
+    ,.addr_i(dma_addr_lo)
+    ,.v_i(dma_v_lo)
+    ,.w_i(dma_w_lo)
+    ,.wmask_i(dma_wmask_lo)
+    ,.ready_and_o(dma_ready_and_li)
+
+    ,.data_o(dma_data_li)
+    ,.v_o(dma_v_li)
+    ,.ready_and_i(dma_ready_and_lo)
+
+    ,.m_axil_awaddr_o (m00_axi_awaddr )
+    ,.m_axil_awprot_o (m00_axi_awprot )
+    ,.m_axil_awvalid_o(m00_axi_awvalid)
+    ,.m_axil_awready_i(m00_axi_awready)
+
+    ,.m_axil_wdata_o  (m00_axi_wdata  )
+    ,.m_axil_wstrb_o  (m00_axi_wstrb  )
+    ,.m_axil_wvalid_o (m00_axi_wvalid )
+    ,.m_axil_wready_i (m00_axi_wready )
+
+    ,.m_axil_bresp_i  (m00_axi_bresp  )
+    ,.m_axil_bvalid_i (m00_axi_bvalid )
+    ,.m_axil_bready_o (m00_axi_bready )
+
+    ,.m_axil_araddr_o (m00_axi_araddr )
+    ,.m_axil_arprot_o (m00_axi_arprot )
+    ,.m_axil_arvalid_o(m00_axi_arvalid)
+    ,.m_axil_arready_i(m00_axi_arready)
+
+    ,.m_axil_rdata_i  (m00_axi_rdata  )
+    ,.m_axil_rresp_i  (m00_axi_rresp  )
+    ,.m_axil_rvalid_i (m00_axi_rvalid )
+    ,.m_axil_rready_o (m00_axi_rready )
+  );
+
   assign irq_o = rx_interrupt_pending_lo | tx_interrupt_pending_lo;
 
 endmodule
@@ -0,0 +1,224 @@
+
+`include "bsg_defines.sv"
+
+// Performance counters for valid/ready interfaces, read over AXIL
+//
+// Each monitored port is a request channel and its response channel, e.g.
+//   AXIL reads:  AR (request), R (response)
+//   AXIL writes: AW (request), B (response)
+//   BedRock:     fwd header (request), rev header (response)
+// Only the valid and ready(_and) of each channel are tapped.
+//
+// Per port, counted while enabled:
+//   0: request handshakes
+//   1: request stall cycles (valid, not ready)
+//   2: response handshakes
+//   3: response stall cycles (valid, not ready)
+//   4: sum of requests outstanding, sampled every cycle
+//        (average latency = 4 / 2, average depth = 4 / cycles)
+//   5: maximum requests outstanding
+//
+// Counters are read from a snapshot, so that all of them are from the same
+// cycle. Counters wrap at counter_width_p bits.
+//
+// Client address space (byte offset):
+//   0x00: Control (RW): bit 0 enable (reset 1); writing 1 to bit 1 takes a
+//         snapshot and to bit 2 clears the counters, both in the same cycle
+//         if requested together (the snapshot sees the values before clear)
+//   0x04: Configuration (R): {counter_width_p, ports_p}, 16 bits each
+//   0x08: Cycles counted (R, snapshot)
+//   0x20 + 0x20*port + 4*counter: Port counters (R, snapshot)
+module bsg_axil_perfmon
+ #(parameter s_axil_data_width_p = 32
+   , parameter s_axil_addr_width_p = 32
+   , localparam s_axil_strb_width_lp = s_axil_data_width_p >> 3
+
+   , parameter ports_p = 4
+   , parameter counter_width_p = 32
+   )
+  (input                                        clk_i
+   , input                                      reset_i
+
+   // Monitored channels
+   , input [ports_p-1:0]                        req_v_i
+   , input [ports_p-1:0]                        req_ready_and_i
+   , input [ports_p-1:0]                        resp_v_i
+   , input [ports_p-1:0]                        resp_ready_and_i
+
+   //====================== AXI-4 LITE (Slave) =========================
+   // WRITE ADDRESS CHANNEL SIGNALS
+   , input [s_axil_addr_width_p-1:0]            s_axil_awaddr_i
+   , input [2:0]                                s_axil_awprot_i
+   , input                                      s_axil_awvalid_i
+   , output logic                               s_axil_awready_o
+
+   // WRITE DATA CHANNEL SIGNALS
+   , input [s_axil_data_width_p-1:0]            s_axil_wdata_i
+   , input [s_axil_strb_width_lp-1:0]           s_axil_wstrb_i
+   , input                                      s_axil_wvalid_i
+   , output logic                               s_axil_wready_o
+
+   // WRITE RESPONSE CHANNEL SIGNALS
+   , output logic [1:0]                         s_axil_bresp_o
+   , output logic                               s_axil_bvalid_o
+   , input                                      s_axil_bready_i
+
+   // READ ADDRESS CHANNEL SIGNALS
+   , input [s_axil_addr_width_p-1:0]            s_axil_araddr_i
+   , input [2:0]                                s_axil_arprot_i
+   , input                                      s_axil_arvalid_i
+   , output logic                               s_axil_arready_o
+
+   // READ DATA CHANNEL SIGNALS
+   , output logic [s_axil_data_width_p-1:0]     s_axil_rdata_o
+   , output logic [1:0]                         s_axil_rresp_o
+   , output logic                               s_axil_rvalid_o
+   , input                                      s_axil_rready_i
+   );
+
+  localparam counters_lp = 6;
+  localparam port_stride_lp = 8; // words
+  localparam word_addr_width_lp = `BSG_SAFE_CLOG2(port_stride_lp*(ports_p+1));
+
+  logic axil_v_lo, axil_w_lo, axil_ready_and_li;
+  logic [s_axil_addr_width_p-1:0] axil_addr_lo;
+  logic [s_axil_data_width_p-1:0] axil_data_lo;
+  logic [s_axil_strb_width_lp-1:0] axil_wmask_lo;
+
+  logic axil_v_li, axil_ready_and_lo;
+  logic [s_axil_data_width_p-1:0] axil_data_li;
+
+  bsg_axil_fifo_client
+   #(.axil_data_width_p(s_axil_data_width_p), .axil_addr_width_p(s_axil_addr_width_p))
+   client
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.data_o(axil_data_lo)
+     ,.addr_o(axil_addr_lo)
+     ,.v_o(axil_v_lo)
+     ,.w_o(axil_w_lo)
+     ,.wmask_o(axil_wmask_lo)
+     ,.ready_and_i(axil_ready_and_li)
+
+     ,.data_i(axil_data_li)
+     ,.v_i(axil_v_li)
+     ,.ready_and_o(axil_ready_and_lo)
+
+     ,.*
+     );
+
+  wire [word_addr_width_lp-1:0] word_addr_li = axil_addr_lo[2+:word_addr_width_lp];
+  wire axil_req_li = axil_ready_and_li & axil_v_lo;
+  wire control_w_li = axil_req_li & axil_w_lo & (word_addr_li == '0);
+  wire enable_w_li = control_w_li & axil_wmask_lo[0];
+  wire snapshot_li = control_w_li & axil_wmask_lo[0] & axil_data_lo[1];
+  wire clear_li = control_w_li & axil_wmask_lo[0] & axil_data_lo[2];
+
+  logic enable_r;
+  bsg_dff_reset_en
+   #(.width_p(1), .reset_val_p(1))
+   enable_reg
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+     ,.en_i(enable_w_li)
+     ,.data_i(axil_data_lo[0])
+     ,.data_o(enable_r)
+     );
+
+  // Requests outstanding; not cleared, so that it stays in step with the bus
+  logic [ports_p-1:0][counter_width_p-1:0] outstanding_r, outstanding_n;
+  logic [ports_p-1:0][counters_lp-1:0][counter_width_p-1:0] count_r, count_n, snap_r;
+  logic [counter_width_p-1:0] cycle_r, snap_cycle_r;
+
+  always_comb
+    for (integer i = 0; i < ports_p; i++)
+      begin
+        automatic logic req_yumi = req_v_i[i] & req_ready_and_i[i];
+        automatic logic resp_yumi = resp_v_i[i] & resp_ready_and_i[i];
+
+        outstanding_n[i] = outstanding_r[i] + req_yumi
+          - (resp_yumi & (outstanding_r[i] != '0));
+
+        count_n[i] = count_r[i];
+        if (enable_r)
+          begin
+            count_n[i][0] = count_r[i][0] + req_yumi;
+            count_n[i][1] = count_r[i][1] + (req_v_i[i] & ~req_ready_and_i[i]);
+            count_n[i][2] = count_r[i][2] + resp_yumi;
+            count_n[i][3] = count_r[i][3] + (resp_v_i[i] & ~resp_ready_and_i[i]);
+            count_n[i][4] = count_r[i][4] + outstanding_r[i];
+            if (outstanding_r[i] > count_r[i][5])
+              count_n[i][5] = outstanding_r[i];
+          end
+      end
+
+  bsg_dff_reset
+   #(.width_p(ports_p*counter_width_p))
+   outstanding_reg
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+     ,.data_i(outstanding_n)
+     ,.data_o(outstanding_r)
+     );
+
+  bsg_dff_reset_en
+   #(.width_p(counter_width_p+ports_p*counters_lp*counter_width_p))
+   count_reg
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+     ,.en_i(enable_r | clear_li)
+     ,.data_i(clear_li ? '0 : {cycle_r + 1'b1, count_n})
+     ,.data_o({cycle_r, count_r})
+     );
+
+  bsg_dff_reset_en
+   #(.width_p(counter_width_p+ports_p*counters_lp*counter_width_p))
+   snap_reg
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+     ,.en_i(snapshot_li)
+     ,.data_i({cycle_r, count_r})
+     ,.data_o({snap_cycle_r, snap_r})
+     );
+
+  logic [s_axil_data_width_p-1:0] rdata_li;
+  always_comb
+    begin
+      rdata_li = '0;
+      if (word_addr_li == 0)
+        rdata_li = s_axil_data_width_p'(enable_r);
+      else if (word_addr_li == 1)
+        rdata_li = s_axil_data_width_p'({16'(counter_width_p), 16'(ports_p)});
+      else if (word_addr_li == 2)
+        rdata_li = s_axil_data_width_p'(snap_cycle_r);
+      else
+        for (integer i = 0; i < ports_p; i++)
+          for (integer j = 0; j < counters_lp; j++)
+            if (word_addr_li == port_stride_lp*(i+1) + j)
+              rdata_li = s_axil_data_width_p'(snap_r[i][j]);
+    end
+
+  // Writes are acknowledged with 0
+  bsg_one_fifo
+   #(.width_p(s_axil_data_width_p))
+   resp_fifo
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.data_i(axil_w_lo ? '0 : rdata_li)
+     ,.v_i(axil_v_lo)
+     ,.ready_and_o(axil_ready_and_li)
+
+     ,.data_o(axil_data_li)
+     ,.v_o(axil_v_li)
+     ,.yumi_i(axil_ready_and_lo & axil_v_li)
+     );
+
+  wire unused = &{axil_addr_lo, axil_wmask_lo};
+
+  if (counter_width_p > s_axil_data_width_p)
+    $error("counter_width_p wider than the AXIL data");
+
+endmodule
+
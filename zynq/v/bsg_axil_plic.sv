@@ -15,6 +15,9 @@ module bsg_axil_plic
    , parameter base_addr_p = 32'h300000
    , parameter num_src_p = 2
    , parameter num_tgt_p = 1
+   // Notify targets with one bitmap write per window (see bsg_irq_to_axil)
+   , parameter irq_coalesce_p = 0
+   , parameter irq_coalesce_window_p = 16
    )
   (input                                        clk_i
    , input                                      reset_i
@@ -120,12 +123,14 @@ module bsg_axil_plic
      ,.axil_addr_width_p(m_axil_addr_width_p)
      ,.irq_sources_p(num_src_p)
      ,.irq_addr_p(base_addr_p)
+     ,.coalesce_p(irq_coalesce_p)
      )
    irq2axil
     (.clk_i(clk_i)
      ,.reset_i(reset_i)
 
      ,.irq_r_i(irq_lo)
+     ,.coalesce_window_i(16'(irq_coalesce_window_p))
 
      ,.*
      );
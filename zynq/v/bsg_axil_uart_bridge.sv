@@ -81,8 +81,12 @@ module bsg_axil_uart_bridge
    ,e_poll_recv
    ,e_req_send
    ,e_req_wait
+   ,e_tx_poll
+   ,e_tx_check
    ,e_tx_send
    ,e_tx_drain
+   ,e_burst_send
+   ,e_burst_wait
    } state_n, state_r;
   wire is_ready      = (state_r == e_ready);
   wire is_poll_check = (state_r == e_poll_check);
@@ -90,17 +94,26 @@ module bsg_axil_uart_bridge
   wire is_poll_recv  = (state_r == e_poll_recv);
   wire is_req_send   = (state_r == e_req_send);
   wire is_req_wait   = (state_r == e_req_wait);
+  wire is_tx_poll    = (state_r == e_tx_poll);
+  wire is_tx_check   = (state_r == e_tx_check);
   wire is_tx_send    = (state_r == e_tx_send);
   wire is_tx_drain   = (state_r == e_tx_drain);
+  wire is_burst_send = (state_r == e_burst_send);
+  wire is_burst_wait = (state_r == e_burst_wait);
 
   // TODO: Can early exit on reads
   // MUST be sync-ed to C driver
+  //
+  // Single access (burst = 0): data is the write data, reads return one word
+  // Burst access  (burst = 1): data is the word count N. Writes are followed
+  //   by N data words on the UART, reads return N words. Beats go to
+  //   sequential word addresses starting at addr30to2
   typedef struct packed
   {
     logic [31:0] data;
     logic [29:0] addr30to2;
     logic        wr_not_rd;
-    logic        port;
+    logic        burst;
   } bsg_uart_pkt_s;
 
   //
@@ -114,6 +127,10 @@ module bsg_axil_uart_bridge
   localparam stat_addr_lp = uart_base_addr_p + 8;
   localparam ctrl_addr_lp = uart_base_addr_p + 12;
 
+  // STAT bits
+  localparam stat_rx_valid_lp = 0;
+  localparam stat_tx_full_lp  = 3;
+
   logic [uart_axil_data_width_p-1:0] m_wdata_li;
   logic [uart_axil_addr_width_p-1:0] m_addr_li;
   logic m_v_li, m_w_li, m_ready_and_lo;
@@ -185,6 +202,36 @@ module bsg_axil_uart_bridge
      ,.yumi_i(uart_pkt_yumi_li)
      );
 
+  logic [ui_axil_data_width_p-1:0] burst_data_lo;
+  logic burst_data_v_lo, burst_data_yumi_li;
+  logic burst_recv_ready_and_lo;
+  logic [7:0] burst_recv_data_li;
+  logic burst_recv_v_li;
+  bsg_serial_in_parallel_out_full
+   #(.width_p(8), .els_p(ui_axil_data_width_p/8))
+   burst_sipo
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.data_i(burst_recv_data_li)
+     ,.v_i(burst_recv_v_li)
+     ,.ready_and_o(burst_recv_ready_and_lo)
+
+     ,.data_o(burst_data_lo)
+     ,.v_o(burst_data_v_lo)
+     ,.yumi_i(burst_data_yumi_li)
+     );
+
+  // Burst bookkeeping, loaded from a burst header and stepped per beat
+  logic burst_v_r, burst_w_r;
+  logic [ui_axil_addr_width_p-1:0] burst_addr_r;
+  logic [31:0] burst_cnt_r;
+  logic burst_load, burst_step;
+
+  // Write bursts source their data from the UART, reads are free-running
+  wire burst_beat_v = burst_v_r & (~burst_w_r | burst_data_v_lo);
+  wire pkt_pending = ~burst_v_r & uart_pkt_v_lo;
+
   logic [ui_axil_data_width_p-1:0] gp0_wdata_li;
   logic [ui_axil_addr_width_p-1:0] gp0_addr_li;
   logic gp0_v_li, gp0_w_li, gp0_ready_and_lo;
@@ -279,25 +326,36 @@ module bsg_axil_uart_bridge
       uart_v_li = '0;
       tx_yumi_li = '0;
 
+      burst_recv_data_li = '0;
+      burst_recv_v_li = '0;
+      burst_data_yumi_li = '0;
+      burst_load = '0;
+      burst_step = '0;
+
       case (state_r)
-        // If we have a uart wr/rd packet, send it, else poll the rx fifo
+        // If we have a burst beat or a uart wr/rd packet, send it, else poll the rx fifo
         e_ready:
           begin
-            m_v_li = ~uart_pkt_v_lo;
+            m_v_li = ~burst_beat_v & ~pkt_pending;
             m_addr_li = stat_addr_lp;
-
-            state_n = uart_pkt_v_lo
-                      ? e_req_send
-                      : (m_ready_and_lo & m_v_li)
-                        ? e_poll_check
-                        : state_r;
+            // Burst headers are consumed here, the beats follow
+            burst_load = pkt_pending & uart_pkt_lo.burst;
+            uart_pkt_yumi_li = burst_load;
+
+            state_n = burst_beat_v
+                      ? e_burst_send
+                      : pkt_pending
+                        ? uart_pkt_lo.burst ? state_r : e_req_send
+                        : (m_ready_and_lo & m_v_li)
+                          ? e_poll_check
+                          : state_r;
           end
         // Check if RX is has byte
         e_poll_check:
           begin
             m_ready_and_li = 1'b1;
 
-            state_n = (m_ready_and_li & m_v_lo) ? m_rdata_lo[0] ? e_poll_send : e_ready : state_r;
+            state_n = (m_ready_and_li & m_v_lo) ? m_rdata_lo[stat_rx_valid_lp] ? e_poll_send : e_ready : state_r;
           end
         // Query the RX byte
         e_poll_send:
@@ -307,12 +365,14 @@ module bsg_axil_uart_bridge
             
             state_n = (m_ready_and_lo & m_v_li) ? e_poll_recv : state_r;
           end
-        // Grab the byte
+        // Grab the byte, which is burst data during a write burst
         e_poll_recv:
           begin
             recv_data_li = m_rdata_lo;
-            recv_v_li = m_v_lo;
-            m_ready_and_li = recv_ready_and_lo;
+            recv_v_li = m_v_lo & ~(burst_v_r & burst_w_r);
+            burst_recv_data_li = m_rdata_lo;
+            burst_recv_v_li = m_v_lo & (burst_v_r & burst_w_r);
+            m_ready_and_li = (burst_v_r & burst_w_r) ? burst_recv_ready_and_lo : recv_ready_and_lo;
 
             state_n = (m_ready_and_li & m_v_lo) ? e_ready : state_r;
           end
@@ -334,9 +394,23 @@ module bsg_axil_uart_bridge
             gp0_ready_and_li = (uart_pkt_lo.wr_not_rd | uart_ready_and_lo);
             uart_pkt_yumi_li = gp0_ready_and_li & gp0_v_lo;
 
-            state_n = uart_pkt_yumi_li ? !uart_pkt_lo.wr_not_rd ? e_tx_send : e_ready : state_r;
+            state_n = uart_pkt_yumi_li ? !uart_pkt_lo.wr_not_rd ? e_tx_poll : e_ready : state_r;
           end
-        // Transmit read response (assume TX fifo is drained fast enough for now...)
+        // Check for room in the TX fifo, bytes written to a full fifo are lost
+        e_tx_poll:
+          begin
+            m_v_li = 1'b1;
+            m_addr_li = stat_addr_lp;
+
+            state_n = (m_ready_and_lo & m_v_li) ? e_tx_check : state_r;
+          end
+        e_tx_check:
+          begin
+            m_ready_and_li = 1'b1;
+
+            state_n = (m_ready_and_li & m_v_lo) ? m_rdata_lo[stat_tx_full_lp] ? e_tx_poll : e_tx_send : state_r;
+          end
+        // Transmit read response
         e_tx_send:
           begin
             m_v_li = tx_v_lo;
@@ -351,7 +425,28 @@ module bsg_axil_uart_bridge
           begin
             m_ready_and_li = 1'b1;
 
-            state_n = (m_ready_and_li & m_v_lo) ? ~tx_v_lo ? e_ready : e_tx_send : state_r;
+            state_n = (m_ready_and_li & m_v_lo) ? ~tx_v_lo ? e_ready : e_tx_poll : state_r;
+          end
+        // Send a GP0 req for the next burst beat
+        e_burst_send:
+          begin
+            gp0_wdata_li = burst_data_lo;
+            gp0_addr_li = burst_addr_r;
+            gp0_v_li = 1'b1;
+            gp0_w_li = burst_w_r;
+
+            state_n = (gp0_ready_and_lo & gp0_v_li) ? e_burst_wait : state_r;
+          end
+        // Recv a GP0 response for the burst beat
+        e_burst_wait:
+          begin
+            uart_v_li = gp0_v_lo & !burst_w_r;
+            uart_data_li = gp0_rdata_lo;
+            gp0_ready_and_li = (burst_w_r | uart_ready_and_lo);
+            burst_step = gp0_ready_and_li & gp0_v_lo;
+            burst_data_yumi_li = burst_step & burst_w_r;
+
+            state_n = burst_step ? !burst_w_r ? e_tx_poll : e_ready : state_r;
           end
         default: state_n = e_ready;
       endcase
@@ -364,5 +459,23 @@ module bsg_axil_uart_bridge
     else
       state_r <= state_n;
 
+  // A zero-length burst is consumed without any beats
+  always_ff @(posedge clk_i)
+    if (reset_i)
+      burst_v_r <= 1'b0;
+    else if (burst_load)
+      begin
+        burst_v_r    <= (uart_pkt_lo.data != '0);
+        burst_w_r    <= uart_pkt_lo.wr_not_rd;
+        burst_addr_r <= (uart_pkt_lo.addr30to2 << 2'b10);
+        burst_cnt_r  <= uart_pkt_lo.data;
+      end
+    else if (burst_step)
+      begin
+        burst_v_r    <= (burst_cnt_r != 32'd1);
+        burst_addr_r <= burst_addr_r + (ui_axil_data_width_p/8);
+        burst_cnt_r  <= burst_cnt_r - 1'b1;
+      end
+
 endmodule
 
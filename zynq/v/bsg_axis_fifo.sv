@@ -1,8 +1,33 @@
 
 `include "bsg_defines.sv"
 
+// AXI-Stream fifo, with a store-and-forward packet mode
+//
+// With packet_mode_p = 1, a frame is only forwarded once its last beat is in,
+//   so the master never sees a partial frame. A frame is dropped if tuser is
+//   set on its last beat (an error flagged by the source), or if it is too
+//   long to ever fit, in which case it is discarded up to its last beat.
+//   With packet_mode_p = 0, beats are forwarded as soon as they are in.
+//
+// almost_full_o is set while the occupancy is at or above the almost-full
+//   threshold, so that the source can be backpressured before the fifo fills.
+//
+// Client address space (byte offset):
+//   0x00: Occupancy (R), in beats
+//   0x04: Almost-full threshold (RW), in beats, reset almost_full_els_p
+//   0x08: Status (R): bit 0 almost full, bit 1 full, bit 2 empty
+//   0x0C: Frames dropped (R), wraps
+//   0x10: Configuration (R): {packet_mode_p, els_p}, 16 bits each
 module bsg_axis_fifo
- #(parameter C_S00_AXI_DATA_WIDTH = 32)
+ #(parameter C_S00_AXI_DATA_WIDTH = 32
+   , parameter els_p = 128
+   , parameter packet_mode_p = 1
+   , parameter almost_full_els_p = els_p - (els_p >> 2)
+
+   , parameter s_axil_data_width_p = 32
+   , parameter s_axil_addr_width_p = 32
+   , localparam s_axil_strb_width_lp = s_axil_data_width_p >> 3
+   )
   (input                                          clk_i
    , input                                        reset_i
 
@@ -10,6 +35,7 @@ module bsg_axis_fifo
    , input [C_S00_AXI_DATA_WIDTH-1:0]             s_axis_tdata_i
    , input [(C_S00_AXI_DATA_WIDTH/8)-1:0]         s_axis_tkeep_i
    , input                                        s_axis_tlast_i
+   , input                                        s_axis_tuser_i
    , output logic                                 s_axis_tready_o
 
    , output logic                                 m_axis_tvalid_o
@@ -17,58 +43,196 @@ module bsg_axis_fifo
    , output logic  [(C_S00_AXI_DATA_WIDTH/8)-1:0] m_axis_tkeep_o
    , output logic                                 m_axis_tlast_o
    , input                                        m_axis_tready_i
+
+   , output logic                                 almost_full_o
+
+   //====================== AXI-4 LITE (Slave) =========================
+   // WRITE ADDRESS CHANNEL SIGNALS
+   , input [s_axil_addr_width_p-1:0]              s_axil_awaddr_i
+   , input [2:0]                                  s_axil_awprot_i
+   , input                                        s_axil_awvalid_i
+   , output logic                                 s_axil_awready_o
+
+   // WRITE DATA CHANNEL SIGNALS
+   , input [s_axil_data_width_p-1:0]              s_axil_wdata_i
+   , input [s_axil_strb_width_lp-1:0]             s_axil_wstrb_i
+   , input                                        s_axil_wvalid_i
+   , output logic                                 s_axil_wready_o
+
+   // WRITE RESPONSE CHANNEL SIGNALS
+   , output logic [1:0]                           s_axil_bresp_o
+   , output logic                                 s_axil_bvalid_o
+   , input                                        s_axil_bready_i
+
+   // READ ADDRESS CHANNEL SIGNALS
+   , input [s_axil_addr_width_p-1:0]              s_axil_araddr_i
+   , input [2:0]                                  s_axil_arprot_i
+   , input                                        s_axil_arvalid_i
+   , output logic                                 s_axil_arready_o
+
+   // READ DATA CHANNEL SIGNALS
+   , output logic [s_axil_data_width_p-1:0]       s_axil_rdata_o
+   , output logic [1:0]                           s_axil_rresp_o
+   , output logic                                 s_axil_rvalid_o
+   , input                                        s_axil_rready_i
    );
 
-  enum logic {e_rx, e_tx} state_n, state_r;
-  wire is_rx = state_r inside {e_rx};
-  wire is_tx = state_r inside {e_tx};
+  localparam keep_width_lp = C_S00_AXI_DATA_WIDTH/8;
+  localparam lg_els_lp = `BSG_SAFE_CLOG2(els_p);
+  // One extra bit to tell full from empty
+  localparam ptr_width_lp = lg_els_lp+1;
+
+  // Write pointer, end of the last complete frame, and read pointer
+  logic [ptr_width_lp-1:0] wptr_r, commit_r, rptr_r;
+  logic drop_r;
+
+  wire [ptr_width_lp-1:0] occupancy_lo = wptr_r - rptr_r;
+  wire full_lo = (occupancy_lo == els_p);
+  wire empty_lo = (occupancy_lo == '0);
+  // The frame being written fills the fifo, so it can never be forwarded
+  wire oversize_lo = (packet_mode_p == 1) & full_lo & (commit_r == rptr_r);
 
-  localparam max_els_lp = 128;
+  wire discard_li = drop_r | oversize_lo;
+  assign s_axis_tready_o = discard_li | ~full_lo;
+  wire enq_li = s_axis_tvalid_i & s_axis_tready_o;
+  wire error_li = (packet_mode_p == 1) & s_axis_tlast_i & s_axis_tuser_i;
+  wire write_li = enq_li & ~discard_li & ~error_li;
+  wire deq_li = m_axis_tvalid_o & m_axis_tready_i;
+  wire dropped_li = enq_li & s_axis_tlast_i & (discard_li | error_li);
+
+  wire [ptr_width_lp-1:0] wptr_inc = wptr_r + 1'b1;
+  // synopsys sync_set_reset "reset_i"
+  always_ff @(posedge clk_i)
+    if (reset_i)
+      begin
+        wptr_r   <= '0;
+        commit_r <= '0;
+        rptr_r   <= '0;
+        drop_r   <= 1'b0;
+      end
+    else
+      begin
+        if (write_li)
+          wptr_r <= wptr_inc;
+        else if (enq_li & (oversize_lo | error_li))
+          wptr_r <= commit_r;
+
+        if (write_li & s_axis_tlast_i)
+          commit_r <= wptr_inc;
+
+        if (deq_li)
+          rptr_r <= rptr_r + 1'b1;
+
+        if (enq_li & oversize_lo & ~s_axis_tlast_i)
+          drop_r <= 1'b1;
+        else if (enq_li & s_axis_tlast_i)
+          drop_r <= 1'b0;
+      end
+
+  bsg_mem_1r1w
+   #(.width_p(C_S00_AXI_DATA_WIDTH+keep_width_lp+1), .els_p(els_p))
+   mem
+    (.w_clk_i(clk_i)
+     ,.w_reset_i(reset_i)
+
+     ,.w_v_i(write_li)
+     ,.w_addr_i(wptr_r[0+:lg_els_lp])
+     ,.w_data_i({s_axis_tdata_i, s_axis_tkeep_i, s_axis_tlast_i})
+
+     ,.r_v_i(m_axis_tvalid_o)
+     ,.r_addr_i(rptr_r[0+:lg_els_lp])
+     ,.r_data_o({m_axis_tdata_o, m_axis_tkeep_o, m_axis_tlast_o})
+     );
+  assign m_axis_tvalid_o = (rptr_r != ((packet_mode_p == 1) ? commit_r : wptr_r));
 
-  logic [`BSG_WIDTH(max_els_lp)-1:0] tx_count_lo;
-  bsg_counter_up_down
-   #(.max_val_p(max_els_lp), .init_val_p(0), .max_step_p(1))
-   bcud
+  // Status registers
+  logic axil_v_lo, axil_w_lo, axil_ready_and_li;
+  logic [s_axil_addr_width_p-1:0] axil_addr_lo;
+  logic [s_axil_data_width_p-1:0] axil_data_lo;
+  logic [s_axil_strb_width_lp-1:0] axil_wmask_lo;
+
+  logic axil_v_li, axil_ready_and_lo;
+  logic [s_axil_data_width_p-1:0] axil_data_li;
+
+  bsg_axil_fifo_client
+   #(.axil_data_width_p(s_axil_data_width_p), .axil_addr_width_p(s_axil_addr_width_p))
+   client
     (.clk_i(clk_i)
      ,.reset_i(reset_i)
 
-     ,.up_i(s_axis_tready_o & s_axis_tvalid_i)
-     ,.down_i(m_axis_tready_i & m_axis_tvalid_o)
-     ,.count_o(tx_count_lo)
+     ,.data_o(axil_data_lo)
+     ,.addr_o(axil_addr_lo)
+     ,.v_o(axil_v_lo)
+     ,.w_o(axil_w_lo)
+     ,.wmask_o(axil_wmask_lo)
+     ,.ready_and_i(axil_ready_and_li)
+
+     ,.data_i(axil_data_li)
+     ,.v_i(axil_v_li)
+     ,.ready_and_o(axil_ready_and_lo)
+
+     ,.*
      );
 
-  logic fifo_ready_lo, fifo_v_lo;
-  assign s_axis_tready_o = is_rx & fifo_ready_lo;
-  bsg_fifo_1r1w_small
-   #(.width_p(C_S00_AXI_DATA_WIDTH), .els_p(max_els_lp), .ready_THEN_valid_p(1))
-   fifo
+  wire [2:0] word_addr_li = axil_addr_lo[2+:3];
+  wire threshold_w_li = axil_ready_and_li & axil_v_lo & axil_w_lo & (word_addr_li == 3'd1);
+
+  logic [ptr_width_lp-1:0] almost_full_els_r;
+  bsg_dff_reset_en
+   #(.width_p(ptr_width_lp), .reset_val_p(almost_full_els_p))
+   threshold_reg
     (.clk_i(clk_i)
      ,.reset_i(reset_i)
+     ,.en_i(threshold_w_li)
+     ,.data_i(axil_data_lo[0+:ptr_width_lp])
+     ,.data_o(almost_full_els_r)
+     );
+  assign almost_full_o = (occupancy_lo >= almost_full_els_r);
 
-     ,.data_i(s_axis_tdata_i)
-     ,.v_i(s_axis_tready_o & s_axis_tvalid_i)
-     ,.ready_param_o(fifo_ready_lo)
-
-     ,.data_o(m_axis_tdata_o)
-     ,.v_o(fifo_v_lo)
-     ,.yumi_i(m_axis_tready_i & m_axis_tvalid_o)
+  logic [31:0] dropped_r;
+  bsg_counter_clear_up
+   #(.max_val_p(32'hffffffff), .init_val_p(0), .disable_overflow_warning_p(1))
+   dropped_counter
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+     ,.clear_i(1'b0)
+     ,.up_i(dropped_li)
+     ,.count_o(dropped_r)
      );
-  assign m_axis_tvalid_o = is_tx & fifo_v_lo;
-  assign m_axis_tkeep_o = '1;
-  assign m_axis_tlast_o = (tx_count_lo == 1'b1);
 
+  logic [s_axil_data_width_p-1:0] rdata_li;
   always_comb
-    case (state_r)
-      e_rx: state_n = (s_axis_tready_o & s_axis_tvalid_i & s_axis_tlast_i) ? e_tx : state_r;
-      e_tx: state_n = (m_axis_tready_i & m_axis_tvalid_o & m_axis_tlast_o) ? e_rx : state_r;
+    case (word_addr_li)
+      3'd0: rdata_li = s_axil_data_width_p'(occupancy_lo);
+      3'd1: rdata_li = s_axil_data_width_p'(almost_full_els_r);
+      3'd2: rdata_li = s_axil_data_width_p'({empty_lo, full_lo, almost_full_o});
+      3'd3: rdata_li = s_axil_data_width_p'(dropped_r);
+      3'd4: rdata_li = s_axil_data_width_p'({16'(packet_mode_p), 16'(els_p)});
+      default: rdata_li = '0;
     endcase
 
-  // synopsys sync_set_reset "reset_i"
-  always_ff @(posedge clk_i)
-    if (reset_i)
-      state_r <= e_rx;
-    else
-      state_r <= state_n;
+  // Writes are acknowledged with 0
+  bsg_one_fifo
+   #(.width_p(s_axil_data_width_p))
+   resp_fifo
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.data_i(axil_w_lo ? '0 : rdata_li)
+     ,.v_i(axil_v_lo)
+     ,.ready_and_o(axil_ready_and_li)
+
+     ,.data_o(axil_data_li)
+     ,.v_o(axil_v_li)
+     ,.yumi_i(axil_ready_and_lo & axil_v_li)
+     );
+
+  wire unused = &{axil_addr_lo, axil_wmask_lo};
+
+  if (els_p != (1 << lg_els_lp))
+    $error("els_p must be a power of 2");
+  if (els_p >= (1 << 16))
+    $error("els_p does not fit the configuration register");
 
 endmodule
 
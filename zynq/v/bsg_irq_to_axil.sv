@@ -1,4 +1,19 @@
 
+/*
+ * Forwards rising edges on irq_r_i as AXIL writes.
+ *
+ * With coalesce_p == 0, each edge is a write of 0 to irq_addr_p + 4*source.
+ *
+ * With coalesce_p == 1, edges are collected for coalesce_window_i cycles
+ * after the first one, then a single write to irq_addr_p carries all of them:
+ *   bits irq_sources_p-1:0: sources with a new edge
+ *   bits axil_data_width_p-1 -: 8: sequence number, +1 per write
+ * Edges that arrive while a write is waiting for the bus join it. A window
+ * of 0 writes as soon as the bus is free. The sequence number lets the
+ * receiver notice writes it missed.
+ *
+ */
+
 `include "bsg_defines.sv"
 
 module bsg_irq_to_axil
@@ -6,12 +21,15 @@ module bsg_irq_to_axil
    , parameter axil_addr_width_p = 32
    , parameter irq_sources_p = 2
    , parameter irq_addr_p = 32'h00000000
+   , parameter coalesce_p = 0
    )
   (input                                        clk_i
    , input                                      reset_i
    // Interrupt notification
    // register to help meet timing
    , input [irq_sources_p-1:0]                  irq_r_i
+   // Cycles to collect edges for, when coalescing
+   , input [15:0]                               coalesce_window_i
 
    //====================== AXI-4 LITE =========================
    // WRITE ADDRESS CHANNEL SIGNALS
@@ -71,38 +89,117 @@ module bsg_irq_to_axil
      ,.*
      );
 
-  logic [irq_sources_p-1:0] irq_detected_n, irq_detected_r;
-  for (genvar i = 0; i < irq_sources_p; i++)
-    begin : src
-      assign irq_detected_n[i] = irq_r_i & axil_ready_and_lo;
-      bsg_edge_detect
-       #(.falling_not_rising_p(0))
-       bed
+  if (coalesce_p == 0)
+    begin : single
+      logic [irq_sources_p-1:0] irq_detected_n, irq_detected_r;
+      for (genvar i = 0; i < irq_sources_p; i++)
+        begin : src
+          assign irq_detected_n[i] = irq_r_i[i] & axil_ready_and_lo;
+          bsg_edge_detect
+           #(.falling_not_rising_p(0))
+           bed
+            (.clk_i(clk_i)
+             ,.reset_i(reset_i)
+
+             ,.sig_i(irq_detected_n[i])
+             ,.detect_o(irq_detected_r[i])
+             );
+        end
+
+      localparam irq_id_width_lp = `BSG_SAFE_CLOG2(irq_sources_p);
+      logic [irq_id_width_lp-1:0] irq_sel_lo;
+      logic any_irq_lo;
+      bsg_priority_encode
+       #(.width_p(irq_sources_p), .lo_to_hi_p(1))
+       pe
+        (.i(irq_detected_r)
+         ,.addr_o(irq_sel_lo)
+         ,.v_o(any_irq_lo)
+         );
+      wire [axil_addr_width_p-1:0] irq_offset_lo = irq_sel_lo << 2;
+
+      assign axil_v_li = any_irq_lo;
+      assign axil_w_li = 1'b1;
+      assign axil_addr_li = irq_addr_p + irq_offset_lo;
+      assign axil_data_li = '0;
+      assign axil_wmask_li = '1;
+    end
+  else
+    begin : coalesce
+      logic [irq_sources_p-1:0] irq_edge_lo;
+      for (genvar i = 0; i < irq_sources_p; i++)
+        begin : src
+          bsg_edge_detect
+           #(.falling_not_rising_p(0))
+           bed
+            (.clk_i(clk_i)
+             ,.reset_i(reset_i)
+
+             ,.sig_i(irq_r_i[i])
+             ,.detect_o(irq_edge_lo[i])
+             );
+        end
+
+      logic [irq_sources_p-1:0] pending_r;
+      logic [15:0] window_cnt;
+      logic [7:0] seq_r;
+
+      wire any_pending = |pending_r;
+      wire window_done = (window_cnt >= coalesce_window_i);
+      wire send = any_pending & window_done & axil_ready_and_lo;
+
+      // New edges are kept even in the cycle the bitmap is sent
+      bsg_dff_reset
+       #(.width_p(irq_sources_p))
+       pending_reg
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
+         ,.data_i((send ? '0 : pending_r) | irq_edge_lo)
+         ,.data_o(pending_r)
+         );
+
+      // Cycles since the oldest unsent edge
+      bsg_counter_clear_up
+       #(.max_val_p(2**16-1)
+         ,.init_val_p(0)
+         )
+       window_counter
         (.clk_i(clk_i)
          ,.reset_i(reset_i)
 
-         ,.sig_i(irq_detected_n[i])
-         ,.detect_o(irq_detected_r[i])
+         ,.clear_i(~any_pending | send)
+         ,.up_i(any_pending & ~window_done & ~send)
+         ,.count_o(window_cnt)
          );
-    end
 
-  localparam irq_id_width_lp = `BSG_SAFE_CLOG2(irq_sources_p);
-  logic [irq_id_width_lp-1:0] irq_sel_lo;
-  logic any_irq_lo;
-  bsg_priority_encode
-   #(.width_p(irq_sources_p), .lo_to_hi_p(1))
-   pe
-    (.i(irq_detected_r)
-     ,.addr_o(irq_sel_lo)
-     ,.v_o(any_irq_lo)
-     );
-  wire [axil_addr_width_p-1:0] irq_offset_lo = irq_sel_lo << 2;
+      bsg_counter_clear_up
+       #(.max_val_p(2**8-1)
+         ,.init_val_p(0)
+         ,.disable_overflow_warning_p(1)
+         )
+       seq_counter
+        (.clk_i(clk_i)
+         ,.reset_i(reset_i)
 
-  assign axil_v_li = any_irq_lo;
-  assign axil_w_li = 1'b1;
-  assign axil_addr_li = irq_addr_p + irq_offset_lo;
-  assign axil_data_li = '0;
-  assign axil_wmask_li = '1;
+         ,.clear_i(1'b0)
+         ,.up_i(send)
+         ,.count_o(seq_r)
+         );
+
+      assign axil_v_li = any_pending & window_done;
+      assign axil_w_li = 1'b1;
+      assign axil_addr_li = irq_addr_p;
+      assign axil_data_li = {seq_r, (axil_data_width_p-8)'(pending_r)};
+      assign axil_wmask_li = '1;
+
+      // synopsys translate_off
+      initial
+        begin
+          assert (irq_sources_p <= axil_data_width_p-8)
+            else $error("%m: irq_sources_p must fit below the sequence number");
+        end
+      // synopsys translate_on
+    end
 
   // Drop responses immediately
   assign axil_ready_and_li = 1'b1;
@@ -0,0 +1,218 @@
+
+/*
+ * Destination address filter for received frames. It watches the RX AXIS
+ * stream and decides whether the frame being received is accepted; rejected
+ * frames are dropped by ethernet_receiver without taking a packet buffer slot
+ * or raising an interrupt.
+ *
+ * A frame is accepted when the filter is promiscuous, or when its destination
+ *   - is unicast and equals the station address,
+ *   - is broadcast and broadcast is enabled,
+ *   - is multicast and all multicast is enabled or its hash bin is set.
+ * The hash bin is bits 31:26 of the Ethernet CRC of the address, computed LSB
+ * first without the final inversion (ether_crc_le(6, addr) >> 26 in Linux).
+ *
+ * The reset state is promiscuous with broadcast enabled, so drivers unaware
+ * of the filter see every frame.
+ *
+ * Registers (word offset from the filter register base):
+ *   0: Control (RW): bit 0 promiscuous, bit 1 broadcast enable, bit 2 all multicast
+ *   1: Station address low (RW): address bytes 0-3, byte 0 (first on the wire) in bits 7:0
+ *   2: Station address high (RW): address bytes 4-5 in bits 15:0
+ *   3: Multicast hash bins 31:0 (RW)
+ *   4: Multicast hash bins 63:32 (RW)
+ *   5: Unicast frames dropped (R)
+ *   6: Multicast frames dropped (R)
+ *   7: Broadcast frames dropped (R)
+ *
+ */
+
+`include "bsg_defines.sv"
+
+module address_filter #
+(
+      parameter  data_width_p      = 32
+    , localparam csr_addr_width_lp = 3
+    , localparam bytes_lp          = data_width_p/8
+)
+(
+      input  logic                         clk_i
+    , input  logic                         reset_i
+
+    /* Registers */
+    , input  logic                         csr_w_i
+    , input  logic [csr_addr_width_lp-1:0] csr_addr_i
+    , input  logic [31:0]                  csr_data_i
+    , output logic [31:0]                  csr_data_o
+
+    /* RX AXIS, observed only */
+    , input  logic [data_width_p-1:0]      rx_axis_tdata_i
+    , input  logic                         rx_axis_tvalid_i
+    , input  logic                         rx_axis_tready_i
+    , input  logic                         rx_axis_tlast_i
+    , input  logic                         rx_axis_tuser_i
+
+      // valid with the last word of a frame
+    , output logic                         accept_o
+);
+
+  localparam beat_width_lp = `BSG_SAFE_CLOG2(6/bytes_lp+2);
+
+  logic [2:0]               control_r;
+  logic [47:0]              mac_r, dst_r;
+  logic [63:0]              hash_r;
+  logic [15:0]              ucast_drop_r, mcast_drop_r, bcast_drop_r;
+  logic [beat_width_lp-1:0] beat_r;
+
+  wire csr_w_control = csr_w_i & (csr_addr_i == 3'd0);
+  wire csr_w_mac_lo  = csr_w_i & (csr_addr_i == 3'd1);
+  wire csr_w_mac_hi  = csr_w_i & (csr_addr_i == 3'd2);
+  wire csr_w_hash_lo = csr_w_i & (csr_addr_i == 3'd3);
+  wire csr_w_hash_hi = csr_w_i & (csr_addr_i == 3'd4);
+
+  bsg_dff_reset_en #(.width_p(3), .reset_val_p(3'b011))
+    control_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(csr_w_control)
+       ,.data_i(csr_data_i[2:0])
+       ,.data_o(control_r)
+    );
+
+  bsg_dff_reset_en #(.width_p(32))
+    mac_lo_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(csr_w_mac_lo)
+       ,.data_i(csr_data_i)
+       ,.data_o(mac_r[0+:32])
+    );
+
+  bsg_dff_reset_en #(.width_p(16))
+    mac_hi_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(csr_w_mac_hi)
+       ,.data_i(csr_data_i[15:0])
+       ,.data_o(mac_r[32+:16])
+    );
+
+  bsg_dff_reset_en #(.width_p(32))
+    hash_lo_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(csr_w_hash_lo)
+       ,.data_i(csr_data_i)
+       ,.data_o(hash_r[0+:32])
+    );
+
+  bsg_dff_reset_en #(.width_p(32))
+    hash_hi_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(csr_w_hash_hi)
+       ,.data_i(csr_data_i)
+       ,.data_o(hash_r[32+:32])
+    );
+
+  wire promiscuous  = control_r[0];
+  wire bcast_enable = control_r[1];
+  wire mcast_all    = control_r[2];
+
+  /* Destination address capture */
+  wire beat_v = rx_axis_tvalid_i & rx_axis_tready_i;
+
+  // Words of the current frame seen so far; saturates past the address
+  bsg_counter_clear_up #(.max_val_p(2**beat_width_lp-1)
+     ,.init_val_p(0))
+    beat_counter (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.clear_i(beat_v & rx_axis_tlast_i)
+       ,.up_i(beat_v & ~rx_axis_tlast_i & (beat_r != '1))
+       ,.count_o(beat_r)
+    );
+
+  always_ff @(posedge clk_i)
+    if(beat_v)
+      for(integer i = 0; i < bytes_lp; i++)
+        if(beat_r*bytes_lp + i < 6)
+          dst_r[(beat_r*bytes_lp + i)*8+:8] <= rx_axis_tdata_i[i*8+:8];
+
+  // Little-endian Ethernet CRC over the 48 address bits
+  function automatic logic [31:0] ether_crc_le(logic [47:0] addr);
+    logic [31:0] crc = '1;
+    for(integer i = 0; i < 48; i++)
+      crc = (crc >> 1) ^ ((crc[0] ^ addr[i]) ? 32'hEDB88320 : 32'h0);
+    return crc;
+  endfunction
+
+  /* Decision, from the address captured by the previous words */
+  wire [5:0] hash_bin = ether_crc_le(dst_r) >> 26;
+  wire bcast = (dst_r == '1);
+  wire mcast = dst_r[0] & ~bcast;
+  wire ucast = ~dst_r[0];
+
+  assign accept_o = promiscuous
+    | (ucast & (dst_r == mac_r))
+    | (bcast & bcast_enable)
+    | (mcast & (mcast_all | hash_r[hash_bin]));
+
+  // Only otherwise good frames are counted
+  wire drop_v = beat_v & rx_axis_tlast_i & ~rx_axis_tuser_i & ~accept_o;
+
+  bsg_flow_counter #(.els_p(2**16-1))
+   ucast_drop_count (
+    .clk_i(clk_i)
+   ,.reset_i(reset_i)
+   ,.v_i(drop_v & ucast)
+   ,.ready_param_i(1'b1)
+   ,.yumi_i(1'b0)
+
+   ,.count_o(ucast_drop_r)
+  );
+
+  bsg_flow_counter #(.els_p(2**16-1))
+   mcast_drop_count (
+    .clk_i(clk_i)
+   ,.reset_i(reset_i)
+   ,.v_i(drop_v & mcast)
+   ,.ready_param_i(1'b1)
+   ,.yumi_i(1'b0)
+
+   ,.count_o(mcast_drop_r)
+  );
+
+  bsg_flow_counter #(.els_p(2**16-1))
+   bcast_drop_count (
+    .clk_i(clk_i)
+   ,.reset_i(reset_i)
+   ,.v_i(drop_v & bcast)
+   ,.ready_param_i(1'b1)
+   ,.yumi_i(1'b0)
+
+   ,.count_o(bcast_drop_r)
+  );
+
+  always_comb begin
+    case (csr_addr_i)
+      3'd0: csr_data_o = 32'(control_r);
+      3'd1: csr_data_o = mac_r[0+:32];
+      3'd2: csr_data_o = 32'(mac_r[32+:16]);
+      3'd3: csr_data_o = hash_r[0+:32];
+      3'd4: csr_data_o = hash_r[32+:32];
+      3'd5: csr_data_o = 32'(ucast_drop_r);
+      3'd6: csr_data_o = 32'(mcast_drop_r);
+      3'd7: csr_data_o = 32'(bcast_drop_r);
+      default: csr_data_o = '0;
+    endcase
+  end
+
+  // synopsys translate_off
+  initial begin
+    assert(data_width_p == 32 || data_width_p == 64)
+      else $error("%m: unsupported data_width_p");
+  end
+  // synopsys translate_on
+
+endmodule
@@ -0,0 +1,61 @@
+
+/*
+ * Accumulates the 16-bit ones' complement sum (RFC 1071) of the bytes enabled
+ * by mask_i, one data_width_p word per cycle. Words are assumed to be
+ * aligned, so even byte lanes are the high byte of a 16-bit word and odd
+ * lanes the low byte (network order, lane 0 first).
+ *
+ * sum_o is the folded sum including the current word, so the sum of a
+ * packet is available in the same cycle as its last word. clear_i starts a
+ * new sum from the next cycle.
+ *
+ */
+
+`include "bsg_defines.sv"
+
+module checksum_accumulator #(
+      parameter  data_width_p = 32
+    , localparam bytes_lp     = data_width_p/8
+)
+(
+      input  logic                    clk_i
+    , input  logic                    reset_i
+
+    , input  logic                    clear_i
+    , input  logic                    v_i
+    , input  logic [data_width_p-1:0] data_i
+    , input  logic [bytes_lp-1:0]     mask_i
+
+    , output logic [15:0]             sum_o
+);
+
+  // Wide enough for eth_mtu_p <= 64KB without folding every cycle
+  logic [31:0] sum_r, sum_n, word_sum;
+
+  always_comb begin
+    word_sum = '0;
+    for(integer i = 0; i < bytes_lp; i++) begin
+      if(mask_i[i])
+        word_sum = word_sum + ((i % 2 == 0)
+          ? {data_i[i*8+:8], 8'h00}
+          : {8'h00, data_i[i*8+:8]});
+    end
+  end
+
+  assign sum_n = v_i ? (sum_r + word_sum) : sum_r;
+
+  bsg_dff_reset_en #(.width_p(32))
+    sum_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(v_i | clear_i)
+       ,.data_i(clear_i ? '0 : sum_n)
+       ,.data_o(sum_r)
+    );
+
+  // Two folds suffice: the first leaves at most 17 bits, and the second can
+  //   not carry again
+  wire [16:0] fold1 = sum_n[31:16] + sum_n[15:0];
+  assign sum_o = fold1[15:0] + fold1[16];
+
+endmodule
@@ -8,6 +8,11 @@
  *     TX Buffer:
  *       0x0800-0x1000
  *
+ *     The buffers are eth_mtu_p bytes each, so with jumbo frames (eth_mtu_p ==
+ *     0x4000) the RX buffer is 0x0000-0x4000 and the TX buffer 0x4000-0x8000.
+ *     The registers always follow the TX buffer, at 2*eth_mtu_p, and are
+ *     listed below at their offsets for eth_mtu_p == 0x800.
+ *
  *   2. Register Map:
  *
  *     Readable Register:
@@ -16,7 +21,25 @@
  *       0x1010: RX Event Pending Bit              (a.k.a LITEETH_WRITER_EV_PENDING)
  *       0x101C: TX Ready Bit                      (a.k.a LITEETH_READER_READY)
  *       0x1030: TX Event Pending Bit              (a.k.a LITEETH_READER_EV_PENDING)
+ *       0x1038: RX Coalesce Frames                (not compatible with Liteeth)
+ *       0x103C: RX Coalesce Timeout               (not compatible with Liteeth)
+ *       0x1040: RX Pending Frames                 (not compatible with Liteeth)
+ *       0x1044: TX Coalesce Events                (not compatible with Liteeth)
+ *       0x1048: TX Coalesce Timeout               (not compatible with Liteeth)
+ *       0x104C: TX Pending Events                 (not compatible with Liteeth)
  *       0x1050: Debug Info                        (not compatible with Liteeth)
+ *       0x1054: RX Checksum Status                (not compatible with Liteeth)
+ *       0x1058: TX Checksum Control               (not compatible with Liteeth)
+ *       0x1060: RX Ring Head (oldest packet slot)  (not compatible with Liteeth)
+ *       0x1064: RX Ring Tail (next free slot)      (not compatible with Liteeth)
+ *       0x1068: RX Ring Count                      (not compatible with Liteeth)
+ *       0x106C: RX Packets Dropped on Full Ring    (not compatible with Liteeth)
+ *       0x1070: TX Ring Head (transmitting slot)   (not compatible with Liteeth)
+ *       0x1074: TX Ring Tail (slot being written)  (not compatible with Liteeth)
+ *       0x1078: TX Ring Count                      (not compatible with Liteeth)
+ *       0x107C: Ring Sizes {TX slots, RX slots}    (not compatible with Liteeth)
+ *       0x1080-0x10A4: DMA Registers               (not compatible with Liteeth)
+ *       0x10C0-0x10DC: Address Filter Registers    (not compatible with Liteeth)
  *
  *     Writable Register:
  *       0x1010: RX Event Pending Bit              (a.k.a LITEETH_WRITER_EV_PENDING)
@@ -26,6 +49,79 @@
  *       0x1028: Length of the Transmitting Packet (a.k.a LITEETH_READER_LENGTH)
  *       0x1030: TX Event Pending Bit              (a.k.a LITEETH_READER_EV_PENDING)
  *       0x1034: TX Event Enable Bit               (a.k.a LITEETH_READER_EV_ENABLE)
+ *       0x1038: RX Coalesce Frames                (not compatible with Liteeth)
+ *       0x103C: RX Coalesce Timeout               (not compatible with Liteeth)
+ *       0x1044: TX Coalesce Events                (not compatible with Liteeth)
+ *       0x1048: TX Coalesce Timeout               (not compatible with Liteeth)
+ *       0x1058: TX Checksum Control               (not compatible with Liteeth)
+ *       0x1080-0x10A4: DMA Registers               (not compatible with Liteeth)
+ *       0x10C0-0x10D0: Address Filter Registers    (not compatible with Liteeth)
+ *
+ *   3. Rings:
+ *
+ *     Received packets are queued in an RX ring and software-written packets in a TX ring.
+ *     The RX buffer window always shows the packet at the RX head; acking it (writing
+ *     the RX pending bit) advances the head. The TX buffer window always maps to the TX
+ *     tail; sending it advances the tail, and the TX ready bit stays set while free slots
+ *     remain, so several packets can be queued back-to-back. Liteeth drivers, which
+ *     assume one slot, keep working unchanged.
+ *
+ *   4. Interrupt Coalescing:
+ *
+ *     An interrupt is raised once the number of pending frames (RX frames
+ *     waiting for software, or TX frames sent to the MAC since the last TX
+ *     clear) reaches the coalesce count, or once the oldest has been pending
+ *     for the coalesce timeout (in clk_i cycles), whichever comes first. A
+ *     count of 0 or 1 interrupts on every frame and a timeout of 0 disables
+ *     the timer, which is the reset state. The pending bits are unaffected. At
+ *     most rx_slot_p RX frames can be pending, or the RX ring slots with DMA;
+ *     a larger RX count is clamped to that when written and reads back
+ *     clamped.
+ *
+ *   5. Checksum Offload:
+ *
+ *     RX Checksum Status holds the checksum result of the packet at the RX head
+ *     (see ethernet_receiver.sv): bit 0/1 IPv4 header checked/good, bit 2/3
+ *     TCP/UDP checked/good.
+ *     TX Checksum Control applies to the packets written after it (see
+ *     ethernet_sender.sv): bit 31 enable, bits 16 and up offset of the checksum
+ *     field, bits 0 and up offset where the summed bytes start (each
+ *     $clog2(eth_mtu_p) bits, i.e. 26:16 and 10:0 for eth_mtu_p == 0x800).
+ *
+ *   6. DMA:
+ *
+ *     0x1080-0x10A4 are the ethernet_dma registers (see ethernet_dma.sv):
+ *       0x1080: DMA Control {TX enable, RX enable} (RW)
+ *       0x1084: RX Buffer Base                     (RW)
+ *       0x1088: RX Size Base                       (RW)
+ *       0x108C: RX Ring Slots                      (RW)
+ *       0x1090: RX Producer Index                  (R)
+ *       0x1094: RX Consumer Index                  (RW)
+ *       0x1098: TX Descriptor Address              (RW)
+ *       0x109C: TX Descriptor Length/Queue Ready   (W/R)
+ *       0x10A0: TX Packets Fetched                 (R)
+ *       0x10A4: TX Descriptor Checksum Control     (RW)
+ *     With RX DMA enabled, packets are copied to memory instead of being read
+ *     through the RX buffer window, and the RX event is pending while the memory
+ *     ring holds unconsumed slots. The RX checksum status of each packet is
+ *     written with its size, in bits 19:16. With TX DMA enabled, packets are
+ *     fetched from memory by descriptor instead of being written through the TX
+ *     buffer window, and TX checksum control comes with each descriptor instead
+ *     of 0x1058.
+ *
+ *   7. Address Filter:
+ *
+ *     0x10C0-0x10DC are the address_filter registers (see address_filter.sv):
+ *       0x10C0: Filter Control {all multicast, broadcast, promiscuous} (RW)
+ *       0x10C4: Station Address Bytes 0-3          (RW)
+ *       0x10C8: Station Address Bytes 4-5          (RW)
+ *       0x10CC: Multicast Hash Bins 31:0           (RW)
+ *       0x10D0: Multicast Hash Bins 63:32          (RW)
+ *       0x10D4: Unicast Frames Dropped             (R)
+ *       0x10D8: Multicast Frames Dropped           (R)
+ *       0x10DC: Broadcast Frames Dropped           (R)
+ *     Rejected frames never take an RX slot, so they raise no interrupt and
+ *     are not seen by the DMA engine. The reset state accepts every frame.
  *
  * Link:
  *   https://elixir.bootlin.com/linux/v5.15/source/drivers/net/ethernet/litex/litex_liteeth.c
@@ -39,9 +135,18 @@ module ethernet_control_unit #
 (
       parameter  eth_mtu_p            = 2048 // byte
     , parameter  data_width_p         = 32
+    , parameter  rx_slot_p            = 2
+    , parameter  tx_slot_p            = 2
     , localparam packet_size_width_lp = $clog2(eth_mtu_p+1)
     , localparam packet_addr_width_lp = $clog2(eth_mtu_p)
-    , localparam addr_width_lp        = 14
+    , localparam addr_width_lp        = packet_addr_width_lp + 3
+    , localparam dma_csr_addr_width_lp = 4
+    , localparam filter_csr_addr_width_lp = 3
+    , localparam csum_status_width_lp  = 4
+    , localparam rx_slot_ptr_width_lp   = `BSG_SAFE_CLOG2(rx_slot_p)
+    , localparam rx_slot_count_width_lp = `BSG_WIDTH(rx_slot_p)
+    , localparam tx_slot_ptr_width_lp   = `BSG_SAFE_CLOG2(tx_slot_p)
+    , localparam tx_slot_count_width_lp = `BSG_WIDTH(tx_slot_p)
 )
 (
       input  bit                                clk_i
@@ -56,6 +161,24 @@ module ethernet_control_unit #
 
     , input  logic [15:0]                       debug_info_i
 
+    , input  logic [rx_slot_ptr_width_lp-1:0]   rx_slot_head_i
+    , input  logic [rx_slot_ptr_width_lp-1:0]   rx_slot_tail_i
+    , input  logic [rx_slot_count_width_lp-1:0] rx_slot_count_i
+    , input  logic [15:0]                       rx_drop_count_i
+    , input  logic [tx_slot_ptr_width_lp-1:0]   tx_slot_head_i
+    , input  logic [tx_slot_ptr_width_lp-1:0]   tx_slot_tail_i
+    , input  logic [tx_slot_count_width_lp-1:0] tx_slot_count_i
+    , input  logic [15:0]                       rx_pending_count_i
+    , input  logic [15:0]                       tx_pending_count_i
+
+    , output logic                              dma_csr_w_o
+    , output logic [dma_csr_addr_width_lp-1:0]  dma_csr_addr_o
+    , input  logic [data_width_p-1:0]           dma_csr_data_i
+
+    , output logic                              filter_csr_w_o
+    , output logic [filter_csr_addr_width_lp-1:0] filter_csr_addr_o
+    , input  logic [data_width_p-1:0]           filter_csr_data_i
+
     , output logic                              packet_send_o
     , input  logic                              packet_req_i
     , output logic                              packet_wsize_valid_o
@@ -71,6 +194,11 @@ module ethernet_control_unit #
     , output logic [packet_addr_width_lp-1:0]   packet_raddr_o
     , input  logic [data_width_p-1:0]           packet_rdata_i
     , input  logic [packet_size_width_lp-1:0]   packet_rsize_i
+    , input  logic [csum_status_width_lp-1:0]   packet_rstatus_i
+
+    , output logic                              tx_csum_en_o
+    , output logic [packet_addr_width_lp-1:0]   tx_csum_start_o
+    , output logic [packet_addr_width_lp-1:0]   tx_csum_offset_o
 
     , output logic                              tx_interrupt_clear_o
 
@@ -80,6 +208,16 @@ module ethernet_control_unit #
     , output logic                              rx_interrupt_enable_v_o
     , output logic                              tx_interrupt_enable_o
     , output logic                              tx_interrupt_enable_v_o
+
+    , output logic [15:0]                       coalesce_data_o
+    , output logic                              rx_coalesce_frames_v_o
+    , output logic                              rx_coalesce_timeout_v_o
+    , output logic                              tx_coalesce_frames_v_o
+    , output logic                              tx_coalesce_timeout_v_o
+    , input  logic [15:0]                       rx_coalesce_frames_i
+    , input  logic [15:0]                       rx_coalesce_timeout_i
+    , input  logic [15:0]                       tx_coalesce_frames_i
+    , input  logic [15:0]                       tx_coalesce_timeout_i
 );
 
   logic buffer_read_v_r;
@@ -88,6 +226,21 @@ module ethernet_control_unit #
   // Not used in this Ethernet controller, always points to 0
   logic tx_idx_r, tx_idx_n;
   logic io_decode_error;
+  logic tx_csum_w;
+
+  // Registers are decoded at their offsets for eth_mtu_p == 0x800, whatever
+  //   eth_mtu_p is; buffer accesses decode as 16'h0???
+  localparam reg_base_lp = 2*eth_mtu_p;
+  wire [addr_width_lp-1:0] reg_offset = addr_i - addr_width_lp'(reg_base_lp);
+  logic [15:0] reg_addr;
+  always_comb begin
+    if(addr_i < addr_width_lp'(reg_base_lp))
+      reg_addr = 16'h0000;
+    else if(reg_offset < addr_width_lp'('h1000))
+      reg_addr = 16'h1000 | 16'(reg_offset);
+    else
+      reg_addr = 16'hFFFF;
+  end
 
   bsg_dff_reset_en
    #(.width_p(data_width_p + 2))
@@ -120,11 +273,21 @@ module ethernet_control_unit #
     tx_interrupt_enable_o = 1'b0;
     tx_interrupt_enable_v_o = 1'b0;
 
+    rx_coalesce_frames_v_o = 1'b0;
+    rx_coalesce_timeout_v_o = 1'b0;
+    tx_coalesce_frames_v_o = 1'b0;
+    tx_coalesce_timeout_v_o = 1'b0;
+
     packet_wsize_o = '0;
     packet_wsize_valid_o = 1'b0;
-    casez(addr_i)
+
+    tx_csum_w = 1'b0;
+
+    dma_csr_w_o = 1'b0;
+    filter_csr_w_o = 1'b0;
+    casez(reg_addr)
       16'h0???: begin
-        if(addr_i < 16'h0800) begin
+        if(addr_i < addr_width_lp'(eth_mtu_p)) begin
           // RX buffer; R
           if(read_en_i) begin
             packet_raddr_o = addr_i[packet_addr_width_lp-1:0];
@@ -231,6 +394,48 @@ module ethernet_control_unit #
           tx_interrupt_enable_v_o = 1'b1;
         end
       end
+      16'h1038: begin
+        // RX coalesce frames; RW
+        if(read_en_i)
+          readable_reg_n = rx_coalesce_frames_i;
+        if(write_en_i)
+          rx_coalesce_frames_v_o = 1'b1;
+      end
+      16'h103C: begin
+        // RX coalesce timeout; RW
+        if(read_en_i)
+          readable_reg_n = rx_coalesce_timeout_i;
+        if(write_en_i)
+          rx_coalesce_timeout_v_o = 1'b1;
+      end
+      16'h1040: begin
+        // RX pending frames; R
+        if(read_en_i)
+          readable_reg_n = rx_pending_count_i;
+        if(write_en_i)
+          io_decode_error = 1'b1;
+      end
+      16'h1044: begin
+        // TX coalesce events; RW
+        if(read_en_i)
+          readable_reg_n = tx_coalesce_frames_i;
+        if(write_en_i)
+          tx_coalesce_frames_v_o = 1'b1;
+      end
+      16'h1048: begin
+        // TX coalesce timeout; RW
+        if(read_en_i)
+          readable_reg_n = tx_coalesce_timeout_i;
+        if(write_en_i)
+          tx_coalesce_timeout_v_o = 1'b1;
+      end
+      16'h104C: begin
+        // TX pending events; R
+        if(read_en_i)
+          readable_reg_n = tx_pending_count_i;
+        if(write_en_i)
+          io_decode_error = 1'b1;
+      end
       16'h1050: begin
         // Debug Info; R
         if(read_en_i)
@@ -238,6 +443,94 @@ module ethernet_control_unit #
         if(write_en_i)
           io_decode_error = 1'b1;
       end
+      16'h1054: begin
+        // RX checksum status; R
+        if(read_en_i) begin
+          if(packet_avail_i)
+            readable_reg_n = packet_rstatus_i;
+        end
+        if(write_en_i)
+          io_decode_error = 1'b1;
+      end
+      16'h1058: begin
+        // TX checksum control; RW
+        if(read_en_i)
+          readable_reg_n = {tx_csum_en_o
+                            ,(15-packet_addr_width_lp)'(0), tx_csum_offset_o
+                            ,(16-packet_addr_width_lp)'(0), tx_csum_start_o};
+        if(write_en_i)
+          tx_csum_w = 1'b1;
+      end
+      16'h1060: begin
+        // RX ring head; R
+        if(read_en_i)
+          readable_reg_n = rx_slot_head_i;
+        if(write_en_i)
+          io_decode_error = 1'b1;
+      end
+      16'h1064: begin
+        // RX ring tail; R
+        if(read_en_i)
+          readable_reg_n = rx_slot_tail_i;
+        if(write_en_i)
+          io_decode_error = 1'b1;
+      end
+      16'h1068: begin
+        // RX ring count; R
+        if(read_en_i)
+          readable_reg_n = rx_slot_count_i;
+        if(write_en_i)
+          io_decode_error = 1'b1;
+      end
+      16'h106C: begin
+        // RX packets dropped while the ring was full; R
+        if(read_en_i)
+          readable_reg_n = rx_drop_count_i;
+        if(write_en_i)
+          io_decode_error = 1'b1;
+      end
+      16'h1070: begin
+        // TX ring head; R
+        if(read_en_i)
+          readable_reg_n = tx_slot_head_i;
+        if(write_en_i)
+          io_decode_error = 1'b1;
+      end
+      16'h1074: begin
+        // TX ring tail; R
+        if(read_en_i)
+          readable_reg_n = tx_slot_tail_i;
+        if(write_en_i)
+          io_decode_error = 1'b1;
+      end
+      16'h1078: begin
+        // TX ring count; R
+        if(read_en_i)
+          readable_reg_n = tx_slot_count_i;
+        if(write_en_i)
+          io_decode_error = 1'b1;
+      end
+      16'h107C: begin
+        // Ring sizes; R
+        if(read_en_i)
+          readable_reg_n = {16'(tx_slot_p), 16'(rx_slot_p)};
+        if(write_en_i)
+          io_decode_error = 1'b1;
+      end
+      16'h108?, 16'h109?, 16'h10A0, 16'h10A4: begin
+        // DMA registers; RW
+        if(read_en_i)
+          readable_reg_n = dma_csr_data_i;
+        if(write_en_i)
+          dma_csr_w_o = 1'b1;
+      end
+      16'h10C?, 16'h10D?: begin
+        // Address filter registers; RW
+        if(read_en_i)
+          readable_reg_n = filter_csr_data_i;
+        if(write_en_i)
+          filter_csr_w_o = 1'b1;
+      end
 
       default: begin
         // Unsupported MMIO
@@ -249,9 +542,24 @@ module ethernet_control_unit #
       io_decode_error = 1'b1;
   end
 
+  bsg_dff_reset_en #(.width_p(1+2*packet_addr_width_lp))
+    tx_csum_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(tx_csum_w)
+       ,.data_i({write_data_i[31]
+                ,write_data_i[16+:packet_addr_width_lp]
+                ,write_data_i[0+:packet_addr_width_lp]})
+       ,.data_o({tx_csum_en_o, tx_csum_offset_o, tx_csum_start_o})
+    );
+
   // Output can either come from RX buffer or registers
   assign read_data_o = buffer_read_v_r ? packet_rdata_i : readable_reg_r;
 
+  assign dma_csr_addr_o = addr_i[2+:dma_csr_addr_width_lp];
+  assign filter_csr_addr_o = addr_i[2+:filter_csr_addr_width_lp];
+  assign coalesce_data_o = write_data_i[15:0];
+
   assign packet_ack_o       = rx_interrupt_clear;
   assign tx_interrupt_clear_o = tx_interrupt_clear;
 
@@ -263,8 +571,9 @@ module ethernet_control_unit #
     end
   end
   initial begin
-    assert(eth_mtu_p <= 2048)
-      else $error("%m: eth_mtu_p should be <= 2048");
+    // Checksum control offsets must fit below bit 31; slots are power of 2 apart
+    assert(eth_mtu_p >= 2048 && eth_mtu_p <= 16384 && (eth_mtu_p & (eth_mtu_p-1)) == 0)
+      else $error("%m: eth_mtu_p should be a power of 2 from 2048 to 16384");
     assert(data_width_p == 32)
       else $error("%m: unsupported data_width_p");
   end
@@ -5,7 +5,15 @@ module ethernet_controller #
 (
       parameter  data_width_p  = 32
     , parameter  ifg_delay_p   = 8'd12
-    , localparam addr_width_lp = 14
+      // packets queued in each direction
+    , parameter  rx_slot_p     = 8
+    , parameter  tx_slot_p     = 4
+      // memory address width of the DMA master
+    , parameter  dma_addr_width_p = 32
+    , parameter  tx_desc_els_p    = 4
+      // maximum size of a packet, 16384 for jumbo frames (9000 byte payload)
+    , parameter  eth_mtu_p     = 2048 // byte
+    , localparam addr_width_lp = $clog2(eth_mtu_p) + 3
 )
 (
     // For user logic
@@ -34,6 +42,18 @@ module ethernet_controller #
     , output logic                              rx_interrupt_pending_o
     , output logic                              tx_interrupt_pending_o
 
+    // DMA memory requests (fifo interface, see bsg_axil_fifo_master)
+    , output logic [data_width_p-1:0]           dma_data_o
+    , output logic [dma_addr_width_p-1:0]       dma_addr_o
+    , output logic                              dma_v_o
+    , output logic                              dma_w_o
+    , output logic [data_width_p/8-1:0]         dma_wmask_o
+    , input  logic                              dma_ready_and_i
+
+    , input  logic [data_width_p-1:0]           dma_data_i
+    , input  logic                              dma_v_i
+    , output logic                              dma_ready_and_o
+
     , input  logic                              rgmii_rx_clk_i
     , input  logic [3:0]                        rgmii_rxd_i
     , input  logic                              rgmii_rx_ctl_i
@@ -42,9 +62,16 @@ module ethernet_controller #
     , output logic                              rgmii_tx_ctl_o
 );
 
-  localparam eth_mtu_lp = 2048; // byte
-  localparam packet_size_width_lp = $clog2(eth_mtu_lp+1);
-  localparam packet_addr_width_lp = $clog2(eth_mtu_lp);
+  localparam packet_size_width_lp = $clog2(eth_mtu_p+1);
+  localparam packet_addr_width_lp = $clog2(eth_mtu_p);
+  localparam rx_slot_ptr_width_lp   = `BSG_SAFE_CLOG2(rx_slot_p);
+  localparam rx_slot_count_width_lp = `BSG_WIDTH(rx_slot_p);
+  localparam tx_slot_ptr_width_lp   = `BSG_SAFE_CLOG2(tx_slot_p);
+  localparam tx_slot_count_width_lp = `BSG_WIDTH(tx_slot_p);
+
+  localparam dma_csr_addr_width_lp = 4;
+  localparam csum_status_width_lp  = 4;
+  localparam filter_csr_addr_width_lp = 3;
 
   logic packet_send_lo;
   logic packet_avail_lo;
@@ -64,6 +91,46 @@ module ethernet_controller #
   logic                             packet_rvalid_lo;
 
   logic [packet_size_width_lp-1:0]  packet_rsize_lo;
+  logic [csum_status_width_lp-1:0]  packet_rstatus_lo;
+
+  logic                             tx_csum_en_lo;
+  logic [packet_addr_width_lp-1:0]  tx_csum_start_lo, tx_csum_offset_lo;
+
+  // Packet buffer ports after selecting between MMIO and DMA
+  logic                             packet_send_li;
+  logic                             packet_ack_li;
+  logic                             packet_wsize_valid_li;
+  logic [packet_size_width_lp-1:0]  packet_wsize_li;
+  logic                             packet_wvalid_li;
+  logic [packet_addr_width_lp-1:0]  packet_waddr_li;
+  logic [data_width_p/8-1:0]        packet_wmask_li;
+  logic [data_width_p-1:0]          packet_wdata_li;
+  logic                             packet_rvalid_li;
+  logic [packet_addr_width_lp-1:0]  packet_raddr_li;
+  logic                             tx_csum_en_li;
+  logic [packet_addr_width_lp-1:0]  tx_csum_start_li, tx_csum_offset_li;
+
+  logic                             dma_csr_w_lo;
+  logic [dma_csr_addr_width_lp-1:0] dma_csr_addr_lo;
+  logic [data_width_p-1:0]          dma_csr_data_lo;
+  logic                             dma_rx_enable_lo, dma_tx_enable_lo;
+  logic                             filter_csr_w_lo;
+  logic [filter_csr_addr_width_lp-1:0] filter_csr_addr_lo;
+  logic [data_width_p-1:0]          filter_csr_data_lo;
+  logic                             filter_accept_lo;
+  logic [15:0]                      dma_rx_pending_count_lo, dma_rx_slots_lo;
+  logic                             dma_packet_send_lo;
+  logic                             dma_packet_ack_lo;
+  logic                             dma_packet_wsize_valid_lo;
+  logic [packet_size_width_lp-1:0]  dma_packet_wsize_lo;
+  logic                             dma_packet_wvalid_lo;
+  logic [packet_addr_width_lp-1:0]  dma_packet_waddr_lo;
+  logic [data_width_p/8-1:0]        dma_packet_wmask_lo;
+  logic [data_width_p-1:0]          dma_packet_wdata_lo;
+  logic                             dma_packet_rvalid_lo;
+  logic [packet_addr_width_lp-1:0]  dma_packet_raddr_lo;
+  logic                             dma_tx_csum_en_lo;
+  logic [packet_addr_width_lp-1:0]  dma_tx_csum_start_lo, dma_tx_csum_offset_lo;
 
   logic       tx_error_underflow_lo;
   logic       tx_fifo_overflow_lo;
@@ -76,11 +143,24 @@ module ethernet_controller #
   logic       rx_fifo_good_frame_lo;
   logic [1:0] speed_lo;
 
+  logic [rx_slot_ptr_width_lp-1:0]   rx_slot_head_lo, rx_slot_tail_lo;
+  logic [rx_slot_count_width_lp-1:0] rx_slot_count_lo;
+  logic [tx_slot_ptr_width_lp-1:0]   tx_slot_head_lo, tx_slot_tail_lo;
+  logic [tx_slot_count_width_lp-1:0] tx_slot_count_lo;
+  logic [15:0]                       rx_drop_count_lo;
+
   logic tx_interrupt_clear_lo;
   logic rx_interrupt_enable_lo, rx_interrupt_enable_v_lo;
   logic tx_interrupt_enable_lo, tx_interrupt_enable_v_lo;
   logic rx_interrupt_pending_lo, tx_interrupt_pending_lo;
 
+  logic [15:0] coalesce_data_lo;
+  logic        rx_coalesce_frames_v_lo, rx_coalesce_timeout_v_lo;
+  logic        tx_coalesce_frames_v_lo, tx_coalesce_timeout_v_lo;
+  logic [15:0] rx_coalesce_frames_lo, rx_coalesce_timeout_lo;
+  logic [15:0] tx_coalesce_frames_lo, tx_coalesce_timeout_lo;
+  logic [15:0] rx_pending_count_lo, tx_pending_count_lo;
+
 
   logic [data_width_p-1:0]   tx_axis_tdata_lo;
   logic [data_width_p/8-1:0] tx_axis_tkeep_lo;
@@ -110,9 +190,24 @@ module ethernet_controller #
    ,speed_lo
    };
 
+  // The MAC drops incoming packets once its fifo overflows, which only
+  //   happens while the RX ring is full and backpressuring it
+  bsg_flow_counter #(.els_p(2**16-1))
+   rx_drop_count (
+    .clk_i(clk_i)
+   ,.reset_i(reset_i)
+   ,.v_i(rx_fifo_overflow_lo)
+   ,.ready_param_i(1'b1)
+   ,.yumi_i(1'b0)
+
+   ,.count_o(rx_drop_count_lo)
+  );
+
   ethernet_control_unit #(
-    .eth_mtu_p(eth_mtu_lp)
+    .eth_mtu_p(eth_mtu_p)
    ,.data_width_p(data_width_p)
+   ,.rx_slot_p(rx_slot_p)
+   ,.tx_slot_p(tx_slot_p)
   ) ethernet_control_unit (
     .clk_i
    ,.reset_i
@@ -126,6 +221,22 @@ module ethernet_controller #
 
    ,.debug_info_i(debug_info_li)
 
+   ,.rx_slot_head_i(rx_slot_head_lo)
+   ,.rx_slot_tail_i(rx_slot_tail_lo)
+   ,.rx_slot_count_i(rx_slot_count_lo)
+   ,.rx_drop_count_i(rx_drop_count_lo)
+   ,.tx_slot_head_i(tx_slot_head_lo)
+   ,.tx_slot_tail_i(tx_slot_tail_lo)
+   ,.tx_slot_count_i(tx_slot_count_lo)
+
+   ,.dma_csr_w_o(dma_csr_w_lo)
+   ,.dma_csr_addr_o(dma_csr_addr_lo)
+   ,.dma_csr_data_i(dma_csr_data_lo)
+
+   ,.filter_csr_w_o(filter_csr_w_lo)
+   ,.filter_csr_addr_o(filter_csr_addr_lo)
+   ,.filter_csr_data_i(filter_csr_data_lo)
+
    ,.packet_send_o(packet_send_lo)
    ,.packet_req_i(packet_req_lo)
    ,.packet_wsize_valid_o(packet_wsize_valid_lo)
@@ -141,6 +252,11 @@ module ethernet_controller #
    ,.packet_raddr_o(packet_raddr_lo)
    ,.packet_rdata_i(packet_rdata_lo)
    ,.packet_rsize_i(packet_rsize_lo)
+   ,.packet_rstatus_i(packet_rstatus_lo)
+
+   ,.tx_csum_en_o(tx_csum_en_lo)
+   ,.tx_csum_start_o(tx_csum_start_lo)
+   ,.tx_csum_offset_o(tx_csum_offset_lo)
 
    ,.tx_interrupt_clear_o(tx_interrupt_clear_lo)
 
@@ -150,24 +266,130 @@ module ethernet_controller #
    ,.rx_interrupt_enable_v_o(rx_interrupt_enable_v_lo)
    ,.tx_interrupt_enable_o(tx_interrupt_enable_lo)
    ,.tx_interrupt_enable_v_o(tx_interrupt_enable_v_lo)
+
+   ,.coalesce_data_o(coalesce_data_lo)
+   ,.rx_coalesce_frames_v_o(rx_coalesce_frames_v_lo)
+   ,.rx_coalesce_timeout_v_o(rx_coalesce_timeout_v_lo)
+   ,.tx_coalesce_frames_v_o(tx_coalesce_frames_v_lo)
+   ,.tx_coalesce_timeout_v_o(tx_coalesce_timeout_v_lo)
+   ,.rx_coalesce_frames_i(rx_coalesce_frames_lo)
+   ,.rx_coalesce_timeout_i(rx_coalesce_timeout_lo)
+   ,.tx_coalesce_frames_i(tx_coalesce_frames_lo)
+   ,.tx_coalesce_timeout_i(tx_coalesce_timeout_lo)
+   ,.rx_pending_count_i(rx_pending_count_lo)
+   ,.tx_pending_count_i(tx_pending_count_lo)
   );
 
+  ethernet_dma #(
+    .data_width_p(data_width_p)
+   ,.addr_width_p(dma_addr_width_p)
+   ,.eth_mtu_p(eth_mtu_p)
+   ,.tx_desc_els_p(tx_desc_els_p)
+  ) dma (
+    .clk_i
+   ,.reset_i
+
+   ,.csr_w_i(dma_csr_w_lo)
+   ,.csr_addr_i(dma_csr_addr_lo)
+   ,.csr_data_i(write_data_i)
+   ,.csr_data_o(dma_csr_data_lo)
+
+   ,.rx_enable_o(dma_rx_enable_lo)
+   ,.tx_enable_o(dma_tx_enable_lo)
+   ,.rx_pending_count_o(dma_rx_pending_count_lo)
+   ,.rx_slots_o(dma_rx_slots_lo)
+
+   ,.packet_ack_o(dma_packet_ack_lo)
+   ,.packet_avail_i(packet_avail_lo)
+   ,.packet_rvalid_o(dma_packet_rvalid_lo)
+   ,.packet_raddr_o(dma_packet_raddr_lo)
+   ,.packet_rdata_i(packet_rdata_lo)
+   ,.packet_rsize_i(packet_rsize_lo)
+   ,.packet_rstatus_i(packet_rstatus_lo)
+
+   ,.packet_send_o(dma_packet_send_lo)
+   ,.packet_req_i(packet_req_lo)
+   ,.packet_wsize_valid_o(dma_packet_wsize_valid_lo)
+   ,.packet_wsize_o(dma_packet_wsize_lo)
+   ,.packet_wvalid_o(dma_packet_wvalid_lo)
+   ,.packet_waddr_o(dma_packet_waddr_lo)
+   ,.packet_wdata_o(dma_packet_wdata_lo)
+   ,.packet_wmask_o(dma_packet_wmask_lo)
+   ,.tx_csum_en_o(dma_tx_csum_en_lo)
+   ,.tx_csum_start_o(dma_tx_csum_start_lo)
+   ,.tx_csum_offset_o(dma_tx_csum_offset_lo)
+
+   ,.mem_data_o(dma_data_o)
+   ,.mem_addr_o(dma_addr_o)
+   ,.mem_v_o(dma_v_o)
+   ,.mem_w_o(dma_w_o)
+   ,.mem_wmask_o(dma_wmask_o)
+   ,.mem_ready_and_i(dma_ready_and_i)
+
+   ,.mem_data_i(dma_data_i)
+   ,.mem_v_i(dma_v_i)
+   ,.mem_ready_and_o(dma_ready_and_o)
+  );
+
+  // The DMA engine owns a packet buffer while it is enabled in that direction
+  always_comb begin
+    if(dma_tx_enable_lo) begin
+      packet_send_li        = dma_packet_send_lo;
+      packet_wsize_valid_li = dma_packet_wsize_valid_lo;
+      packet_wsize_li       = dma_packet_wsize_lo;
+      packet_wvalid_li      = dma_packet_wvalid_lo;
+      packet_waddr_li       = dma_packet_waddr_lo;
+      packet_wdata_li       = dma_packet_wdata_lo;
+      packet_wmask_li       = dma_packet_wmask_lo;
+      tx_csum_en_li         = dma_tx_csum_en_lo;
+      tx_csum_start_li      = dma_tx_csum_start_lo;
+      tx_csum_offset_li     = dma_tx_csum_offset_lo;
+    end
+    else begin
+      packet_send_li        = packet_send_lo;
+      packet_wsize_valid_li = packet_wsize_valid_lo;
+      packet_wsize_li       = packet_wsize_lo;
+      packet_wvalid_li      = packet_wvalid_lo;
+      packet_waddr_li       = packet_waddr_lo;
+      packet_wdata_li       = packet_wdata_lo;
+      packet_wmask_li       = packet_wmask_lo;
+      tx_csum_en_li         = tx_csum_en_lo;
+      tx_csum_start_li      = tx_csum_start_lo;
+      tx_csum_offset_li     = tx_csum_offset_lo;
+    end
+    if(dma_rx_enable_lo) begin
+      packet_ack_li    = dma_packet_ack_lo;
+      packet_rvalid_li = dma_packet_rvalid_lo;
+      packet_raddr_li  = dma_packet_raddr_lo;
+    end
+    else begin
+      packet_ack_li    = packet_ack_lo;
+      packet_rvalid_li = packet_rvalid_lo;
+      packet_raddr_li  = packet_raddr_lo;
+    end
+  end
+
 
   ethernet_sender #(
        .data_width_p(data_width_p)
-      ,.eth_mtu_p(eth_mtu_lp))
+      ,.eth_mtu_p(eth_mtu_p)
+      ,.slot_p(tx_slot_p))
    sender (
        .clk_i(clk_i)
       ,.reset_i(reset_i)
 
-      ,.packet_send_i(packet_send_lo)
+      ,.packet_send_i(packet_send_li)
       ,.packet_req_o(packet_req_lo)
-      ,.packet_wsize_valid_i(packet_wsize_valid_lo)
-      ,.packet_wsize_i(packet_wsize_lo)
-      ,.packet_wvalid_i(packet_wvalid_lo)
-      ,.packet_waddr_i(packet_waddr_lo)
-      ,.packet_wdata_i(packet_wdata_lo)
-      ,.packet_wmask_i(packet_wmask_lo)
+      ,.packet_wsize_valid_i(packet_wsize_valid_li)
+      ,.packet_wsize_i(packet_wsize_li)
+      ,.packet_wvalid_i(packet_wvalid_li)
+      ,.packet_waddr_i(packet_waddr_li)
+      ,.packet_wdata_i(packet_wdata_li)
+      ,.packet_wmask_i(packet_wmask_li)
+
+      ,.csum_en_i(tx_csum_en_li)
+      ,.csum_start_i(tx_csum_start_li)
+      ,.csum_offset_i(tx_csum_offset_li)
 
       ,.tx_axis_tdata_o(tx_axis_tdata_lo)
       ,.tx_axis_tkeep_o(tx_axis_tkeep_lo)
@@ -177,21 +399,26 @@ module ethernet_controller #
       ,.tx_axis_tuser_o(tx_axis_tuser_lo)
 
       ,.send_count_o(/* UNUSED */)
+      ,.slot_head_o(tx_slot_head_lo)
+      ,.slot_tail_o(tx_slot_tail_lo)
+      ,.slot_count_o(tx_slot_count_lo)
   );
 
   ethernet_receiver #(
       .data_width_p(data_width_p)
-     ,.eth_mtu_p(eth_mtu_lp))
+     ,.eth_mtu_p(eth_mtu_p)
+     ,.slot_p(rx_slot_p))
    receiver (
       .clk_i(clk_i)
      ,.reset_i(reset_i)
 
-     ,.packet_ack_i(packet_ack_lo)
+     ,.packet_ack_i(packet_ack_li)
      ,.packet_avail_o(packet_avail_lo)
-     ,.packet_rvalid_i(packet_rvalid_lo)
-     ,.packet_raddr_i(packet_raddr_lo)
+     ,.packet_rvalid_i(packet_rvalid_li)
+     ,.packet_raddr_i(packet_raddr_li)
      ,.packet_rdata_o(packet_rdata_lo)
      ,.packet_rsize_o(packet_rsize_lo)
+     ,.packet_rstatus_o(packet_rstatus_lo)
 
      ,.rx_axis_tdata_i(rx_axis_tdata_li)
      ,.rx_axis_tkeep_i(rx_axis_tkeep_li)
@@ -199,12 +426,42 @@ module ethernet_controller #
      ,.rx_axis_tready_o(rx_axis_tready_lo)
      ,.rx_axis_tlast_i(rx_axis_tlast_li)
      ,.rx_axis_tuser_i(rx_axis_tuser_li)
+     ,.filter_accept_i(filter_accept_lo)
 
      ,.receive_count_o(/* UNUSED */)
+     ,.slot_head_o(rx_slot_head_lo)
+     ,.slot_tail_o(rx_slot_tail_lo)
+     ,.slot_count_o(rx_slot_count_lo)
   );
 
+  address_filter #(.data_width_p(data_width_p))
+   filter (
+      .clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.csr_w_i(filter_csr_w_lo)
+     ,.csr_addr_i(filter_csr_addr_lo)
+     ,.csr_data_i(write_data_i)
+     ,.csr_data_o(filter_csr_data_lo)
+
+     ,.rx_axis_tdata_i(rx_axis_tdata_li)
+     ,.rx_axis_tvalid_i(rx_axis_tvalid_li)
+     ,.rx_axis_tready_i(rx_axis_tready_lo)
+     ,.rx_axis_tlast_i(rx_axis_tlast_li)
+     ,.rx_axis_tuser_i(rx_axis_tuser_li)
+
+     ,.accept_o(filter_accept_lo)
+  );
+
+  // The MAC fifos store and forward whole frames, header included, and drop
+  //   any that do not fit. They hold two of the largest frames the packet
+  //   buffer takes, so one can fill while the other drains; this is the
+  //   verilog-ethernet default of 4096B for the default 2048B MTU.
+  localparam mac_fifo_depth_lp = `BSG_MAX(4096, 2*eth_mtu_p);
   eth_mac_1g_rgmii_fifo #(
       .AXIS_DATA_WIDTH(data_width_p)
+     ,.TX_FIFO_DEPTH(mac_fifo_depth_lp)
+     ,.RX_FIFO_DEPTH(mac_fifo_depth_lp)
      ,.TX_FIFO_PIPELINE_OUTPUT(1)
      ,.RX_FIFO_PIPELINE_OUTPUT(1))
       mac (
@@ -254,11 +511,20 @@ module ethernet_controller #
   );
   wire rx_interrupt_lo;
   wire tx_interrupt_lo;
-  interrupt_control_unit interrupt_control_unit (
+  // Frames waiting for software: in the RX packet buffer, or in the memory
+  //   ring when the DMA engine owns RX
+  assign rx_pending_count_lo = dma_rx_enable_lo ? dma_rx_pending_count_lo : 16'(rx_slot_count_lo);
+  wire [15:0] rx_pending_max_lo = dma_rx_enable_lo ? dma_rx_slots_lo : 16'(rx_slot_p);
+  // A TX frame is complete once its last beat is handed to the MAC
+  wire tx_complete_lo = tx_axis_tvalid_lo & tx_axis_tready_li & tx_axis_tlast_lo;
+
+  interrupt_control_unit #(.count_width_p(16))
+   interrupt_control_unit (
     .clk_i(clk_i)
    ,.reset_i(reset_i)
-   ,.packet_avail_i(packet_avail_lo)
-   ,.packet_req_i(packet_req_lo)
+   ,.rx_pending_count_i(rx_pending_count_lo)
+   ,.rx_pending_max_i(rx_pending_max_lo)
+   ,.tx_complete_i(tx_complete_lo)
 
    ,.tx_interrupt_clear_i(tx_interrupt_clear_lo)
 
@@ -267,6 +533,17 @@ module ethernet_controller #
    ,.tx_interrupt_enable_i(tx_interrupt_enable_lo)
    ,.tx_interrupt_enable_v_i(tx_interrupt_enable_v_lo)
 
+   ,.coalesce_data_i(coalesce_data_lo)
+   ,.rx_coalesce_frames_v_i(rx_coalesce_frames_v_lo)
+   ,.rx_coalesce_timeout_v_i(rx_coalesce_timeout_v_lo)
+   ,.tx_coalesce_frames_v_i(tx_coalesce_frames_v_lo)
+   ,.tx_coalesce_timeout_v_i(tx_coalesce_timeout_v_lo)
+   ,.rx_coalesce_frames_o(rx_coalesce_frames_lo)
+   ,.rx_coalesce_timeout_o(rx_coalesce_timeout_lo)
+   ,.tx_coalesce_frames_o(tx_coalesce_frames_lo)
+   ,.tx_coalesce_timeout_o(tx_coalesce_timeout_lo)
+   ,.tx_pending_count_o(tx_pending_count_lo)
+
    ,.rx_interrupt_pending_o(rx_interrupt_pending_lo)
    ,.tx_interrupt_pending_o(tx_interrupt_pending_lo)
    ,.rx_interrupt_o(rx_interrupt_lo)
@@ -0,0 +1,412 @@
+
+/*
+ * This module moves Ethernet packets between the packet buffers and memory,
+ * so that software only handles descriptors and doorbells over AXIL.
+ *
+ * RX: when enabled, each received packet is copied into the next free slot of
+ *   an RX ring in memory. Slot i starts at (RX buffer base + i * eth_mtu_p) and
+ *   its length is written to (RX size base + i * 4), with the checksum status
+ *   of ethernet_receiver in bits 19:16. The producer index is advanced only
+ *   after every write of the packet has been acknowledged, so a slot is
+ *   complete once software observes the new index. Software frees slots by
+ *   advancing the consumer index. The ring is full when
+ *   (producer - consumer) == slots, in which case packets stay in the RX
+ *   packet buffer (and the MAC eventually drops them).
+ *
+ * TX: software queues descriptors by writing the packet address and then its
+ *   length; the length write pushes the descriptor, along with the current
+ *   checksum control (same format as TX Checksum Control in
+ *   ethernet_control_unit) so that each packet is offloaded on its own. Each
+ *   descriptor is fetched into the TX packet buffer and sent; the fetched
+ *   counter increments once the packet has been handed to the sender.
+ *
+ * Both directions share one memory port and are serviced a packet at a time,
+ *   RX first. Within a packet, a word request is issued every cycle the port
+ *   is ready, without waiting for earlier responses; how many stay in flight
+ *   is set by the memory master (dma_outstanding_p in bsg_axil_ethernet).
+ *   Indices are free-running 16-bit counters.
+ *
+ * Registers (word offset from the DMA register base):
+ *   0: Control (RW): bit 0 RX DMA enable, bit 1 TX DMA enable
+ *   1: RX buffer base (RW)
+ *   2: RX size base (RW)
+ *   3: RX ring slots (RW), power of 2
+ *   4: RX producer index (R)
+ *   5: RX consumer index (RW)
+ *   6: TX descriptor address (RW)
+ *   7: TX descriptor length (W: queue descriptor; R: descriptor queue ready)
+ *   8: TX packets fetched (R)
+ *   9: TX descriptor checksum control (RW)
+ *
+ */
+
+`include "bsg_defines.sv"
+
+module ethernet_dma #
+(
+      parameter  data_width_p         = 32
+    , parameter  addr_width_p         = 32
+    , parameter  eth_mtu_p            = 2048 // byte
+      // descriptors software can queue ahead of the TX engine
+    , parameter  tx_desc_els_p        = 4
+    , localparam packet_size_width_lp = $clog2(eth_mtu_p+1)
+    , localparam packet_addr_width_lp = $clog2(eth_mtu_p)
+    , localparam csr_addr_width_lp    = 4
+    , localparam csum_status_width_lp = 4
+)
+(
+      input  logic                              clk_i
+    , input  logic                              reset_i
+
+    /* Registers */
+    , input  logic                              csr_w_i
+    , input  logic [csr_addr_width_lp-1:0]      csr_addr_i
+    , input  logic [data_width_p-1:0]           csr_data_i
+    , output logic [data_width_p-1:0]           csr_data_o
+
+    , output logic                              rx_enable_o
+    , output logic                              tx_enable_o
+      // filled RX slots not yet consumed by software, of rx_slots_o
+    , output logic [15:0]                       rx_pending_count_o
+    , output logic [15:0]                       rx_slots_o
+
+    /* RX packet buffer */
+    , output logic                              packet_ack_o
+    , input  logic                              packet_avail_i
+    , output logic                              packet_rvalid_o
+    , output logic [packet_addr_width_lp-1:0]   packet_raddr_o
+    , input  logic [data_width_p-1:0]           packet_rdata_i
+    , input  logic [packet_size_width_lp-1:0]   packet_rsize_i
+    , input  logic [csum_status_width_lp-1:0]   packet_rstatus_i
+
+    /* TX packet buffer */
+    , output logic                              packet_send_o
+    , input  logic                              packet_req_i
+    , output logic                              packet_wsize_valid_o
+    , output logic [packet_size_width_lp-1:0]   packet_wsize_o
+    , output logic                              packet_wvalid_o
+    , output logic [packet_addr_width_lp-1:0]   packet_waddr_o
+    , output logic [data_width_p-1:0]           packet_wdata_o
+    , output logic [(data_width_p/8)-1:0]       packet_wmask_o
+      // checksum control of the descriptor being fetched
+    , output logic                              tx_csum_en_o
+    , output logic [packet_addr_width_lp-1:0]   tx_csum_start_o
+    , output logic [packet_addr_width_lp-1:0]   tx_csum_offset_o
+
+    /* Memory */
+    , output logic [data_width_p-1:0]           mem_data_o
+    , output logic [addr_width_p-1:0]           mem_addr_o
+    , output logic                              mem_v_o
+    , output logic                              mem_w_o
+    , output logic [(data_width_p/8)-1:0]       mem_wmask_o
+    , input  logic                              mem_ready_and_i
+
+    , input  logic [data_width_p-1:0]           mem_data_i
+    , input  logic                              mem_v_i
+    , output logic                              mem_ready_and_o
+);
+
+  localparam word_offset_width_lp = $clog2(data_width_p/8);
+  localparam word_count_width_lp  = $clog2(eth_mtu_p/(data_width_p/8)+1);
+  localparam index_width_lp       = 16;
+
+  enum logic [2:0]
+  {e_idle
+   ,e_rx_write
+   ,e_rx_size
+   ,e_rx_drain
+   ,e_tx_read
+   ,e_tx_drain
+   } state_n, state_r;
+
+  logic [1:0]                       control_r;
+  logic [addr_width_p-1:0]          rx_buffer_base_r, rx_size_base_r, tx_desc_addr_r;
+  logic [index_width_lp-1:0]        rx_slots_r, rx_prod_r, rx_cons_r, tx_fetched_r;
+  logic [word_count_width_lp-1:0]   req_cnt_r, resp_cnt_r;
+
+  logic rx_done, tx_done;
+  logic [index_width_lp-1:0] rx_slot_li;
+
+  wire csr_w_control  = csr_w_i & (csr_addr_i == 4'd0);
+  wire csr_w_rx_base  = csr_w_i & (csr_addr_i == 4'd1);
+  wire csr_w_rx_size  = csr_w_i & (csr_addr_i == 4'd2);
+  wire csr_w_rx_slots = csr_w_i & (csr_addr_i == 4'd3);
+  wire csr_w_rx_cons  = csr_w_i & (csr_addr_i == 4'd5);
+  wire csr_w_tx_addr  = csr_w_i & (csr_addr_i == 4'd6);
+  wire csr_w_tx_len   = csr_w_i & (csr_addr_i == 4'd7);
+  wire csr_w_tx_csum  = csr_w_i & (csr_addr_i == 4'd9);
+
+  bsg_dff_reset_en #(.width_p(2))
+    control_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(csr_w_control)
+       ,.data_i(csr_data_i[1:0])
+       ,.data_o(control_r)
+    );
+
+  bsg_dff_reset_en #(.width_p(addr_width_p))
+    rx_buffer_base_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(csr_w_rx_base)
+       ,.data_i(addr_width_p'(csr_data_i))
+       ,.data_o(rx_buffer_base_r)
+    );
+
+  bsg_dff_reset_en #(.width_p(addr_width_p))
+    rx_size_base_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(csr_w_rx_size)
+       ,.data_i(addr_width_p'(csr_data_i))
+       ,.data_o(rx_size_base_r)
+    );
+
+  bsg_dff_reset_en #(.width_p(index_width_lp))
+    rx_slots_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(csr_w_rx_slots)
+       ,.data_i(csr_data_i[index_width_lp-1:0])
+       ,.data_o(rx_slots_r)
+    );
+
+  bsg_dff_reset_en #(.width_p(index_width_lp))
+    rx_cons_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(csr_w_rx_cons)
+       ,.data_i(csr_data_i[index_width_lp-1:0])
+       ,.data_o(rx_cons_r)
+    );
+
+  bsg_dff_reset_en #(.width_p(addr_width_p))
+    tx_desc_addr_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(csr_w_tx_addr)
+       ,.data_i(addr_width_p'(csr_data_i))
+       ,.data_o(tx_desc_addr_r)
+    );
+
+  logic                            tx_csum_en_r;
+  logic [packet_addr_width_lp-1:0] tx_csum_start_r, tx_csum_offset_r;
+  bsg_dff_reset_en #(.width_p(1+2*packet_addr_width_lp))
+    tx_csum_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(csr_w_tx_csum)
+       ,.data_i({csr_data_i[31]
+                ,csr_data_i[16+:packet_addr_width_lp]
+                ,csr_data_i[0+:packet_addr_width_lp]})
+       ,.data_o({tx_csum_en_r, tx_csum_offset_r, tx_csum_start_r})
+    );
+
+  // Free-running; wraps like the software index
+  bsg_counter_clear_up #(.max_val_p(2**index_width_lp-1)
+     ,.init_val_p(0)
+     ,.disable_overflow_warning_p(1))
+    rx_prod_counter (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.clear_i(1'b0)
+       ,.up_i(rx_done)
+       ,.count_o(rx_prod_r)
+    );
+
+  bsg_counter_clear_up #(.max_val_p(2**index_width_lp-1)
+     ,.init_val_p(0)
+     ,.disable_overflow_warning_p(1))
+    tx_fetched_counter (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.clear_i(1'b0)
+       ,.up_i(tx_done)
+       ,.count_o(tx_fetched_r)
+    );
+
+  logic                            desc_ready_lo, desc_v_lo;
+  logic [addr_width_p-1:0]         desc_addr_lo;
+  logic [packet_size_width_lp-1:0] desc_size_lo;
+  bsg_fifo_1r1w_small
+   #(.width_p(addr_width_p+packet_size_width_lp+1+2*packet_addr_width_lp)
+     ,.els_p(tx_desc_els_p))
+   tx_desc_fifo
+    (.clk_i(clk_i)
+     ,.reset_i(reset_i)
+
+     ,.data_i({tx_desc_addr_r, csr_data_i[packet_size_width_lp-1:0]
+              ,tx_csum_en_r, tx_csum_offset_r, tx_csum_start_r})
+     ,.v_i(csr_w_tx_len & desc_ready_lo)
+     ,.ready_param_o(desc_ready_lo)
+
+     ,.data_o({desc_addr_lo, desc_size_lo
+              ,tx_csum_en_o, tx_csum_offset_o, tx_csum_start_o})
+     ,.v_o(desc_v_lo)
+     ,.yumi_i(tx_done)
+     );
+
+  assign rx_enable_o = control_r[0];
+  assign tx_enable_o = control_r[1];
+
+  wire [index_width_lp-1:0] rx_used = rx_prod_r - rx_cons_r;
+  wire rx_full = (rx_used == rx_slots_r);
+  assign rx_pending_count_o = rx_used;
+  assign rx_slots_o = rx_slots_r;
+  assign rx_slot_li = rx_prod_r & (rx_slots_r - 1'b1);
+
+  wire [word_count_width_lp-1:0] rx_words =
+    (packet_rsize_i + (data_width_p/8) - 1) >> word_offset_width_lp;
+  wire [word_count_width_lp-1:0] tx_words =
+    (desc_size_lo + (data_width_p/8) - 1) >> word_offset_width_lp;
+
+  wire [addr_width_p-1:0] rx_slot_addr = rx_buffer_base_r
+    + (addr_width_p'(rx_slot_li) << packet_addr_width_lp);
+  wire [addr_width_p-1:0] rx_size_addr = rx_size_base_r
+    + (addr_width_p'(rx_slot_li) << word_offset_width_lp);
+
+  wire mem_req = mem_v_o & mem_ready_and_i;
+  wire mem_resp = mem_v_i & mem_ready_and_o;
+  assign mem_ready_and_o = 1'b1;
+
+  always_comb begin
+    state_n = state_r;
+
+    packet_ack_o = 1'b0;
+    packet_rvalid_o = 1'b0;
+    packet_raddr_o = '0;
+
+    packet_send_o = 1'b0;
+    packet_wsize_valid_o = 1'b0;
+    packet_wsize_o = desc_size_lo;
+    // Fetched words are written in the order they return
+    packet_wvalid_o = mem_resp & ((state_r == e_tx_read) | (state_r == e_tx_drain));
+    packet_waddr_o = packet_addr_width_lp'(resp_cnt_r << word_offset_width_lp);
+    packet_wdata_o = mem_data_i;
+    // Bytes past the packet size are masked off so they are not summed
+    packet_wmask_o = '1;
+    if((resp_cnt_r + 1'b1 == tx_words) & (desc_size_lo[0+:word_offset_width_lp] != '0))
+      packet_wmask_o = (data_width_p/8)'((1 << desc_size_lo[0+:word_offset_width_lp]) - 1);
+
+    mem_v_o = 1'b0;
+    mem_w_o = 1'b0;
+    mem_addr_o = '0;
+    mem_data_o = packet_rdata_i;
+    mem_wmask_o = '1;
+
+    rx_done = 1'b0;
+    tx_done = 1'b0;
+
+    case (state_r)
+      e_idle: begin
+        if (rx_enable_o & packet_avail_i & ~rx_full) begin
+          // Prefetch the first word; the buffer holds read data until the next read
+          packet_rvalid_o = 1'b1;
+          state_n = (rx_words == '0) ? e_rx_size : e_rx_write;
+        end
+        else if (tx_enable_o & desc_v_lo & packet_req_i) begin
+          state_n = (tx_words == '0) ? e_tx_drain : e_tx_read;
+        end
+      end
+      e_rx_write: begin
+        mem_v_o = 1'b1;
+        mem_w_o = 1'b1;
+        mem_addr_o = rx_slot_addr + (addr_width_p'(req_cnt_r) << word_offset_width_lp);
+        if (mem_req) begin
+          packet_rvalid_o = (req_cnt_r + 1'b1 != rx_words);
+          packet_raddr_o = packet_addr_width_lp'((req_cnt_r + 1'b1) << word_offset_width_lp);
+          if (req_cnt_r + 1'b1 == rx_words)
+            state_n = e_rx_size;
+        end
+      end
+      e_rx_size: begin
+        mem_v_o = 1'b1;
+        mem_w_o = 1'b1;
+        mem_addr_o = rx_size_addr;
+        mem_data_o = data_width_p'({packet_rstatus_i, 16'(packet_rsize_i)});
+        if (mem_req)
+          state_n = e_rx_drain;
+      end
+      e_rx_drain: begin
+        // Publish the slot once every write, including the size, is acknowledged
+        if (resp_cnt_r == rx_words + 1'b1) begin
+          packet_ack_o = 1'b1;
+          rx_done = 1'b1;
+          state_n = e_idle;
+        end
+      end
+      e_tx_read: begin
+        mem_v_o = 1'b1;
+        mem_addr_o = desc_addr_lo + (addr_width_p'(req_cnt_r) << word_offset_width_lp);
+        if (mem_req & (req_cnt_r + 1'b1 == tx_words))
+          state_n = e_tx_drain;
+      end
+      e_tx_drain: begin
+        if (resp_cnt_r == tx_words) begin
+          packet_wsize_valid_o = 1'b1;
+          packet_send_o = 1'b1;
+          tx_done = 1'b1;
+          state_n = e_idle;
+        end
+      end
+      default: begin
+      end
+    endcase
+  end
+
+  // synopsys sync_set_reset "reset_i"
+  always_ff @(posedge clk_i)
+    if (reset_i)
+      state_r <= e_idle;
+    else
+      state_r <= state_n;
+
+  always_ff @(posedge clk_i)
+    if (reset_i | (state_r == e_idle))
+      begin
+        req_cnt_r  <= '0;
+        resp_cnt_r <= '0;
+      end
+    else
+      begin
+        if (mem_req)
+          req_cnt_r <= req_cnt_r + 1'b1;
+        if (mem_resp)
+          resp_cnt_r <= resp_cnt_r + 1'b1;
+      end
+
+  always_comb begin
+    case (csr_addr_i)
+      4'd0: csr_data_o = data_width_p'(control_r);
+      4'd1: csr_data_o = data_width_p'(rx_buffer_base_r);
+      4'd2: csr_data_o = data_width_p'(rx_size_base_r);
+      4'd3: csr_data_o = data_width_p'(rx_slots_r);
+      4'd4: csr_data_o = data_width_p'(rx_prod_r);
+      4'd5: csr_data_o = data_width_p'(rx_cons_r);
+      4'd6: csr_data_o = data_width_p'(tx_desc_addr_r);
+      4'd7: csr_data_o = data_width_p'(desc_ready_lo);
+      4'd8: csr_data_o = data_width_p'(tx_fetched_r);
+      4'd9: csr_data_o = data_width_p'({tx_csum_en_r
+                                       ,(15-packet_addr_width_lp)'(0), tx_csum_offset_r
+                                       ,(16-packet_addr_width_lp)'(0), tx_csum_start_r});
+      default: csr_data_o = '0;
+    endcase
+  end
+
+  // synopsys translate_off
+  always_ff @(posedge clk_i) begin
+    if(~reset_i) begin
+      assert(~(csr_w_tx_len & ~desc_ready_lo))
+        else $error("%m: TX descriptor dropped, queue full at time %t", $time);
+      assert(~(rx_enable_o & ((rx_slots_r & (rx_slots_r - 1'b1)) != '0)))
+        else $error("%m: RX ring slots must be a power of 2");
+    end
+  end
+  initial begin
+    assert(data_width_p == 32)
+      else $error("%m: unsupported data_width_p");
+  end
+  // synopsys translate_on
+
+endmodule
@@ -3,6 +3,18 @@
  * This module receives packets from axis bus and stores them in its buffer.
  * Received packets can be read through packet_* signals.
  *
+ * IPv4 header and TCP/UDP checksums are verified while a packet streams in,
+ * and the result is kept with the packet (packet_rstatus_o):
+ *   bit 0: IPv4 header checksum checked
+ *   bit 1: IPv4 header checksum good
+ *   bit 2: TCP/UDP checksum checked (not for fragments or UDP without checksum)
+ *   bit 3: TCP/UDP checksum good
+ * Only untagged Ethernet II frames are recognized.
+ *
+ * Good frames are only stored when filter_accept_i is set with their last
+ * word (see address_filter.sv); others are dropped like bad frames. So are
+ * frames longer than eth_mtu_p.
+ *
  */
 
 `include "bsg_defines.sv"
@@ -13,9 +25,14 @@ module ethernet_receiver
       // maximum size of an Ethernet packet
     , parameter  eth_mtu_p  = 2048 // byte
     , parameter  recv_count_p  = (32'b1 << 16 - 1)
+      // number of packets buffered before the MAC is backpressured
+    , parameter  slot_p        = 2
     , localparam addr_width_lp = $clog2(eth_mtu_p)
     , localparam size_width_lp = `BSG_WIDTH(`BSG_SAFE_CLOG2(data_width_p/8))
     , localparam packet_size_width_lp = $clog2(eth_mtu_p+1)
+    , localparam slot_ptr_width_lp = `BSG_SAFE_CLOG2(slot_p)
+    , localparam slot_count_width_lp = `BSG_WIDTH(slot_p)
+    , localparam csum_status_width_lp = 4
 )
 (
       input logic                             clk_i
@@ -31,6 +48,8 @@ module ethernet_receiver
       // sync read
     , output logic [data_width_p-1:0]         packet_rdata_o
     , output logic [packet_size_width_lp-1:0] packet_rsize_o
+      // checksum status; valid as long as packet_avail_o == 1'b1
+    , output logic [csum_status_width_lp-1:0] packet_rstatus_o
 
     /* Packet <- AXIS */
     , input logic [data_width_p-1:0]          rx_axis_tdata_i
@@ -39,9 +58,13 @@ module ethernet_receiver
     , output logic                            rx_axis_tready_o
     , input logic                             rx_axis_tlast_i
     , input logic                             rx_axis_tuser_i
+    , input logic                             filter_accept_i
 
     /* stat */
     , output logic [$clog2(recv_count_p+1)-1:0] receive_count_o
+    , output logic [slot_ptr_width_lp-1:0]      slot_head_o
+    , output logic [slot_ptr_width_lp-1:0]      slot_tail_o
+    , output logic [slot_count_width_lp-1:0]    slot_count_o
 );
   localparam recv_ptr_width_lp = $clog2(eth_mtu_p/(data_width_p/8));
 
@@ -65,8 +88,19 @@ module ethernet_receiver
   logic recv_ptr_unwind;
   logic recv_ptr_increment;
   logic [recv_ptr_width_lp-1:0] recv_ptr_r;
+  // the frame being received does not fit in eth_mtu_p
+  logic recv_overrun, recv_overrun_r;
   logic [packet_size_width_lp-1:0] packet_size_remaining;
 
+  localparam bytes_lp = data_width_p/8;
+  logic [15:0] ethertype_r, ip_len_r, ip_frag_r;
+  logic [7:0]  ip_ver_ihl_r, ip_proto_r;
+  logic        l4_csum_nonzero_r, l4_csum_nonzero_n;
+  logic [bytes_lp-1:0] ip_mask_li, l4_mask_li;
+  logic [15:0] ip_sum_lo, l4_sum_lo;
+  logic [slot_p-1:0][csum_status_width_lp-1:0] csum_status_r;
+  logic [csum_status_width_lp-1:0] csum_status_n;
+
   logic receive_complete;
   bsg_flow_counter #(.els_p(recv_count_p))
    receive_count (
@@ -132,7 +166,7 @@ end
 
   assign packet_avail_o = packet_avail_lo;
 
-  packet_buffer #(.slot_p(2)
+  packet_buffer #(.slot_p(slot_p)
      ,.data_width_p(data_width_p)
      ,.els_p(eth_mtu_p))
     rx_buffer (
@@ -154,16 +188,22 @@ end
      ,.packet_waddr_i(packet_waddr_li)
      ,.packet_wdata_i(packet_wdata_li)
      ,.packet_wmask_i((data_width_p/8)'('1))
+
+     ,.slot_head_o(slot_head_o)
+     ,.slot_tail_o(slot_tail_o)
+     ,.slot_count_o(slot_count_o)
     );
 
   always_comb begin
     packet_rsize_o = '0;
+    packet_rstatus_o = '0;
     packet_ack_li = 1'b0;
     packet_rvalid_li = 1'b0;
     packet_raddr_li = packet_raddr_i;
     packet_rdata_o = packet_rdata_lo;
     if(packet_avail_lo) begin
       packet_rsize_o = packet_rsize_lo;
+      packet_rstatus_o = csum_status_r[slot_head_o];
       packet_ack_li = packet_ack_i;
       packet_rvalid_li = packet_rvalid_i;
     end
@@ -180,6 +220,7 @@ end
     packet_waddr_li = '0;
     packet_wdata_li = '0;
     receive_complete = 1'b0;
+    recv_overrun = 1'b0;
     if(packet_req_lo) begin
       rx_axis_tready_o = 1'b1;
       if(rx_axis_tvalid_i) begin
@@ -188,7 +229,7 @@ end
         packet_wdata_li = rx_axis_tdata_i;
         if(rx_axis_tlast_i) begin
           recv_ptr_unwind = 1'b1;
-          if(~rx_axis_tuser_i) begin
+          if(~rx_axis_tuser_i & filter_accept_i & ~recv_overrun_r) begin
             // end of good frame
             packet_send_li = 1'b1;
             packet_wsize_li = (recv_ptr_r*(data_width_p/8)) + packet_size_remaining;
@@ -196,6 +237,10 @@ end
             receive_complete = 1'b1;
           end
         end
+        else if(recv_ptr_r == '1) begin
+          // keep overwriting the last word until the frame ends
+          recv_overrun = 1'b1;
+        end
         else begin
           recv_ptr_increment = 1'b1;
         end
@@ -203,6 +248,111 @@ end
     end
   end
 
+  bsg_dff_reset_en #(.width_p(1))
+    recv_overrun_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(recv_overrun | recv_ptr_unwind)
+       ,.data_i(~recv_ptr_unwind)
+       ,.data_o(recv_overrun_r)
+    );
+
+  /* Checksum verification */
+  wire [16:0] ip_hdr_len  = ip_ver_ihl_r[3:0] * 3'd4;
+  wire [16:0] ip_hdr_end  = 17'd14 + ip_hdr_len;
+  wire [16:0] ip_end      = 17'd14 + ip_len_r;
+  wire [16:0] l4_len      = ip_len_r - ip_hdr_len;
+  wire        ip_is_udp   = (ip_proto_r == 8'd17);
+
+  // Fields are captured by byte offset. Each of them arrives at least one
+  //   word before the end of any frame long enough to be accepted as IPv4,
+  //   and before offset 34, where the ranges start to depend on them. Below
+  //   that they still hold the previous frame and are not used.
+  always_comb begin
+    ip_mask_li = '0;
+    l4_mask_li = '0;
+    l4_csum_nonzero_n = l4_csum_nonzero_r;
+    for(integer i = 0; i < bytes_lp; i++) begin
+      automatic logic [16:0] addr = 17'(recv_ptr_r*bytes_lp + i);
+      if(rx_axis_tkeep_i[i]) begin
+        // IPv4 header; at least 20 bytes
+        ip_mask_li[i] = (addr >= 17'd14) & ((addr < 17'd34) | (addr < ip_hdr_end));
+        // Pseudo header (protocol, source and destination) and payload
+        l4_mask_li[i] = (addr == 17'd23) | ((addr >= 17'd26) & (addr < 17'd34))
+          | ((addr >= 17'd34) & (addr >= ip_hdr_end) & (addr < ip_end));
+        if((addr >= 17'd34) & ((addr == ip_hdr_end + 17'd6) | (addr == ip_hdr_end + 17'd7))
+            & (rx_axis_tdata_i[i*8+:8] != 8'h00))
+          l4_csum_nonzero_n = 1'b1;
+      end
+    end
+  end
+
+  always_ff @(posedge clk_i) begin
+    if(packet_wvalid_li)
+      for(integer i = 0; i < bytes_lp; i++)
+        case(recv_ptr_r*bytes_lp + i)
+          12: ethertype_r[15:8] <= rx_axis_tdata_i[i*8+:8];
+          13: ethertype_r[7:0]  <= rx_axis_tdata_i[i*8+:8];
+          14: ip_ver_ihl_r      <= rx_axis_tdata_i[i*8+:8];
+          16: ip_len_r[15:8]    <= rx_axis_tdata_i[i*8+:8];
+          17: ip_len_r[7:0]     <= rx_axis_tdata_i[i*8+:8];
+          20: ip_frag_r[15:8]   <= rx_axis_tdata_i[i*8+:8];
+          21: ip_frag_r[7:0]    <= rx_axis_tdata_i[i*8+:8];
+          23: ip_proto_r        <= rx_axis_tdata_i[i*8+:8];
+          default: begin end
+        endcase
+  end
+
+  bsg_dff_reset_en #(.width_p(1))
+    l4_csum_nonzero_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(packet_wvalid_li | recv_ptr_unwind)
+       ,.data_i(l4_csum_nonzero_n & ~recv_ptr_unwind)
+       ,.data_o(l4_csum_nonzero_r)
+    );
+
+  checksum_accumulator #(.data_width_p(data_width_p))
+    ip_checksum (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.clear_i(recv_ptr_unwind)
+       ,.v_i(packet_wvalid_li)
+       ,.data_i(rx_axis_tdata_i)
+       ,.mask_i(ip_mask_li)
+       ,.sum_o(ip_sum_lo)
+    );
+
+  checksum_accumulator #(.data_width_p(data_width_p))
+    l4_checksum (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.clear_i(recv_ptr_unwind)
+       ,.v_i(packet_wvalid_li)
+       ,.data_i(rx_axis_tdata_i)
+       ,.mask_i(l4_mask_li)
+       ,.sum_o(l4_sum_lo)
+    );
+
+  // The pseudo header length is added last
+  wire [16:0] l4_sum_len = l4_sum_lo + l4_len[15:0];
+  wire [15:0] l4_sum_final = l4_sum_len[15:0] + l4_sum_len[16];
+
+  wire ip_v = (ethertype_r == 16'h0800) & (ip_ver_ihl_r[7:4] == 4'd4)
+    & (ip_ver_ihl_r[3:0] >= 4'd5) & (ip_len_r >= ip_hdr_len)
+    & (17'(packet_wsize_li) >= ip_end);
+  // More fragments flag or a non-zero fragment offset
+  wire ip_frag = (ip_frag_r[13:0] != '0);
+  wire l4_v = ip_v & ~ip_frag
+    & ((ip_proto_r == 8'd6) | (ip_is_udp & l4_csum_nonzero_n));
+
+  assign csum_status_n = {l4_v & (l4_sum_final == 16'hFFFF), l4_v
+                         ,ip_v & (ip_sum_lo == 16'hFFFF), ip_v};
+
+  always_ff @(posedge clk_i)
+    if(packet_send_li)
+      csum_status_r[slot_tail_o] <= csum_status_n;
+
   // synopsys translate_off
   always_ff @(posedge clk_i) begin
     if(~reset_i) begin
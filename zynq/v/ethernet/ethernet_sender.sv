@@ -3,6 +3,14 @@
  * This module receives packets from packet_* signals and stores them
  * in its buffer. Received packets are then sent to axis bus.
  *
+ * Checksum insertion: while csum_en_i is set, the ones' complement sum of
+ * every byte written at or after csum_start_i is accumulated as the packet is
+ * written, and the complemented result replaces the 16 bits at csum_offset_i
+ * when the packet is sent. This matches CHECKSUM_PARTIAL in Linux: software
+ * seeds the checksum field with the pseudo header sum. csum_* must be held
+ * while a packet is written, each byte must be written once, and bytes past
+ * the packet size must be masked off.
+ *
  */
 
 `include "bsg_defines.sv"
@@ -13,8 +21,12 @@ module ethernet_sender #
       // maximum size of an Ethernet packet
     , parameter  eth_mtu_p     = 2048 // byte
     , parameter  send_count_p  = (32'b1 << 16 - 1)
+      // number of packets software can queue ahead of the MAC
+    , parameter  slot_p        = 2
     , localparam addr_width_lp = $clog2(eth_mtu_p)
     , localparam packet_size_width_lp = $clog2(eth_mtu_p+1)
+    , localparam slot_ptr_width_lp = `BSG_SAFE_CLOG2(slot_p)
+    , localparam slot_count_width_lp = `BSG_WIDTH(slot_p)
 )
 (
       input  logic                                 clk_i
@@ -33,6 +45,11 @@ module ethernet_sender #
     , input  logic [data_width_p-1:0]              packet_wdata_i
     , input  logic [(data_width_p/8)-1:0]          packet_wmask_i
 
+    /* Checksum insertion for the packet being written */
+    , input  logic                                 csum_en_i
+    , input  logic [addr_width_lp-1:0]             csum_start_i
+    , input  logic [addr_width_lp-1:0]             csum_offset_i
+
     /* Packet -> AXIS */
     , output logic [data_width_p-1:0]              tx_axis_tdata_o
     , output logic [data_width_p/8-1:0]            tx_axis_tkeep_o
@@ -42,6 +59,9 @@ module ethernet_sender #
     , output logic                                 tx_axis_tuser_o
 
     , output logic [$clog2(send_count_p+1)-1:0]    send_count_o
+    , output logic [slot_ptr_width_lp-1:0]         slot_head_o
+    , output logic [slot_ptr_width_lp-1:0]         slot_tail_o
+    , output logic [slot_count_width_lp-1:0]       slot_count_o
 );
   localparam send_ptr_width_lp        = $clog2(eth_mtu_p/(data_width_p/8));
   localparam send_ptr_offset_width_lp = $clog2(data_width_p/8);
@@ -83,7 +103,7 @@ module ethernet_sender #
      ,.count_o(send_count_o)
   );
 
-  packet_buffer #(.slot_p(2)
+  packet_buffer #(.slot_p(slot_p)
      ,.data_width_p(data_width_p)
      ,.els_p(eth_mtu_p))
     tx_buffer (
@@ -105,18 +125,78 @@ module ethernet_sender #
      ,.packet_waddr_i(packet_waddr_i)
      ,.packet_wdata_i(packet_wdata_i)
      ,.packet_wmask_i(packet_wmask_i)
+
+     ,.slot_head_o(slot_head_o)
+     ,.slot_tail_o(slot_tail_o)
+     ,.slot_count_o(slot_count_o)
+    );
+
+
+  /* Checksum insertion */
+  localparam bytes_lp = data_width_p/8;
+
+  logic [bytes_lp-1:0] csum_mask_li, csum_hi_li, csum_lo_li, csum_hi_r, csum_lo_r;
+  logic [15:0] csum_sum_lo, csum_r;
+  logic [slot_p-1:0] csum_en_r;
+  logic [slot_p-1:0][addr_width_lp-1:0] csum_offset_r;
+  logic [slot_p-1:0][15:0] csum_value_r;
+
+  always_comb begin
+    csum_mask_li = '0;
+    for(integer i = 0; i < bytes_lp; i++)
+      csum_mask_li[i] = packet_wmask_i[i]
+        & ({packet_waddr_i[addr_width_lp-1:send_ptr_offset_width_lp], send_ptr_offset_width_lp'(i)} >= csum_start_i);
+  end
+
+  checksum_accumulator #(.data_width_p(data_width_p))
+    checksum (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.clear_i(packet_send_li)
+       ,.v_i(packet_wvalid_li & csum_en_i)
+       ,.data_i(packet_wdata_i)
+       ,.mask_i(csum_mask_li)
+       ,.sum_o(csum_sum_lo)
     );
 
+  // A result of 0 is sent as 0xFFFF, which UDP requires and TCP accepts
+  wire [15:0] csum_value_n = (csum_sum_lo == 16'hFFFF) ? 16'hFFFF : ~csum_sum_lo;
+
+  always_ff @(posedge clk_i)
+    if(reset_i)
+      csum_en_r <= '0;
+    else if(packet_send_li)
+      csum_en_r[slot_tail_o] <= csum_en_i;
+
+  always_ff @(posedge clk_i)
+    if(packet_send_li) begin
+      csum_offset_r[slot_tail_o] <= csum_offset_i;
+      csum_value_r[slot_tail_o]  <= csum_value_n;
+    end
+
+  // Lanes of the word being read that hold the checksum field; the field may
+  //   straddle two words
+  always_comb begin
+    csum_hi_li = '0;
+    csum_lo_li = '0;
+    for(integer i = 0; i < bytes_lp; i++) begin
+      automatic logic [addr_width_lp-1:0] addr = packet_raddr_li + addr_width_lp'(i);
+      csum_hi_li[i] = csum_en_r[slot_head_o] & (addr == csum_offset_r[slot_head_o]);
+      csum_lo_li[i] = csum_en_r[slot_head_o] & (addr == csum_offset_r[slot_head_o] + 1'b1);
+    end
+  end
 
   // used for aligning the control signals with the sycn read value
   bsg_dff_reset_en #(
-      .width_p(data_width_p/8+2)
+      .width_p(data_width_p/8+2+2*bytes_lp+16)
     ) tx_dff (
       .clk_i(clk_i)
      ,.reset_i(reset_i)
      ,.en_i(packet_rvalid_li)
-     ,.data_i({tx_axis_tkeep_li, tx_axis_tlast_li, tx_axis_tuser_li})
-     ,.data_o({tx_axis_tkeep_o, tx_axis_tlast_o, tx_axis_tuser_o})
+     ,.data_i({tx_axis_tkeep_li, tx_axis_tlast_li, tx_axis_tuser_li
+              ,csum_hi_li, csum_lo_li, csum_value_r[slot_head_o]})
+     ,.data_o({tx_axis_tkeep_o, tx_axis_tlast_o, tx_axis_tuser_o
+              ,csum_hi_r, csum_lo_r, csum_r})
     );
   logic packet_rvalid_lo, packet_rready_li;
   bsg_dff_reset_set_clear #(.width_p(1)
@@ -142,7 +222,15 @@ module ethernet_sender #
      ,.count_o(send_ptr_r)
     );
 
-  assign tx_axis_tdata_o = packet_rdata_lo;
+  always_comb begin
+    tx_axis_tdata_o = packet_rdata_lo;
+    for(integer i = 0; i < bytes_lp; i++) begin
+      if(csum_hi_r[i])
+        tx_axis_tdata_o[i*8+:8] = csum_r[15:8];
+      if(csum_lo_r[i])
+        tx_axis_tdata_o[i*8+:8] = csum_r[7:0];
+    end
+  end
   assign packet_raddr_li = (addr_width_lp)'(send_ptr_r*(data_width_p/8));
 
   assign send_ptr_end = (send_ptr_width_lp)'((packet_rsize_lo - 1) >> $clog2(data_width_p/8));
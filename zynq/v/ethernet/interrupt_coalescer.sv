@@ -0,0 +1,75 @@
+
+/*
+ * Coalesces events into one interrupt: fire_o is raised once frames_r events
+ * are pending, or once events have been pending for timeout_r cycles,
+ * whichever comes first. frames_r of 0 or 1 fires on every event; timeout_r
+ * of 0 disables the timeout. The timer restarts whenever nothing is pending.
+ *
+ * At most max_frames_i events can be pending. A larger count would never be
+ * reached, so it is clamped when written, and again when compared, as the
+ * limit may shrink after the write.
+ *
+ */
+
+`include "bsg_defines.sv"
+
+module interrupt_coalescer #(
+      parameter  count_width_p = 16
+)
+(
+      input  logic                     clk_i
+    , input  logic                     reset_i
+
+    , input  logic [count_width_p-1:0] frames_i
+    , input  logic                     frames_v_i
+    , input  logic [count_width_p-1:0] timeout_i
+    , input  logic                     timeout_v_i
+    , output logic [count_width_p-1:0] frames_o
+    , output logic [count_width_p-1:0] timeout_o
+
+    , input  logic [count_width_p-1:0] pending_count_i
+    , input  logic [count_width_p-1:0] max_frames_i
+    , output logic                     fire_o
+);
+
+  logic [count_width_p-1:0] frames_r, timeout_r, timer_r;
+
+  bsg_dff_reset_en #(.width_p(count_width_p))
+    frames_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(frames_v_i)
+       ,.data_i((frames_i > max_frames_i) ? max_frames_i : frames_i)
+       ,.data_o(frames_r)
+    );
+
+  bsg_dff_reset_en #(.width_p(count_width_p))
+    timeout_reg (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.en_i(timeout_v_i)
+       ,.data_i(timeout_i)
+       ,.data_o(timeout_r)
+    );
+
+  wire pending = (pending_count_i != '0);
+
+  // Cycles since the oldest pending event; saturates
+  bsg_counter_clear_up #(.max_val_p(2**count_width_p-1)
+     ,.init_val_p(0))
+    timer (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.clear_i(~pending)
+       ,.up_i(pending & (timer_r != '1))
+       ,.count_o(timer_r)
+    );
+
+  wire frames_reached  = (pending_count_i >= frames_r) | (pending_count_i >= max_frames_i);
+  wire timeout_reached = (timeout_r != '0) & (timer_r >= timeout_r);
+
+  assign fire_o    = pending & (frames_reached | timeout_reached);
+  assign frames_o  = frames_r;
+  assign timeout_o = timeout_r;
+
+endmodule
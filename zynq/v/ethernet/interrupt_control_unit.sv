@@ -1,10 +1,16 @@
 
-module interrupt_control_unit (
+module interrupt_control_unit #(
+      parameter  count_width_p = 16
+)
+(
 
     input  bit      clk_i
   , input  logic    reset_i
-  , input  logic    packet_avail_i
-  , input  logic    packet_req_i
+    // frames waiting for software, and how many can be
+  , input  logic [count_width_p-1:0] rx_pending_count_i
+  , input  logic [count_width_p-1:0] rx_pending_max_i
+    // a TX frame has left its slot for the MAC
+  , input  logic    tx_complete_i
 
   , input  logic    tx_interrupt_clear_i
 
@@ -13,6 +19,18 @@ module interrupt_control_unit (
   , input  logic    tx_interrupt_enable_i
   , input  logic    tx_interrupt_enable_v_i
 
+    // coalescing thresholds, see interrupt_coalescer
+  , input  logic [count_width_p-1:0] coalesce_data_i
+  , input  logic    rx_coalesce_frames_v_i
+  , input  logic    rx_coalesce_timeout_v_i
+  , input  logic    tx_coalesce_frames_v_i
+  , input  logic    tx_coalesce_timeout_v_i
+  , output logic [count_width_p-1:0] rx_coalesce_frames_o
+  , output logic [count_width_p-1:0] rx_coalesce_timeout_o
+  , output logic [count_width_p-1:0] tx_coalesce_frames_o
+  , output logic [count_width_p-1:0] tx_coalesce_timeout_o
+  , output logic [count_width_p-1:0] tx_pending_count_o
+
   , output logic    rx_interrupt_pending_o
   , output logic    tx_interrupt_pending_o
   , output logic    rx_interrupt_o
@@ -21,7 +39,6 @@ module interrupt_control_unit (
 
   logic rx_interrupt_enable_r;
   logic tx_interrupt_enable_r;
-  wire tx_interrupt_set_li;
 
   bsg_dff_reset_en #(.width_p(1))
     rx_interrupt_enable_reg (
@@ -41,27 +58,48 @@ module interrupt_control_unit (
        ,.data_o(tx_interrupt_enable_r)
     );
 
-  // Set tx interupt when packet_req_i goes from 0 -> 1
-  // Since the init value of packet_req_i is 1, and
-  // bsg_edge_detect can only set init value to 0,
-  // ~packet_req_i and falling edge are used.
-  bsg_edge_detect #(.falling_not_rising_p(1))
-    edge_detect (
+  // TX frames completed since the last clear; saturates
+  logic [count_width_p-1:0] tx_pending_count_r;
+  bsg_counter_clear_up #(.max_val_p(2**count_width_p-1)
+     ,.init_val_p(0))
+    tx_pending_counter (
         .clk_i(clk_i)
        ,.reset_i(reset_i)
-       ,.sig_i(~packet_req_i)
-       ,.detect_o(tx_interrupt_set_li)
+       ,.clear_i(tx_interrupt_clear_i)
+       ,.up_i(tx_complete_i & (tx_pending_count_r != '1))
+       ,.count_o(tx_pending_count_r)
     );
 
-  logic tx_interrupt_pending_r_lo;
+  logic rx_fire_lo, tx_fire_lo;
 
-  bsg_dff_reset_set_clear #(.width_p(1))
-    tx_interrupt_pending_reg (
+  interrupt_coalescer #(.count_width_p(count_width_p))
+    rx_coalescer (
         .clk_i(clk_i)
        ,.reset_i(reset_i)
-       ,.set_i(tx_interrupt_set_li)
-       ,.clear_i(tx_interrupt_clear_i)
-       ,.data_o(tx_interrupt_pending_r_lo)
+       ,.frames_i(coalesce_data_i)
+       ,.frames_v_i(rx_coalesce_frames_v_i)
+       ,.timeout_i(coalesce_data_i)
+       ,.timeout_v_i(rx_coalesce_timeout_v_i)
+       ,.frames_o(rx_coalesce_frames_o)
+       ,.timeout_o(rx_coalesce_timeout_o)
+       ,.pending_count_i(rx_pending_count_i)
+       ,.max_frames_i(rx_pending_max_i)
+       ,.fire_o(rx_fire_lo)
+    );
+
+  interrupt_coalescer #(.count_width_p(count_width_p))
+    tx_coalescer (
+        .clk_i(clk_i)
+       ,.reset_i(reset_i)
+       ,.frames_i(coalesce_data_i)
+       ,.frames_v_i(tx_coalesce_frames_v_i)
+       ,.timeout_i(coalesce_data_i)
+       ,.timeout_v_i(tx_coalesce_timeout_v_i)
+       ,.frames_o(tx_coalesce_frames_o)
+       ,.timeout_o(tx_coalesce_timeout_o)
+       ,.pending_count_i(tx_pending_count_r)
+       ,.max_frames_i('1)
+       ,.fire_o(tx_fire_lo)
     );
 
   // We don't really have an RX interrupt pending reg. The clear pending op
@@ -69,10 +107,13 @@ module interrupt_control_unit (
   // remove one received packet in the RX buffer. If after that the buffer happens
   // to become empty, the RX pending bit will goes to 0, otherwise it keeps being
   // 1.
-  assign rx_interrupt_pending_o = packet_avail_i;
-  assign tx_interrupt_pending_o = tx_interrupt_pending_r_lo;
+  assign rx_interrupt_pending_o = (rx_pending_count_i != '0);
+  assign tx_interrupt_pending_o = (tx_pending_count_r != '0);
+  assign tx_pending_count_o = tx_pending_count_r;
 
-  assign rx_interrupt_o = rx_interrupt_pending_o & rx_interrupt_enable_r;
-  assign tx_interrupt_o = tx_interrupt_pending_o & tx_interrupt_enable_r;
+  // With coalescing, an interrupt is raised only once enough events are
+  // pending or the oldest one has waited long enough
+  assign rx_interrupt_o = rx_fire_lo & rx_interrupt_enable_r;
+  assign tx_interrupt_o = tx_fire_lo & tx_interrupt_enable_r;
 
 endmodule
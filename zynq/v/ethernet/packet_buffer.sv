@@ -9,6 +9,8 @@
  *   When packet_req_o == 1'b1, the write slot is valid and the size and content of the
  * incoming packet can be written through the corresponding write signals. After finishing writing it,
  * set packet_send_i to 1'b1 to reserve the slot.
+ *   The read/write slot pointers and the number of occupied slots are exported so that
+ * software can observe the ring.
  *
  *
  * When slot_p == 2, and a packet has been written in slot 0:
@@ -46,6 +48,8 @@ module packet_buffer #(
     , parameter `BSG_INV_PARAM(els_p)
     , localparam addr_width_lp = $clog2(els_p)
     , localparam packet_size_width_lp = $clog2(els_p+1)
+    , localparam slot_ptr_width_lp = `BSG_SAFE_CLOG2(slot_p)
+    , localparam slot_count_width_lp = `BSG_WIDTH(slot_p)
 )
 (
       input  logic clk_i
@@ -78,6 +82,12 @@ module packet_buffer #(
     , input  logic [addr_width_lp-1:0]    packet_waddr_i
     , input  logic [data_width_p-1:0]     packet_wdata_i
     , input  logic [(data_width_p/8)-1:0] packet_wmask_i
+
+    //============================ Ring ============================
+      // read (oldest) slot, write (next free) slot, occupied slots
+    , output logic [slot_ptr_width_lp-1:0]   slot_head_o
+    , output logic [slot_ptr_width_lp-1:0]   slot_tail_o
+    , output logic [slot_count_width_lp-1:0] slot_count_o
 );
 
   logic misaligned_access;
@@ -129,8 +139,8 @@ module packet_buffer #(
   wire enq_li = packet_send_i & packet_req_o;
   wire deq_li = packet_avail_o & packet_ack_i;
 
-  logic [`BSG_SAFE_CLOG2(slot_p)-1:0] wptr_r_lo;
-  logic [`BSG_SAFE_CLOG2(slot_p)-1:0] rptr_r_lo;
+  logic [slot_ptr_width_lp-1:0] wptr_r_lo;
+  logic [slot_ptr_width_lp-1:0] rptr_r_lo;
   logic [slot_p-1:0] rptr_one_hot_lo;
   logic [slot_p-1:0] wptr_one_hot_lo;
 
@@ -150,6 +160,21 @@ module packet_buffer #(
      ,.empty_o(empty_o)
     );
 
+  bsg_counter_up_down #(
+      .max_val_p(slot_p)
+     ,.init_val_p(0)
+     ,.max_step_p(1)
+    ) slot_counter (
+      .clk_i(clk_i)
+     ,.reset_i(reset_i)
+     ,.up_i(enq_li)
+     ,.down_i(deq_li)
+     ,.count_o(slot_count_o)
+    );
+
+  assign slot_head_o = rptr_r_lo;
+  assign slot_tail_o = wptr_r_lo;
+
   bsg_decode #(.num_out_p(slot_p))
    rptr_one_hot (
       .i(rptr_r_lo)
@@ -2,6 +2,12 @@
 module ethernet_top
  #(parameter C_S00_AXI_DATA_WIDTH = 32
    , parameter C_S00_AXI_ADDR_WIDTH = 32
+
+   // The DMA master shares the data width of the register interface
+   , parameter C_M00_AXI_ADDR_WIDTH = 32
+
+   , parameter ETH_MTU = 2048
+   , parameter DMA_OUTSTANDING = 8
    )
   (input wire                                    aclk
    , input wire                                  aresetn
@@ -42,6 +48,30 @@ module ethernet_top
    , output wire                                 s_axil_rvalid
    , input wire                                  s_axil_rready
 
+   , output wire [C_M00_AXI_ADDR_WIDTH-1:0]      m_axil_awaddr
+   , output wire [2:0]                           m_axil_awprot
+   , output wire                                 m_axil_awvalid
+   , input wire                                  m_axil_awready
+
+   , output wire [C_S00_AXI_DATA_WIDTH-1:0]      m_axil_wdata
+   , output wire [(C_S00_AXI_DATA_WIDTH>>3)-1:0] m_axil_wstrb
+   , output wire                                 m_axil_wvalid
+   , input wire                                  m_axil_wready
+
+   , input wire [1:0]                            m_axil_bresp
+   , input wire                                  m_axil_bvalid
+   , output wire                                 m_axil_bready
+
+   , output wire [C_M00_AXI_ADDR_WIDTH-1:0]      m_axil_araddr
+   , output wire [2:0]                           m_axil_arprot
+   , output wire                                 m_axil_arvalid
+   , input wire                                  m_axil_arready
+
+   , input wire [C_S00_AXI_DATA_WIDTH-1:0]       m_axil_rdata
+   , input wire [1:0]                            m_axil_rresp
+   , input wire                                  m_axil_rvalid
+   , output wire                                 m_axil_rready
+
    , input wire                                  rgmii_rx_clk
    , input wire  [3:0]                           rgmii_rxd
    , input wire                                  rgmii_rx_ctl
@@ -55,6 +85,9 @@ module ethernet_top
   bsg_axil_ethernet
    #(.axil_data_width_p(C_S00_AXI_DATA_WIDTH)
      ,.axil_addr_width_p(C_S00_AXI_ADDR_WIDTH)
+     ,.m_axil_addr_width_p(C_M00_AXI_ADDR_WIDTH)
+     ,.eth_mtu_p(ETH_MTU)
+     ,.dma_outstanding_p(DMA_OUTSTANDING)
      )
    ethernet
     (.clk_i(aclk)
@@ -64,37 +97,61 @@ module ethernet_top
      ,.clk250_reset_i(clk250_reset)
      ,.tx_clk_gen_reset_i(tx_clk_gen_reset)
 
-     ,.tx_clk_i(tx_clk)
+     ,.tx_clk_o(tx_clk)
      ,.tx_reset_i(tx_reset)
 
-     ,.rx_clk(rx_clk)
-     ,.rx_reset(rx_reset)
+     ,.rx_clk_o(rx_clk)
+     ,.rx_reset_i(rx_reset)
 
      ,.iodelay_ref_clk_i(iodelay_ref_clk)
 
-     ,.s_axil_awaddr_i(s_axil_awaddr)
-     ,.s_axil_awprot_i(s_axil_awprot)
-     ,.s_axil_awvalid_i(s_axil_awvalid)
-     ,.s_axil_awready_o(s_axil_awready)
-
-     ,.s_axil_wdata_i(s_axil_wdata)
-     ,.s_axil_wstrb_i(s_axil_wstrb)
-     ,.s_axil_wvalid_i(s_axil_wvalid)
-     ,.s_axil_wready_o(s_axil_wready)
-
-     ,.s_axil_bresp_o(s_axil_bresp)
-     ,.s_axil_bvalid_o(s_axil_bvalid)
-     ,.s_axil_bready_i(s_axil_bready)
-
-     ,.s_axil_araddr_i(s_axil_araddr)
-     ,.s_axil_arprot_i(s_axil_arprot)
-     ,.s_axil_arvalid_i(s_axil_arvalid)
-     ,.s_axil_arready_o(s_axil_arready)
-
-     ,.s_axil_rdata_o(s_axil_rdata)
-     ,.s_axil_rresp_o(s_axil_rresp)
-     ,.s_axil_rvalid_o(s_axil_rvalid)
-     ,.s_axil_rready_i(s_axil_rready)
+     ,.s00_axi_awaddr(s_axil_awaddr)
+     ,.s00_axi_awprot(s_axil_awprot)
+     ,.s00_axi_awvalid(s_axil_awvalid)
+     ,.s00_axi_awready(s_axil_awready)
+
+     ,.s00_axi_wdata(s_axil_wdata)
+     ,.s00_axi_wstrb(s_axil_wstrb)
+     ,.s00_axi_wvalid(s_axil_wvalid)
+     ,.s00_axi_wready(s_axil_wready)
+
+     ,.s00_axi_bresp(s_axil_bresp)
+     ,.s00_axi_bvalid(s_axil_bvalid)
+     ,.s00_axi_bready(s_axil_bready)
+
+     ,.s00_axi_araddr(s_axil_araddr)
+     ,.s00_axi_arprot(s_axil_arprot)
+     ,.s00_axi_arvalid(s_axil_arvalid)
+     ,.s00_axi_arready(s_axil_arready)
+
+     ,.s00_axi_rdata(s_axil_rdata)
+     ,.s00_axi_rresp(s_axil_rresp)
+     ,.s00_axi_rvalid(s_axil_rvalid)
+     ,.s00_axi_rready(s_axil_rready)
+
+     ,.m00_axi_awaddr(m_axil_awaddr)
+     ,.m00_axi_awprot(m_axil_awprot)
+     ,.m00_axi_awvalid(m_axil_awvalid)
+     ,.m00_axi_awready(m_axil_awready)
+
+     ,.m00_axi_wdata(m_axil_wdata)
+     ,.m00_axi_wstrb(m_axil_wstrb)
+     ,.m00_axi_wvalid(m_axil_wvalid)
+     ,.m00_axi_wready(m_axil_wready)
+
+     ,.m00_axi_bresp(m_axil_bresp)
+     ,.m00_axi_bvalid(m_axil_bvalid)
+     ,.m00_axi_bready(m_axil_bready)
+
+     ,.m00_axi_araddr(m_axil_araddr)
+     ,.m00_axi_arprot(m_axil_arprot)
+     ,.m00_axi_arvalid(m_axil_arvalid)
+     ,.m00_axi_arready(m_axil_arready)
+
+     ,.m00_axi_rdata(m_axil_rdata)
+     ,.m00_axi_rresp(m_axil_rresp)
+     ,.m00_axi_rvalid(m_axil_rvalid)
+     ,.m00_axi_rready(m_axil_rready)
 
      ,.rgmii_rx_clk_i(rgmii_rx_clk)
      ,.rgmii_rxd_i(rgmii_rxd)
@@ -1,6 +1,12 @@
 
 module fifo_top
- #(parameter C_S00_AXI_DATA_WIDTH = 32)
+ #(parameter C_S00_AXI_DATA_WIDTH = 32
+   , parameter ELS = 128
+   , parameter PACKET_MODE = 1
+   , parameter ALMOST_FULL_ELS = ELS - (ELS >> 2)
+   , parameter C_S01_AXI_DATA_WIDTH = 32
+   , parameter C_S01_AXI_ADDR_WIDTH = 32
+   )
   (input wire                                    aclk
    , input wire                                  aresetn
 
@@ -8,6 +14,7 @@ module fifo_top
    , input wire [C_S00_AXI_DATA_WIDTH-1:0]       s_axis_tdata
    , input wire [(C_S00_AXI_DATA_WIDTH/8)-1:0]   s_axis_tkeep
    , input wire                                  s_axis_tlast
+   , input wire                                  s_axis_tuser
    , output wire                                 s_axis_tready
 
    , output wire                                 m_axis_tvalid
@@ -15,10 +22,48 @@ module fifo_top
    , output wire  [(C_S00_AXI_DATA_WIDTH/8)-1:0] m_axis_tkeep
    , output wire                                 m_axis_tlast
    , input wire                                  m_axis_tready
+
+   , output wire                                 almost_full
+
+   //====================== AXI-4 LITE =========================
+   // WRITE ADDRESS CHANNEL SIGNALS
+   , input wire [C_S01_AXI_ADDR_WIDTH-1:0]       s_axil_awaddr
+   , input wire [2:0]                            s_axil_awprot
+   , input wire                                  s_axil_awvalid
+   , output wire                                 s_axil_awready
+
+   // WRITE DATA CHANNEL SIGNALS
+   , input wire [C_S01_AXI_DATA_WIDTH-1:0]       s_axil_wdata
+   , input wire [(C_S01_AXI_DATA_WIDTH>>3)-1:0]  s_axil_wstrb
+   , input wire                                  s_axil_wvalid
+   , output wire                                 s_axil_wready
+
+   // WRITE RESPONSE CHANNEL SIGNALS
+   , output wire [1:0]                           s_axil_bresp
+   , output wire                                 s_axil_bvalid
+   , input wire                                  s_axil_bready
+
+   // READ ADDRESS CHANNEL SIGNALS
+   , input wire [C_S01_AXI_ADDR_WIDTH-1:0]       s_axil_araddr
+   , input wire [2:0]                            s_axil_arprot
+   , input wire                                  s_axil_arvalid
+   , output wire                                 s_axil_arready
+
+   // READ DATA CHANNEL SIGNALS
+   , output wire [C_S01_AXI_DATA_WIDTH-1:0]      s_axil_rdata
+   , output wire [1:0]                           s_axil_rresp
+   , output wire                                 s_axil_rvalid
+   , input wire                                  s_axil_rready
    );
 
   bsg_axis_fifo
-   #(.C_S00_AXI_DATA_WIDTH(C_S00_AXI_DATA_WIDTH))
+   #(.C_S00_AXI_DATA_WIDTH(C_S00_AXI_DATA_WIDTH)
+     ,.els_p(ELS)
+     ,.packet_mode_p(PACKET_MODE)
+     ,.almost_full_els_p(ALMOST_FULL_ELS)
+     ,.s_axil_data_width_p(C_S01_AXI_DATA_WIDTH)
+     ,.s_axil_addr_width_p(C_S01_AXI_ADDR_WIDTH)
+     )
    fifo
     (.clk_i(aclk)
      ,.reset_i(!aresetn)
@@ -27,6 +72,7 @@ module fifo_top
      ,.s_axis_tdata_i(s_axis_tdata)
      ,.s_axis_tkeep_i(s_axis_tkeep)
      ,.s_axis_tlast_i(s_axis_tlast)
+     ,.s_axis_tuser_i(s_axis_tuser)
      ,.s_axis_tready_o(s_axis_tready)
 
      ,.m_axis_tvalid_o(m_axis_tvalid)
@@ -34,6 +80,32 @@ module fifo_top
      ,.m_axis_tkeep_o(m_axis_tkeep)
      ,.m_axis_tlast_o(m_axis_tlast)
      ,.m_axis_tready_i(m_axis_tready)
+
+     ,.almost_full_o(almost_full)
+
+     ,.s_axil_awaddr_i(s_axil_awaddr)
+     ,.s_axil_awprot_i(s_axil_awprot)
+     ,.s_axil_awvalid_i(s_axil_awvalid)
+     ,.s_axil_awready_o(s_axil_awready)
+
+     ,.s_axil_wdata_i(s_axil_wdata)
+     ,.s_axil_wstrb_i(s_axil_wstrb)
+     ,.s_axil_wvalid_i(s_axil_wvalid)
+     ,.s_axil_wready_o(s_axil_wready)
+
+     ,.s_axil_bresp_o(s_axil_bresp)
+     ,.s_axil_bvalid_o(s_axil_bvalid)
+     ,.s_axil_bready_i(s_axil_bready)
+
+     ,.s_axil_araddr_i(s_axil_araddr)
+     ,.s_axil_arprot_i(s_axil_arprot)
+     ,.s_axil_arvalid_i(s_axil_arvalid)
+     ,.s_axil_arready_o(s_axil_arready)
+
+     ,.s_axil_rdata_o(s_axil_rdata)
+     ,.s_axil_rresp_o(s_axil_rresp)
+     ,.s_axil_rvalid_o(s_axil_rvalid)
+     ,.s_axil_rready_i(s_axil_rready)
      );
 
 endmodule
@@ -0,0 +1,89 @@
+
+module perfmon_top
+ #(parameter C_S00_AXI_DATA_WIDTH = 32
+   , parameter C_S00_AXI_ADDR_WIDTH = 32
+   , parameter PORTS = 4
+   , parameter COUNTER_WIDTH = 32
+   )
+  (input wire                                    aclk
+   , input wire                                  aresetn
+
+   // Monitored channels, one bit per port
+   , input wire [PORTS-1:0]                      req_valid
+   , input wire [PORTS-1:0]                      req_ready
+   , input wire [PORTS-1:0]                      resp_valid
+   , input wire [PORTS-1:0]                      resp_ready
+
+   //====================== AXI-4 LITE =========================
+   // WRITE ADDRESS CHANNEL SIGNALS
+   , input wire [C_S00_AXI_ADDR_WIDTH-1:0]       s_axil_awaddr
+   , input wire [2:0]                            s_axil_awprot
+   , input wire                                  s_axil_awvalid
+   , output wire                                 s_axil_awready
+
+   // WRITE DATA CHANNEL SIGNALS
+   , input wire [C_S00_AXI_DATA_WIDTH-1:0]       s_axil_wdata
+   , input wire [(C_S00_AXI_DATA_WIDTH>>3)-1:0]  s_axil_wstrb
+   , input wire                                  s_axil_wvalid
+   , output wire                                 s_axil_wready
+
+   // WRITE RESPONSE CHANNEL SIGNALS
+   , output wire [1:0]                           s_axil_bresp
+   , output wire                                 s_axil_bvalid
+   , input wire                                  s_axil_bready
+
+   // READ ADDRESS CHANNEL SIGNALS
+   , input wire [C_S00_AXI_ADDR_WIDTH-1:0]       s_axil_araddr
+   , input wire [2:0]                            s_axil_arprot
+   , input wire                                  s_axil_arvalid
+   , output wire                                 s_axil_arready
+
+   // READ DATA CHANNEL SIGNALS
+   , output wire [C_S00_AXI_DATA_WIDTH-1:0]      s_axil_rdata
+   , output wire [1:0]                           s_axil_rresp
+   , output wire                                 s_axil_rvalid
+   , input wire                                  s_axil_rready
+   );
+
+  bsg_axil_perfmon
+   #(.s_axil_data_width_p(C_S00_AXI_DATA_WIDTH)
+     ,.s_axil_addr_width_p(C_S00_AXI_ADDR_WIDTH)
+     ,.ports_p(PORTS)
+     ,.counter_width_p(COUNTER_WIDTH)
+     )
+   perfmon
+    (.clk_i(aclk)
+     ,.reset_i(~aresetn)
+
+     ,.req_v_i(req_valid)
+     ,.req_ready_and_i(req_ready)
+     ,.resp_v_i(resp_valid)
+     ,.resp_ready_and_i(resp_ready)
+
+     ,.s_axil_awaddr_i(s_axil_awaddr)
+     ,.s_axil_awprot_i(s_axil_awprot)
+     ,.s_axil_awvalid_i(s_axil_awvalid)
+     ,.s_axil_awready_o(s_axil_awready)
+
+     ,.s_axil_wdata_i(s_axil_wdata)
+     ,.s_axil_wstrb_i(s_axil_wstrb)
+     ,.s_axil_wvalid_i(s_axil_wvalid)
+     ,.s_axil_wready_o(s_axil_wready)
+
+     ,.s_axil_bresp_o(s_axil_bresp)
+     ,.s_axil_bvalid_o(s_axil_bvalid)
+     ,.s_axil_bready_i(s_axil_bready)
+
+     ,.s_axil_araddr_i(s_axil_araddr)
+     ,.s_axil_arprot_i(s_axil_arprot)
+     ,.s_axil_arvalid_i(s_axil_arvalid)
+     ,.s_axil_arready_o(s_axil_arready)
+
+     ,.s_axil_rdata_o(s_axil_rdata)
+     ,.s_axil_rresp_o(s_axil_rresp)
+     ,.s_axil_rvalid_o(s_axil_rvalid)
+     ,.s_axil_rready_i(s_axil_rready)
+     );
+
+endmodule
+
@@ -6,6 +6,8 @@ module plic_top
    , parameter C_S00_AXI_ADDR_WIDTH = 32
    , parameter BASE_ADDR = 32'h300000
    , parameter NUM_SRC = 2
+   , parameter IRQ_COALESCE = 0
+   , parameter IRQ_COALESCE_WINDOW = 16
    )
   (input wire                                    aclk
    , input wire                                  aresetn
@@ -78,6 +80,8 @@ module plic_top
      ,.s_axil_addr_width_p(C_S00_AXI_ADDR_WIDTH)
      ,.base_addr_p(BASE_ADDR)
      ,.num_src_p(NUM_SRC)
+     ,.irq_coalesce_p(IRQ_COALESCE)
+     ,.irq_coalesce_window_p(IRQ_COALESCE_WINDOW)
      )
    plic
     (.clk_i(aclk)